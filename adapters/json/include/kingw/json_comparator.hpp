@@ -0,0 +1,129 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+namespace serde_json {
+
+// Serializes a value, comparing each call with the json that
+// JsonSerializer would have built for it, instead of building it again.
+//
+// JsonSerializer writes objects with their keys sorted, not in the order
+// they were serialized, so fields are looked up in the expected json
+// rather than matched in order against its text. Keep the parsed json
+// of a cached message around to compare against it repeatedly.
+//
+// At the first value that differs, the comparison stops: every later
+// call returns without serializing anything nested inside it.
+class JsonComparator :
+    public ser::Serializer
+{
+public:
+    // Borrows `expected`, which must outlive the comparator.
+    explicit JsonComparator(const nlohmann::json & expected);
+    bool is_human_readable() const override;
+
+    // Whether everything serialized so far matched.
+    // Only meaningful once a whole value has been serialized.
+    bool equal() const;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
+    // Unit
+    void serialize_unit() override;
+
+protected:
+    // Lists/Sequences
+    // Use serialize_seq() instead.
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & accessor) override;
+    void seq_end() override;
+
+    // Maps
+    // Use serialize_map() instead.
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & accessor) override;
+    void map_serialize_value(const ser::Serialize & accessor) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    // Use serialize_struct() instead.
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    void expect(bool same);
+    template <class T>
+    void expect_seq(const T* values, std::size_t len, bool (*same)(const nlohmann::json &, T));
+    void expect_child(const nlohmann::json & parent, const std::string & key, const ser::Serialize & accessor);
+    void begin_container();
+    void end_container();
+
+    // A sequence, map, or struct that has not ended yet.
+    struct Frame {
+        const nlohmann::json* json;
+        std::size_t items;
+    };
+
+    const nlohmann::json* current;  // What the next value is compared with
+    std::vector<Frame> frames;
+    std::string key;  // Reused for every key, to keep its capacity
+    bool matches;
+};
+
+// Whether serializing `input` with a JsonSerializer would build `expected`.
+template <class T>
+bool equals(const T & input, const nlohmann::json & expected) {
+    JsonComparator comparator(expected);
+    ser::serialize(comparator, input);
+    return comparator.equal();
+}
+
+// Whether serializing `input` with a JsonSerializer would dump as `contents`,
+// up to whitespace and key order. Parses `contents` first, without throwing.
+template <class T>
+bool equals(const T & input, const std::string & contents) {
+    nlohmann::json json = nlohmann::json::parse(contents, nullptr, false);
+    return !json.is_discarded() && equals(input, json);
+}
+
+}  // namespace serde_json
+}  // namespace kingw
@@ -1,11 +1,15 @@
 #pragma once
 
-#include <stack>
 #include <stdexcept>
 
 #include <nlohmann/json.hpp>
 
+#include "kingw/de/chunked_input.hpp"
 #include "kingw/de/deserializer.hpp"
+#include "kingw/de/deserialize_in_place.hpp"
+#include "kingw/de/for_each_element.hpp"
+#include "kingw/de/try_deserialize.hpp"
+#include "kingw/de/validate.hpp"
 
 
 namespace kingw {
@@ -17,11 +21,23 @@ class JsonDeserializer :
 public:
     class JsonDeserializationException : public de::DeserializationException {
     public:
-        explicit JsonDeserializationException(serde::string_view message);
+        explicit JsonDeserializationException(serde::string_view message,
+            de::ErrorCode code = de::ErrorCode::Custom);
     };
 
+    // Borrows `contents`, which must outlive the deserializer.
+    // Strings are then passed to visit_borrowed_string().
     explicit JsonDeserializer(const nlohmann::json & contents);
+    explicit JsonDeserializer(nlohmann::json && contents);
+    // Parse errors are thrown by nlohmann::json, or reported
+    // through fail() as ErrorCode::Syntax without exceptions.
     explicit JsonDeserializer(const std::string & contents);
+    // Parses as the chunks arrive. See de::ChunkedInput. Errors are
+    // handled like above. The parser looks for text after the json,
+    // so it only finishes after ChunkedInput::finish().
+    explicit JsonDeserializer(de::ChunkedInput & input);
+    JsonDeserializer(const JsonDeserializer &) = delete;
+    JsonDeserializer & operator=(const JsonDeserializer &) = delete;
     bool is_human_readable() const override;
 
     // Basic Types
@@ -45,52 +61,90 @@ public:
         serde::string_view name,
         const FieldNames & field_names,
         de::Visitor & visitor) override;
+    void deserialize_bytes(de::Visitor & visitor) override;
+    void deserialize_ignored_any(de::Visitor & visitor) override;
 
     class JsonSeqAccess : public de::Deserializer::SeqAccess
     {
     public:
-        explicit JsonSeqAccess(nlohmann::json seq);
+        JsonSeqAccess(const nlohmann::json & seq, de::Deserializer & parent, bool borrowed = true);
         bool has_next() override;
+        std::size_t size_hint() const override;
         void next_element(de::Deserialize & element) override;
+        std::size_t next_bool_elements(bool* output, std::size_t len) override;
+        std::size_t next_i8_elements(std::int8_t* output, std::size_t len) override;
+        std::size_t next_i16_elements(std::int16_t* output, std::size_t len) override;
+        std::size_t next_i32_elements(std::int32_t* output, std::size_t len) override;
+        std::size_t next_i64_elements(std::int64_t* output, std::size_t len) override;
+        std::size_t next_u8_elements(std::uint8_t* output, std::size_t len) override;
+        std::size_t next_u16_elements(std::uint16_t* output, std::size_t len) override;
+        std::size_t next_u32_elements(std::uint32_t* output, std::size_t len) override;
+        std::size_t next_u64_elements(std::uint64_t* output, std::size_t len) override;
+        std::size_t next_f32_elements(float* output, std::size_t len) override;
+        std::size_t next_f64_elements(double* output, std::size_t len) override;
     private:
-        nlohmann::json seq;
-        decltype(seq.begin()) iter;
+        template <class T>
+        std::size_t next_basic_elements(T* output, std::size_t len,
+            bool (*accept)(const nlohmann::json &));
+
+        const nlohmann::json & seq;
+        de::Deserializer & parent;
+        nlohmann::json::const_iterator iter;
+        bool borrowed;
     };
 
     class JsonMapAccess : public de::Deserializer::MapAccess
     {
     public:
-        explicit JsonMapAccess(nlohmann::json map);
+        JsonMapAccess(const nlohmann::json & map, de::Deserializer & parent, bool borrowed = true);
         bool has_next() override;
+        std::size_t size_hint() const override;
         void next_key(de::Deserialize & key) override;
         void next_value(de::Deserialize & value) override;
         void next_entry(de::Deserialize & key, de::Deserialize & value) override;
     private:
-        nlohmann::json map;
-        decltype(nlohmann::json().items()) items;
-        decltype(nlohmann::json().items().begin()) iter;
+        const nlohmann::json & map;
+        de::Deserializer & parent;
+        nlohmann::json::const_iterator iter;
+        std::size_t remaining;  // Object iterators can't be subtracted
+        bool borrowed;
+        nlohmann::json key_json;  // Reused for every key, to keep its capacity
     };
 
     class JsonStructAccess : public de::Deserializer::MapAccess
     {
     public:
-        explicit JsonStructAccess(nlohmann::json map, const FieldNames & fields);
+        JsonStructAccess(const nlohmann::json & map, const FieldNames & fields,
+            de::Deserializer & parent, bool borrowed = true);
         bool has_next() override;
+        std::size_t size_hint() const override;
         void next_key(de::Deserialize & key) override;
         void next_value(de::Deserialize & value) override;
         void next_entry(de::Deserialize & key, de::Deserialize & value) override;
     private:
-        nlohmann::json map;
+        const nlohmann::json & map;
         const FieldNames & field_names;
+        de::Deserializer & parent;
         decltype(field_names.begin()) iter;
+        bool borrowed;
+        nlohmann::json key_json;  // Reused for every key, to keep its capacity
     };
 
+protected:
+    void raise(const de::Error & error) override;
+
 private:
-    std::stack<nlohmann::json> json_stack;
+    JsonDeserializer(const nlohmann::json & contents, bool borrowed);
+
+    template <class T>
+    void visit_integer(de::Visitor & visitor, void (de::Visitor::*visit)(T));
+    nlohmann::json document;  // Only used when the deserializer owns its contents
+    const nlohmann::json & json;
+    bool borrowed;  // Whether `json` outlives this deserializer and its parents
 };
 
 template <class T>
-void from_string(const T & output, const std::string & contents) {
+void from_string(T & output, const std::string & contents) {
     JsonDeserializer deserializer(contents);
     de::deserialize(deserializer, output);
 }
@@ -103,5 +157,28 @@ T from_string(const std::string & contents) {
     return output;
 }
 
+// Parses and deserializes without throwing. See de::try_deserialize().
+template <class T>
+de::Error try_from_string(T & output, const std::string & contents) {
+    nlohmann::json json = nlohmann::json::parse(contents, nullptr, false);
+    if (json.is_discarded()) {
+        return de::Error{ de::ErrorCode::Syntax, "json could not be parsed" };
+    }
+    JsonDeserializer deserializer(std::move(json));
+    return de::try_deserialize(deserializer, output);
+}
+
+// Parses and checks that the json is a valid T, without constructing one.
+// See de::validate().
+template <class T>
+de::Error validate(const std::string & contents) {
+    nlohmann::json json = nlohmann::json::parse(contents, nullptr, false);
+    if (json.is_discarded()) {
+        return de::Error{ de::ErrorCode::Syntax, "json could not be parsed" };
+    }
+    JsonDeserializer deserializer(std::move(json));
+    return de::validate<T>(deserializer);
+}
+
 }  // namespace serde_json
 }  // namespace kingw
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "kingw/json_serializer.hpp"
+#include "kingw/ser/size_serializer.hpp"
+
+
+namespace kingw {
+namespace serde_json {
+
+// Counts the length of the text JsonSerializer::dump() writes for a value,
+// without building any json. Integers are measured from their bits, and
+// strings by counting the characters that need escaping.
+//
+// Floating point numbers are formatted into a stack buffer by the same
+// function nlohmann::json uses, since their shortest round-trip form
+// can't be measured without finding it.
+//
+// Exact, unless a map or struct serializes the same key twice. Then it is
+// an upper bound, since JsonSerializer only keeps the last value.
+class JsonSizeSerializer :
+    public ser::SizeSerializer
+{
+public:
+    JsonSizeSerializer();
+    bool is_human_readable() const override;
+
+    // Length of the text, including the "null" written
+    // if nothing was serialized at all.
+    std::size_t dump_size() const;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
+    // Unit
+    void serialize_unit() override;
+
+protected:
+    // Lists/Sequences
+    // Use serialize_seq() instead.
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & accessor) override;
+    void seq_end() override;
+
+    // Maps
+    // Use serialize_map() instead.
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & accessor) override;
+    void map_serialize_value(const ser::Serialize & accessor) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    // Use serialize_struct() instead.
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    template <class T, class U>
+    void add_seq(const T* values, std::size_t len, void (JsonSizeSerializer::*add_element)(U));
+    void add_bool(bool value);
+    void add_i64(std::int64_t value);
+    void add_u64(std::uint64_t value);
+    void add_f64(double value);
+    void add_item();
+    void add_value(const ser::Serialize & accessor);
+
+    std::vector<std::size_t> items;  // Of each unfinished sequence, map, or struct
+};
+
+// Length of to_string(input).
+template <class T>
+std::size_t string_size(const T & input) {
+    JsonSizeSerializer serializer;
+    ser::serialize(serializer, input);
+    return serializer.dump_size();
+}
+
+// Like to_string(input), but into `output`, which reuses its capacity
+// and grows at most once, to exactly the right length.
+template <class T>
+void to_string(const T & input, std::string & output) {
+    JsonSerializer serializer;
+    ser::serialize(serializer, input);
+    output.clear();
+    output.reserve(string_size(input));
+    serializer.dump(output);
+}
+
+}  // namespace serde_json
+}  // namespace kingw
@@ -1,4 +1,6 @@
 #pragma once
 
+#include "kingw/json_comparator.hpp"
 #include "kingw/json_serializer.hpp"
+#include "kingw/json_size_serializer.hpp"
 #include "kingw/json_deserializer.hpp"
@@ -0,0 +1,340 @@
+#include "kingw/json_comparator.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "kingw/ostream_serializer.hpp"
+#include "kingw/serde/base64.hpp"
+
+
+namespace kingw {
+namespace serde_json {
+
+namespace {
+
+// Numbers parsed from text are unsigned if they aren't negative,
+// so signed and unsigned integers are compared by value.
+bool same_integer(const nlohmann::json & json, std::int64_t value) {
+    if (json.type() == nlohmann::json::value_t::number_integer) {
+        return json.get<std::int64_t>() == value;
+    } else if (json.type() == nlohmann::json::value_t::number_unsigned) {
+        return value >= 0 && json.get<std::uint64_t>() == static_cast<std::uint64_t>(value);
+    }
+    return false;
+}
+
+bool same_unsigned(const nlohmann::json & json, std::uint64_t value) {
+    if (json.type() == nlohmann::json::value_t::number_unsigned) {
+        return json.get<std::uint64_t>() == value;
+    } else if (json.type() == nlohmann::json::value_t::number_integer) {
+        const std::int64_t stored = json.get<std::int64_t>();
+        return stored >= 0 && static_cast<std::uint64_t>(stored) == value;
+    }
+    return false;
+}
+
+// Dumped as null if not finite, so either may be expected.
+bool same_float(const nlohmann::json & json, double value) {
+    if (!std::isfinite(value)) {
+        return json.is_null() || (json.is_number_float() && !std::isfinite(json.get<double>()));
+    }
+    return json.is_number_float() && json.get<double>() == value;
+}
+
+bool same_bool(const nlohmann::json & json, bool value) {
+    return json.is_boolean() && json.get<bool>() == value;
+}
+
+template <class T>
+bool same_signed_element(const nlohmann::json & json, T value) {
+    return same_integer(json, value);
+}
+
+template <class T>
+bool same_unsigned_element(const nlohmann::json & json, T value) {
+    return same_unsigned(json, value);
+}
+
+template <class T>
+bool same_float_element(const nlohmann::json & json, T value) {
+    return same_float(json, value);
+}
+
+bool same_string(const nlohmann::json & json, serde::string_view value) {
+    if (!json.is_string()) {
+        return false;
+    }
+    const std::string & string = json.get_ref<const std::string &>();
+    return string.size() == value.size() && std::memcmp(string.data(), value.data(), value.size()) == 0;
+}
+
+// Bytes are written as base64. Encode a chunk at a time
+// and compare it, instead of decoding the expected string.
+bool same_bytes(const nlohmann::json & json, const std::uint8_t* data, std::size_t len) {
+    if (!json.is_string()) {
+        return false;
+    }
+    const std::string & string = json.get_ref<const std::string &>();
+    if (string.size() != serde::base64_encoded_size(len)) {
+        return false;
+    }
+    constexpr std::size_t CHUNK = 48 * 16;  // Whole groups of 3 bytes
+    char encoded[CHUNK / 3 * 4];
+    for (std::size_t i = 0; i < len; i += CHUNK) {
+        const std::size_t count = len - i < CHUNK ? len - i : CHUNK;
+        const std::size_t size = serde::base64_encode(data + i, count, encoded) - encoded;
+        if (std::memcmp(string.data() + i / 3 * 4, encoded, size) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+JsonComparator::JsonComparator(const nlohmann::json & expected)
+    : current(&expected), matches(true) { }
+
+bool JsonComparator::is_human_readable() const {
+    return true;
+}
+
+bool JsonComparator::equal() const {
+    return matches && frames.empty();
+}
+
+void JsonComparator::expect(bool same) {
+    if (!same) {
+        matches = false;
+    }
+}
+
+void JsonComparator::serialize_bool(bool value) {
+    expect(matches && same_bool(*current, value));
+}
+void JsonComparator::serialize_i8(std::int8_t value) {
+    expect(matches && same_integer(*current, value));
+}
+void JsonComparator::serialize_i16(std::int16_t value) {
+    expect(matches && same_integer(*current, value));
+}
+void JsonComparator::serialize_i32(std::int32_t value) {
+    expect(matches && same_integer(*current, value));
+}
+void JsonComparator::serialize_i64(std::int64_t value) {
+    expect(matches && same_integer(*current, value));
+}
+void JsonComparator::serialize_u8(std::uint8_t value) {
+    expect(matches && same_unsigned(*current, value));
+}
+void JsonComparator::serialize_u16(std::uint16_t value) {
+    expect(matches && same_unsigned(*current, value));
+}
+void JsonComparator::serialize_u32(std::uint32_t value) {
+    expect(matches && same_unsigned(*current, value));
+}
+void JsonComparator::serialize_u64(std::uint64_t value) {
+    expect(matches && same_unsigned(*current, value));
+}
+void JsonComparator::serialize_f32(float value) {
+    expect(matches && same_float(*current, value));
+}
+void JsonComparator::serialize_f64(double value) {
+    expect(matches && same_float(*current, value));
+}
+void JsonComparator::serialize_char(char value) {
+    // nlohmann::json stores a char as a number.
+    expect(matches && same_integer(*current, value));
+}
+void JsonComparator::serialize_string(serde::string_view value) {
+    expect(matches && same_string(*current, value));
+}
+
+template <class T>
+void JsonComparator::expect_seq(const T* values, std::size_t len, bool (*same)(const nlohmann::json &, T)) {
+    if (!matches) {
+        return;
+    }
+    // Like JsonSerializer, an empty sequence leaves the value null.
+    if (len == 0) {
+        expect(current->is_null());
+        return;
+    }
+    if (!current->is_array() || current->size() != len) {
+        matches = false;
+        return;
+    }
+    const auto & array = current->get_ref<const nlohmann::json::array_t &>();
+    for (std::size_t i = 0; i < len; ++i) {
+        if (!same(array[i], values[i])) {
+            matches = false;
+            return;
+        }
+    }
+}
+
+void JsonComparator::serialize_bool_seq(const bool* values, std::size_t len) {
+    expect_seq(values, len, same_bool);
+}
+void JsonComparator::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    expect_seq(values, len, same_signed_element<std::int8_t>);
+}
+void JsonComparator::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    expect_seq(values, len, same_signed_element<std::int16_t>);
+}
+void JsonComparator::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    expect_seq(values, len, same_signed_element<std::int32_t>);
+}
+void JsonComparator::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    expect_seq(values, len, same_signed_element<std::int64_t>);
+}
+void JsonComparator::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    expect_seq(values, len, same_unsigned_element<std::uint8_t>);
+}
+void JsonComparator::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    expect_seq(values, len, same_unsigned_element<std::uint16_t>);
+}
+void JsonComparator::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    expect_seq(values, len, same_unsigned_element<std::uint32_t>);
+}
+void JsonComparator::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    expect_seq(values, len, same_unsigned_element<std::uint64_t>);
+}
+void JsonComparator::serialize_f32_seq(const float* values, std::size_t len) {
+    expect_seq(values, len, same_float_element<float>);
+}
+void JsonComparator::serialize_f64_seq(const double* values, std::size_t len) {
+    expect_seq(values, len, same_float_element<double>);
+}
+
+void JsonComparator::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    expect(matches && same_bytes(*current, data, len));
+}
+
+void JsonComparator::serialize_unit() {
+    expect(matches && current->is_null());
+}
+
+void JsonComparator::begin_container() {
+    frames.push_back(Frame{ current, 0 });
+}
+
+void JsonComparator::end_container() {
+    if (frames.empty()) {
+        return;
+    }
+    const Frame frame = frames.back();
+    frames.pop_back();
+    if (matches) {
+        // Like JsonSerializer, an empty container leaves the value null.
+        expect(frame.items == 0 ? frame.json->is_null() : frame.items == frame.json->size());
+    }
+}
+
+void JsonComparator::expect_child(const nlohmann::json & parent, const std::string & name, const ser::Serialize & accessor) {
+    if (!parent.is_object()) {
+        matches = false;
+        return;
+    }
+    const auto child = parent.find(name);
+    if (child == parent.end()) {
+        matches = false;
+        return;
+    }
+    ++frames.back().items;
+    const nlohmann::json* previous = current;
+    current = &*child;
+    accessor.serialize(*this);
+    current = previous;
+}
+
+
+///
+/// Sequences
+///
+
+void JsonComparator::seq_begin(std::size_t) {
+    begin_container();
+}
+
+void JsonComparator::seq_serialize_element(const ser::Serialize & accessor) {
+    if (!matches || frames.empty()) {
+        return;
+    }
+    Frame & frame = frames.back();
+    if (!frame.json->is_array() || frame.items >= frame.json->size()) {
+        matches = false;
+        return;
+    }
+    const nlohmann::json* previous = current;
+    current = &(*frame.json)[frame.items++];
+    accessor.serialize(*this);
+    current = previous;
+}
+
+void JsonComparator::seq_end() {
+    end_container();
+}
+
+
+///
+/// Maps
+///
+
+void JsonComparator::map_begin(std::size_t) {
+    begin_container();
+}
+
+void JsonComparator::map_serialize_key(const ser::Serialize & accessor) {
+    if (!matches) {
+        return;
+    }
+    if (!accessor.traits().is_string) {
+        // JsonSerializer can't serialize it at all.
+        matches = false;
+        return;
+    }
+    key = kingw::OStreamSerializer::to_string(accessor);
+}
+
+void JsonComparator::map_serialize_value(const ser::Serialize & accessor) {
+    if (matches && !frames.empty()) {
+        expect_child(*frames.back().json, key, accessor);
+    }
+}
+
+void JsonComparator::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    map_serialize_key(key);
+    map_serialize_value(value);
+}
+
+void JsonComparator::map_end() {
+    end_container();
+}
+
+
+///
+/// Structs
+///
+
+void JsonComparator::struct_begin(serde::string_view, std::size_t) {
+    begin_container();
+}
+
+void JsonComparator::struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) {
+    if (matches && !frames.empty()) {
+        key.assign(name.data(), name.size());
+        expect_child(*frames.back().json, key, accessor);
+    }
+}
+
+void JsonComparator::struct_skip_field(serde::string_view) {
+    // No-op
+}
+
+void JsonComparator::struct_end() {
+    end_container();
+}
+
+}  // namespace serde_json
+}  // namespace kingw
@@ -1,143 +1,293 @@
 #include "kingw/json_deserializer.hpp"
 
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "kingw/serde/base64.hpp"
+
 
 namespace kingw {
 namespace serde_json {
 
-JsonDeserializer::JsonDeserializationException::JsonDeserializationException(serde::string_view message)
-    : de::DeserializationException(message) { }
+namespace {
+
+// Stands in for struct fields that are missing from a json object.
+const nlohmann::json null_json;
+
+// Type checks that match the ones in deserialize_bool(), _i32(), _f64(), etc.
+bool is_boolean(const nlohmann::json & json) {
+    return json.is_boolean();
+}
+bool is_integer(const nlohmann::json & json) {
+    return json.is_number_integer();
+}
+bool is_number(const nlohmann::json & json) {
+    return json.is_number_float() || json.is_number_integer();
+}
+
+// What get<T>() converts to T without throwing. Trusted input is
+// only checked for this, and converts whatever it finds.
+template <class T>
+bool converts(const nlohmann::json & json) {
+    if (std::is_same<T, bool>::value) {
+        return json.is_boolean();
+    }
+    return json.is_number() || json.is_boolean();
+}
+
+// Same range check that the integral visitors apply in visit_i64()/visit_u64().
+// get<T>() would silently truncate instead.
+template <class T>
+bool fits(const nlohmann::json & json) {
+    if (!std::is_integral<T>::value || std::is_same<T, bool>::value) {
+        return true;
+    } else if (json.is_number_unsigned()) {
+        return json.get<std::uint64_t>() <= static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    } else if (json.is_number_integer()) {
+        const std::int64_t value = json.get<std::int64_t>();
+        if (value < 0) {
+            return std::is_signed<T>::value && value >= static_cast<std::int64_t>(std::numeric_limits<T>::min());
+        }
+        return static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    } else {
+        return true;
+    }
+}
+
+// Reads a de::ChunkedInput one character at a time for nlohmann::json::parse(),
+// which suspends the parse when a chunk runs out. Only compares equal to the
+// default-constructed end iterator, once the input has ended.
+class ChunkIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = const char &;
+
+    ChunkIterator() : input(nullptr), iter(nullptr) { }
+    explicit ChunkIterator(de::ChunkedInput & input) : input(&input) {
+        next_chunk();
+    }
+
+    reference operator*() const {
+        return *iter;
+    }
+    ChunkIterator & operator++() {
+        if (++iter == chunk.end()) {
+            next_chunk();
+        }
+        return *this;
+    }
+    bool operator==(const ChunkIterator & other) const {
+        return at_end() == other.at_end();
+    }
+    bool operator!=(const ChunkIterator & other) const {
+        return at_end() != other.at_end();
+    }
+
+private:
+    void next_chunk() {
+        chunk = input->next_chunk();
+        iter = chunk.begin();
+    }
+    bool at_end() const {
+        return input == nullptr || chunk.size() == 0;
+    }
+
+    de::ChunkedInput* input;
+    serde::string_view chunk;
+    const char* iter;
+};
+
+}  // namespace
+
+JsonDeserializer::JsonDeserializationException::JsonDeserializationException(serde::string_view message, de::ErrorCode code)
+    : de::DeserializationException(message, code) { }
+
+JsonDeserializer::JsonDeserializer(const nlohmann::json & contents)
+    : json(contents), borrowed(true) { }
 
-JsonDeserializer::JsonDeserializer(const nlohmann::json & contents) {
-    json_stack.push({ contents });
+JsonDeserializer::JsonDeserializer(nlohmann::json && contents)
+    : document(std::move(contents)), json(document), borrowed(false) { }
+
+JsonDeserializer::JsonDeserializer(const std::string & contents)
+    : document(nlohmann::json::parse(contents, nullptr, KINGW_SERDE_EXCEPTIONS)), json(document), borrowed(false)
+{
+    if (document.is_discarded()) {
+        fail(de::ErrorCode::Syntax, "json could not be parsed");
+    }
 }
 
-JsonDeserializer::JsonDeserializer(const std::string & contents) {
-    json_stack.push({ nlohmann::json::parse(contents) });
+JsonDeserializer::JsonDeserializer(de::ChunkedInput & input)
+    : document(nlohmann::json::parse(ChunkIterator(input), ChunkIterator(), nullptr, KINGW_SERDE_EXCEPTIONS)), json(document), borrowed(false)
+{
+    if (document.is_discarded()) {
+        fail(de::ErrorCode::Syntax, "json could not be parsed");
+    }
 }
 
+JsonDeserializer::JsonDeserializer(const nlohmann::json & contents, bool borrowed)
+    : json(contents), borrowed(borrowed) { }
+
 bool JsonDeserializer::is_human_readable() const {
     return true;
 }
 
+void JsonDeserializer::raise(const de::Error & error) {
+    if (error.code == de::ErrorCode::NotImplemented) {
+        de::Deserializer::raise(error);
+    } else {
+        KINGW_SERDE_THROW(JsonDeserializationException(error.message, error.code));
+    }
+}
+
 // Basic Types
 void JsonDeserializer::deserialize_any(de::Visitor & visitor) {
-    throw JsonDeserializationException("deserialize_any() not implemented");
+    switch (json.type()) {
+    case nlohmann::json::value_t::null:
+        visitor.visit_unit();
+        break;
+    case nlohmann::json::value_t::boolean:
+        visitor.visit_bool(json.get<bool>());
+        break;
+    case nlohmann::json::value_t::number_integer:
+        visitor.visit_i64(json.get<std::int64_t>());
+        break;
+    case nlohmann::json::value_t::number_unsigned:
+        visitor.visit_u64(json.get<std::uint64_t>());
+        break;
+    case nlohmann::json::value_t::number_float:
+        visitor.visit_f64(json.get<double>());
+        break;
+    case nlohmann::json::value_t::string:
+        deserialize_string(visitor);
+        break;
+    case nlohmann::json::value_t::binary: {
+        const auto & binary = json.get_binary();
+        visitor.visit_bytes(binary.data(), binary.size());
+        break;
+    }
+    case nlohmann::json::value_t::array:
+        deserialize_seq(visitor);
+        break;
+    case nlohmann::json::value_t::object:
+        deserialize_map(visitor);
+        break;
+    default:
+        fail(de::ErrorCode::InvalidType, "json value was discarded");
+        break;
+    }
 }
 void JsonDeserializer::deserialize_bool(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_boolean()) {
         visitor.visit_bool(json);
     } else {
-        throw JsonDeserializationException("json value was not boolean");
+        fail(de::ErrorCode::InvalidType, "json value was not boolean");
     }
 }
 void JsonDeserializer::deserialize_i8(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_i8(json);
+        visit_integer<std::int8_t>(visitor, &de::Visitor::visit_i8);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_i16(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_i16(json);
+        visit_integer<std::int16_t>(visitor, &de::Visitor::visit_i16);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_i32(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_i32(json);
+        visit_integer<std::int32_t>(visitor, &de::Visitor::visit_i32);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_i64(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_i64(json);
+        visit_integer<std::int64_t>(visitor, &de::Visitor::visit_i64);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_u8(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_u8(json);
+        visit_integer<std::uint8_t>(visitor, &de::Visitor::visit_u8);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_u16(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_u16(json);
+        visit_integer<std::uint16_t>(visitor, &de::Visitor::visit_u16);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_u32(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_u32(json);
+        visit_integer<std::uint32_t>(visitor, &de::Visitor::visit_u32);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_u64(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_integer()) {
-        visitor.visit_u64(json);
+        visit_integer<std::uint64_t>(visitor, &de::Visitor::visit_u64);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_f32(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_float() || json.is_number_integer()) {
         visitor.visit_f32(json);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_f64(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_number_float() || json.is_number_integer()) {
         visitor.visit_f64(json);
     } else {
-        throw JsonDeserializationException("json value was not a number");
+        fail(de::ErrorCode::InvalidType, "json value was not a number");
     }
 }
 void JsonDeserializer::deserialize_char(de::Visitor & visitor) {
     deserialize_string(visitor);  // nlohmann::json doesn't support char
 }
 void JsonDeserializer::deserialize_string(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_string()) {
-        visitor.visit_string(json);
+        // Strings in a document owned by this deserializer are gone once it is.
+        const std::string & value = json.get_ref<const std::string &>();
+        if (borrowed) {
+            visitor.visit_borrowed_string(value);
+        } else {
+            visitor.visit_string(value);
+        }
     } else {
-        throw JsonDeserializationException("json value was not a string");
+        fail(de::ErrorCode::InvalidType, "json value was not a string");
     }
 }
 void JsonDeserializer::deserialize_seq(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_array()) {
-        JsonSeqAccess seq(json);
+        JsonSeqAccess seq(json, *this, borrowed);
         visitor.visit_seq(seq);
     } else {
-        throw JsonDeserializationException("json value was not a sequence");
+        fail(de::ErrorCode::InvalidType, "json value was not a sequence");
     }
 }
 void JsonDeserializer::deserialize_map(de::Visitor & visitor) {
-    auto & json = json_stack.top();
     if (json.is_object()) {
-        JsonMapAccess map(json);
+        JsonMapAccess map(json, *this, borrowed);
         visitor.visit_map(map);
     } else {
-        throw JsonDeserializationException("json value was not a map");
+        fail(de::ErrorCode::InvalidType, "json value was not a map");
     }
 }
 void JsonDeserializer::deserialize_struct(
@@ -145,53 +295,159 @@ void JsonDeserializer::deserialize_struct(
     const FieldNames & field_names,
     de::Visitor & visitor)
 {
-    auto & json = json_stack.top();
     if (json.is_object()) {
-        JsonStructAccess map(json, field_names);
+        JsonStructAccess map(json, field_names, *this, borrowed);
         visitor.visit_map(map);
     } else {
-        throw JsonDeserializationException("json value was not a struct");
+        fail(de::ErrorCode::InvalidType, "json value was not a struct");
+    }
+}
+void JsonDeserializer::deserialize_bytes(de::Visitor & visitor) {
+    if (json.is_string()) {
+        // Written by JsonSerializer::serialize_bytes() as base64.
+        const std::string & encoded = json.get_ref<const std::string &>();
+        std::vector<std::uint8_t> decoded(serde::base64_decoded_size(encoded.size()));
+        std::size_t len = 0;
+        if (!serde::base64_decode(encoded.data(), encoded.size(), decoded.data(), len)) {
+            fail(de::ErrorCode::InvalidValue, "json string was not valid base64");
+            return;
+        }
+        visitor.visit_bytes(decoded.data(), len);
+    } else if (json.is_binary()) {
+        const nlohmann::json::binary_t & binary = json.get_binary();
+        visitor.visit_bytes(binary.data(), binary.size());
+    } else if (json.is_array()) {
+        JsonSeqAccess seq(json, *this, borrowed);
+        visitor.visit_seq(seq);
+    } else {
+        fail(de::ErrorCode::InvalidType, "json value was not bytes");
     }
 }
+void JsonDeserializer::deserialize_ignored_any(de::Visitor &) {
+    // The document is already parsed, so there is nothing to skip over.
+}
 
-JsonDeserializer::JsonSeqAccess::JsonSeqAccess(nlohmann::json new_seq)
-    : seq(std::move(new_seq)), iter(seq.begin()) { }
+template <class T>
+void JsonDeserializer::visit_integer(de::Visitor & visitor, void (de::Visitor::*visit)(T)) {
+    if (fits<T>(json)) {
+        (visitor.*visit)(json.get<T>());
+    } else if (json.is_number_unsigned()) {
+        // Let the visitor's own range check report the error.
+        visitor.visit_u64(json.get<std::uint64_t>());
+    } else {
+        visitor.visit_i64(json.get<std::int64_t>());
+    }
+}
+
+JsonDeserializer::JsonSeqAccess::JsonSeqAccess(const nlohmann::json & seq, de::Deserializer & parent, bool borrowed)
+    : seq(seq), parent(parent), iter(seq.begin()), borrowed(borrowed)
+{
+    report_to(parent);
+}
 bool JsonDeserializer::JsonSeqAccess::has_next() {
-    return iter != seq.end();
+    return iter != seq.end() && !parent.failed();
+}
+std::size_t JsonDeserializer::JsonSeqAccess::size_hint() const {
+    return static_cast<std::size_t>(seq.end() - iter);
 }
 void JsonDeserializer::JsonSeqAccess::next_element(de::Deserialize & element) {
     if (has_next()) {
-        // TODO: Make efficient with pointers. Be careful with std::stack iterator invalidation.
-        JsonDeserializer deserializer(*iter);
-        element.deserialize(deserializer);
+        JsonDeserializer deserializer(*iter, borrowed);
+        deserializer.report_to(parent);
+        deserializer.deserialize_at(static_cast<std::size_t>(iter - seq.begin()), element);
         ++iter;
     } else {
-        throw JsonDeserializationException("json end of sequence reached");
+        fail(de::ErrorCode::EndOfInput, "json end of sequence reached");
+    }
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_bool_elements(bool* output, std::size_t len) {
+    return next_basic_elements(output, len, is_boolean);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_i8_elements(std::int8_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_i16_elements(std::int16_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_i32_elements(std::int32_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_i64_elements(std::int64_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_u8_elements(std::uint8_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_u16_elements(std::uint16_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_u32_elements(std::uint32_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_u64_elements(std::uint64_t* output, std::size_t len) {
+    return next_basic_elements(output, len, is_integer);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_f32_elements(float* output, std::size_t len) {
+    return next_basic_elements(output, len, is_number);
+}
+std::size_t JsonDeserializer::JsonSeqAccess::next_f64_elements(double* output, std::size_t len) {
+    return next_basic_elements(output, len, is_number);
+}
+
+template <class T>
+std::size_t JsonDeserializer::JsonSeqAccess::next_basic_elements(T* output, std::size_t len,
+    bool (*accept)(const nlohmann::json &))
+{
+    // Read the elements directly instead of wrapping each one
+    // in a nested JsonDeserializer and Visitor.
+    const bool trusted = parent.trusted();
+    std::size_t count = 0;
+    while (count < len && iter != seq.end()) {
+        if (trusted ? converts<T>(*iter) : accept(*iter) && fits<T>(*iter)) {
+            output[count] = iter->get<T>();
+            ++count;
+            ++iter;
+        } else {
+            // Let next_element() report the error, along with its index.
+            de::Accessor<T> accessor(output[count]);
+            next_element(accessor);
+            return parent.failed() ? count : count + 1;
+        }
     }
+    return count;
 }
 
-JsonDeserializer::JsonMapAccess::JsonMapAccess(nlohmann::json new_map)
-    : map(std::move(new_map)), items(map.items()), iter(items.begin()) { }
+JsonDeserializer::JsonMapAccess::JsonMapAccess(const nlohmann::json & map, de::Deserializer & parent, bool borrowed)
+    : map(map), parent(parent), iter(map.begin()), remaining(map.size()), borrowed(borrowed),
+      key_json(nlohmann::json::value_t::string)
+{
+    report_to(parent);
+}
 bool JsonDeserializer::JsonMapAccess::has_next() {
-    return iter != items.end();
+    return iter != map.end() && !parent.failed();
+}
+std::size_t JsonDeserializer::JsonMapAccess::size_hint() const {
+    return remaining;
 }
 void JsonDeserializer::JsonMapAccess::next_key(de::Deserialize & key) {
     if (has_next()) {
-        // TODO: Make efficient with pointers. Be careful with std::stack iterator invalidation.
-        JsonDeserializer deserializer(std::string("\"") + iter.key() + "\"");
-        key.deserialize(deserializer);
+        key_json.get_ref<std::string &>() = iter.key();
+        JsonDeserializer deserializer(key_json, false);  // Not borrowed, key_json is overwritten
+        deserializer.report_to(parent);
+        deserializer.deserialize_at(iter.key(), key);
     } else {
-        throw JsonDeserializationException("json end of map reached");
+        fail(de::ErrorCode::EndOfInput, "json end of map reached");
     }
 }
 void JsonDeserializer::JsonMapAccess::next_value(de::Deserialize & value) {
     if (has_next()) {
-        // TODO: Make efficient with pointers. Be careful with std::stack iterator invalidation.
-        JsonDeserializer deserializer(iter.value());
-        value.deserialize(deserializer);
+        JsonDeserializer deserializer(iter.value(), borrowed);
+        deserializer.report_to(parent);
+        deserializer.deserialize_at(iter.key(), value);
         ++iter;
+        --remaining;
     } else {
-        throw JsonDeserializationException("json end of map reached");
+        fail(de::ErrorCode::EndOfInput, "json end of map reached");
     }
 }
 void JsonDeserializer::JsonMapAccess::next_entry(de::Deserialize & key, de::Deserialize & value) {
@@ -199,28 +455,40 @@ void JsonDeserializer::JsonMapAccess::next_entry(de::Deserialize & key, de::Dese
     next_value(value);
 }
 
-JsonDeserializer::JsonStructAccess::JsonStructAccess(nlohmann::json new_map, const FieldNames & field_names)
-    : map(std::move(new_map)), field_names(field_names), iter(field_names.begin()) { }
+JsonDeserializer::JsonStructAccess::JsonStructAccess(const nlohmann::json & map, const FieldNames & field_names,
+    de::Deserializer & parent, bool borrowed)
+    : map(map), field_names(field_names), parent(parent), iter(field_names.begin()), borrowed(borrowed),
+      key_json(nlohmann::json::value_t::string)
+{
+    report_to(parent);
+}
 bool JsonDeserializer::JsonStructAccess::has_next() {
-    return iter != field_names.end();
+    return iter != field_names.end() && !parent.failed();
+}
+std::size_t JsonDeserializer::JsonStructAccess::size_hint() const {
+    return static_cast<std::size_t>(field_names.end() - iter);
 }
 void JsonDeserializer::JsonStructAccess::next_key(de::Deserialize & key) {
     if (has_next()) {
-        // TODO: Make efficient with pointers. Be careful with std::stack iterator invalidation.
-        JsonDeserializer deserializer(std::string("\"") + std::string(iter->begin(), iter->end()) + "\"");
+        key_json.get_ref<std::string &>().assign(iter->begin(), iter->end());
+        JsonDeserializer deserializer(key_json, false);  // Not borrowed, key_json is overwritten
+        deserializer.report_to(parent);
         key.deserialize(deserializer);
     } else {
-        throw JsonDeserializationException("json end of map reached");
+        fail(de::ErrorCode::EndOfInput, "json end of map reached");
     }
 }
 void JsonDeserializer::JsonStructAccess::next_value(de::Deserialize & value) {
     if (has_next()) {
-        // TODO: Make efficient with pointers. Be careful with std::stack iterator invalidation.
-        JsonDeserializer deserializer(map[std::string(iter->begin(), iter->end())]);
-        value.deserialize(deserializer);
+        // Missing fields are presented as null, which the field's
+        // own deserialize() will reject if it cannot be null.
+        auto field = map.find(std::string(iter->begin(), iter->end()));
+        JsonDeserializer deserializer(field != map.end() ? *field : null_json, borrowed);
+        deserializer.report_to(parent);
+        deserializer.deserialize_at(*iter, value);
         ++iter;
     } else {
-        throw JsonDeserializationException("json end of map reached");
+        fail(de::ErrorCode::EndOfInput, "json end of map reached");
     }
 }
 void JsonDeserializer::JsonStructAccess::next_entry(de::Deserialize & key, de::Deserialize & value) {
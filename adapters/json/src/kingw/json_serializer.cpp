@@ -1,11 +1,34 @@
 #include "kingw/json_serializer.hpp"
 
 #include "kingw/ostream_serializer.hpp"
+#include "kingw/serde/base64.hpp"
+#include "kingw/serde/exceptions.hpp"
 
 
 namespace kingw {
 namespace serde_json {
 
+namespace {
+
+template <class T>
+void append_elements(nlohmann::json & json, const T* values, std::size_t len) {
+    // Matches seq_serialize_element(): an empty sequence leaves
+    // the value untouched, otherwise elements are appended to it.
+    if (len == 0) {
+        return;
+    }
+    if (json.is_null()) {
+        json = nlohmann::json::array();
+    }
+    auto & array = json.get_ref<nlohmann::json::array_t &>();
+    array.reserve(array.size() + len);
+    for (std::size_t i = 0; i < len; ++i) {
+        array.emplace_back(values[i]);
+    }
+}
+
+}  // namespace
+
 JsonSerializer::JsonSerializationException::JsonSerializationException(serde::string_view message)
     : ser::SerializationException(message) { }
 
@@ -23,7 +46,18 @@ std::string JsonSerializer::dump() const {
     } else {
         // Logic error - this shouldn't occur if the user is using
         // serialize_seq(), _map(), _struct(), etc.
-        throw JsonSerializationException("JsonSerializer internal data structure corrupted during serialization");
+        KINGW_SERDE_THROW(JsonSerializationException("JsonSerializer internal data structure corrupted during serialization"));
+    }
+}
+
+void JsonSerializer::dump(std::string & output) const {
+    if (json_stack.size() == 1) {
+        // What nlohmann::json::dump() does, but into an existing string.
+        nlohmann::detail::serializer<nlohmann::json> serializer(
+            nlohmann::detail::output_adapter<char>(output), ' ');
+        serializer.dump(json_stack.top(), false, false, 0);
+    } else {
+        KINGW_SERDE_THROW(JsonSerializationException("JsonSerializer internal data structure corrupted during serialization"));
     }
 }
 
@@ -67,6 +101,51 @@ void JsonSerializer::serialize_string(serde::string_view value) {
     json_stack.top() = std::string(value.begin(), value.end());
 }
 
+void JsonSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+void JsonSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    append_elements(json_stack.top(), values, len);
+}
+
+void JsonSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    // JSON has no byte arrays, so bytes are written as a base64 string.
+    std::string encoded(serde::base64_encoded_size(len), '\0');
+    serde::base64_encode(data, len, &encoded[0]);
+    json_stack.top() = std::move(encoded);
+}
+
+void JsonSerializer::serialize_unit() {
+    json_stack.top() = nullptr;
+}
+
 
 ///
 /// Sequences 
@@ -84,7 +163,7 @@ void JsonSerializer::seq_serialize_element(const ser::Serialize & accessor) {
     if (json_stack.size() < 2) {
         // Logic error - this shouldn't occur if the user is using
         // serialize_seq(), _map(), _struct(), etc.
-        throw JsonSerializationException("JsonSerializer internal data structure corrupted during serialization");
+        KINGW_SERDE_THROW(JsonSerializationException("JsonSerializer internal data structure corrupted during serialization"));
     }
     nlohmann::json json = std::move(json_stack.top());
     json_stack.pop();
@@ -108,7 +187,7 @@ void JsonSerializer::map_begin(std::size_t len) {
 
 void JsonSerializer::map_serialize_key(const ser::Serialize & accessor) {
     if (!accessor.traits().is_string) {
-        throw JsonSerializationException("JsonSerializer map key is not a string");
+        KINGW_SERDE_THROW(JsonSerializationException("JsonSerializer map key is not a string"));
     }
 
     // Convert the key into a string.
@@ -124,7 +203,7 @@ void JsonSerializer::map_serialize_value(const ser::Serialize & accessor) {
     if (json_stack.size() < 2) {
         // Logic error - this shouldn't occur if the user is using
         // serialize_seq(), _map(), _struct(), etc.
-        throw JsonSerializationException("JsonSerializer internal data structure corrupted during serialization");
+        KINGW_SERDE_THROW(JsonSerializationException("JsonSerializer internal data structure corrupted during serialization"));
     }
     nlohmann::json value = std::move(json_stack.top());
     json_stack.pop();
@@ -159,7 +238,7 @@ void JsonSerializer::struct_serialize_field(serde::string_view name, const ser::
     if (json_stack.size() < 2) {
         // Logic error - this shouldn't occur if the user is using
         // serialize_seq(), _map(), _struct(), etc.
-        throw JsonSerializationException("JsonSerializer internal data structure corrupted during serialization");
+        KINGW_SERDE_THROW(JsonSerializationException("JsonSerializer internal data structure corrupted during serialization"));
     }
     nlohmann::json field = std::move(json_stack.top());
     json_stack.pop();
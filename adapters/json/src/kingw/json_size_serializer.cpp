@@ -0,0 +1,262 @@
+#include "kingw/json_size_serializer.hpp"
+
+#include <array>
+#include <cmath>
+
+#include <nlohmann/json.hpp>
+
+#include "kingw/ostream_serializer.hpp"
+#include "kingw/serde/base64.hpp"
+
+
+namespace kingw {
+namespace serde_json {
+
+namespace {
+
+constexpr std::size_t NULL_SIZE = 4;   // null
+constexpr std::size_t TRUE_SIZE = 4;   // true
+constexpr std::size_t FALSE_SIZE = 5;  // false
+
+// Length of a string once quoted and escaped, like nlohmann::json::dump()
+// without ensure_ascii. Only ASCII characters are ever escaped, so this
+// doesn't need to decode UTF-8.
+std::size_t string_length(serde::string_view value) {
+    std::size_t length = value.size() + 2;
+    for (char c : value) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if (byte == '"' || byte == '\\' || byte == '\b' || byte == '\f'
+            || byte == '\n' || byte == '\r' || byte == '\t') {
+            length += 1;  // \" and friends
+        } else if (byte <= 0x1F) {
+            length += 5;  // \u00XX
+        }
+    }
+    return length;
+}
+
+}  // namespace
+
+JsonSizeSerializer::JsonSizeSerializer() { }
+
+bool JsonSizeSerializer::is_human_readable() const {
+    return true;
+}
+
+std::size_t JsonSizeSerializer::dump_size() const {
+    return size() == 0 ? NULL_SIZE : size();
+}
+
+void JsonSizeSerializer::add_bool(bool value) {
+    add(value ? TRUE_SIZE : FALSE_SIZE);
+}
+
+void JsonSizeSerializer::add_i64(std::int64_t value) {
+    add(ser::decimal_length(value));
+}
+
+void JsonSizeSerializer::add_u64(std::uint64_t value) {
+    add(ser::decimal_length(value));
+}
+
+void JsonSizeSerializer::add_f64(double value) {
+    if (!std::isfinite(value)) {
+        add(NULL_SIZE);
+        return;
+    }
+    // Same buffer size and function as nlohmann::json's serializer.
+    std::array<char, 64> buffer;
+    const char* end = nlohmann::detail::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    add(static_cast<std::size_t>(end - buffer.data()));
+}
+
+template <class T, class U>
+void JsonSizeSerializer::add_seq(const T* values, std::size_t len, void (JsonSizeSerializer::*add_element)(U)) {
+    // An empty sequence leaves the value null.
+    if (len == 0) {
+        return;
+    }
+    add(len + 1);  // [ ] and the commas between elements
+    for (std::size_t i = 0; i < len; ++i) {
+        (this->*add_element)(values[i]);
+    }
+}
+
+void JsonSizeSerializer::add_item() {
+    if (!items.empty()) {
+        add(1);  // The opening bracket or brace, or a comma
+        ++items.back();
+    }
+}
+
+void JsonSizeSerializer::add_value(const ser::Serialize & accessor) {
+    // A value that isn't set to anything is written as null.
+    const std::size_t before = size();
+    accessor.serialize(*this);
+    if (size() == before) {
+        add(NULL_SIZE);
+    }
+}
+
+void JsonSizeSerializer::serialize_bool(bool value) {
+    add_bool(value);
+}
+void JsonSizeSerializer::serialize_i8(std::int8_t value) {
+    add_i64(value);
+}
+void JsonSizeSerializer::serialize_i16(std::int16_t value) {
+    add_i64(value);
+}
+void JsonSizeSerializer::serialize_i32(std::int32_t value) {
+    add_i64(value);
+}
+void JsonSizeSerializer::serialize_i64(std::int64_t value) {
+    add_i64(value);
+}
+void JsonSizeSerializer::serialize_u8(std::uint8_t value) {
+    add_u64(value);
+}
+void JsonSizeSerializer::serialize_u16(std::uint16_t value) {
+    add_u64(value);
+}
+void JsonSizeSerializer::serialize_u32(std::uint32_t value) {
+    add_u64(value);
+}
+void JsonSizeSerializer::serialize_u64(std::uint64_t value) {
+    add_u64(value);
+}
+void JsonSizeSerializer::serialize_f32(float value) {
+    add_f64(value);
+}
+void JsonSizeSerializer::serialize_f64(double value) {
+    add_f64(value);
+}
+void JsonSizeSerializer::serialize_char(char value) {
+    // nlohmann::json stores a char as a number.
+    add_i64(value);
+}
+void JsonSizeSerializer::serialize_string(serde::string_view value) {
+    add(string_length(value));
+}
+
+void JsonSizeSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_bool);
+}
+void JsonSizeSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_i64);
+}
+void JsonSizeSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_i64);
+}
+void JsonSizeSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_i64);
+}
+void JsonSizeSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_i64);
+}
+void JsonSizeSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_u64);
+}
+void JsonSizeSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_u64);
+}
+void JsonSizeSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_u64);
+}
+void JsonSizeSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_u64);
+}
+void JsonSizeSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_f64);
+}
+void JsonSizeSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    add_seq(values, len, &JsonSizeSerializer::add_f64);
+}
+
+void JsonSizeSerializer::serialize_bytes(const std::uint8_t*, std::size_t len) {
+    // A base64 string, which never needs escaping.
+    add(serde::base64_encoded_size(len) + 2);
+}
+
+void JsonSizeSerializer::serialize_unit() {
+    add(NULL_SIZE);
+}
+
+
+///
+/// Sequences
+///
+
+void JsonSizeSerializer::seq_begin(std::size_t) {
+    items.push_back(0);
+}
+
+void JsonSizeSerializer::seq_serialize_element(const ser::Serialize & accessor) {
+    add_item();
+    add_value(accessor);
+}
+
+void JsonSizeSerializer::seq_end() {
+    // An empty sequence leaves the value null.
+    if (!items.empty()) {
+        if (items.back() > 0) {
+            add(1);
+        }
+        items.pop_back();
+    }
+}
+
+
+///
+/// Maps
+///
+
+void JsonSizeSerializer::map_begin(std::size_t) {
+    items.push_back(0);
+}
+
+void JsonSizeSerializer::map_serialize_key(const ser::Serialize & accessor) {
+    add_item();
+    if (accessor.traits().is_string) {
+        add(string_length(kingw::OStreamSerializer::to_string(accessor)) + 1);  // and the :
+    }
+}
+
+void JsonSizeSerializer::map_serialize_value(const ser::Serialize & accessor) {
+    add_value(accessor);
+}
+
+void JsonSizeSerializer::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    map_serialize_key(key);
+    map_serialize_value(value);
+}
+
+void JsonSizeSerializer::map_end() {
+    seq_end();
+}
+
+
+///
+/// Structs
+///
+
+void JsonSizeSerializer::struct_begin(serde::string_view, std::size_t) {
+    items.push_back(0);
+}
+
+void JsonSizeSerializer::struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) {
+    add_item();
+    add(string_length(name) + 1);  // and the :
+    add_value(accessor);
+}
+
+void JsonSizeSerializer::struct_skip_field(serde::string_view) {
+    // No-op
+}
+
+void JsonSizeSerializer::struct_end() {
+    seq_end();
+}
+
+}  // namespace serde_json
+}  // namespace kingw
@@ -38,6 +38,22 @@ public:
     void serialize_char(char value) override;
     void serialize_string(serde::string_view value) override;
 
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
 protected:
     // Lists/Sequences
     // Use serialize_seq() instead.
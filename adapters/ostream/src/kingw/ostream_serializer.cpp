@@ -52,6 +52,66 @@ void OStreamSerializer::serialize_string(serde::string_view value) {
     stream.write(value.data(), value.size());
 }
 
+void OStreamSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+void OStreamSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << values[i];
+    }
+}
+
+void OStreamSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    stream.write(reinterpret_cast<const char*>(data), len);
+}
+
 
 ///
 /// Sequences 
@@ -1,4 +1,6 @@
 #pragma once
 
+#include "kingw/sprintf_comparator.hpp"
 #include "kingw/sprintf_serializer.hpp"
+#include "kingw/sprintf_size_serializer.hpp"
 #include "kingw/sprintf_deserializer.hpp"
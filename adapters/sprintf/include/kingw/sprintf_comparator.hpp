@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+namespace serde_sprintf {
+
+// Serializes a value, comparing each token with what SPrintfSerializer
+// wrote into an existing buffer instead of writing it again. Nothing is
+// decoded from the buffer, and nothing is allocated per token.
+//
+// At the first token that differs, the comparison stops: every later
+// call returns without serializing anything nested inside it.
+class SPrintfComparator :
+    public ser::Serializer
+{
+public:
+    // [expected_begin, expected_end) is the output of an SPrintfSerializer,
+    // e.g. from the buffer up to to_buffer()'s return value.
+    SPrintfComparator(const char* expected_begin, const char* expected_end, bool human_readable = true);
+    bool is_human_readable() const override;
+
+    // Whether everything serialized so far matched,
+    // and nothing is left over in the buffer.
+    bool equal() const;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
+protected:
+    // Lists/Sequences
+    // Use serialize_seq() instead.
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & element) override;
+    void seq_end() override;
+
+    // Maps
+    // Use serialize_map() instead.
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & key) override;
+    void map_serialize_value(const ser::Serialize & value) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    // Use serialize_struct() instead.
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & field) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    // Compare one token, and the '\0' that follows it unless it was last.
+    void expect(const char* token, std::size_t len);
+    // Numbers are formatted by an SPrintfSerializer, to match exactly.
+    void expect_i64(std::int64_t value);
+    void expect_u64(std::uint64_t value);
+    void expect_f64(double value);
+    template <class T, class U>
+    void expect_seq(const T* values, std::size_t len, void (SPrintfComparator::*expect_element)(U));
+
+    // Mirrors SPrintfSerializer: unknown lengths were back-patched,
+    // so they are read here and checked by the matching *_end().
+    void begin_count(std::size_t len);
+    void count_item();
+    void end_count();
+
+    struct Count {
+        std::size_t expected;  // Only checked if the length was not known
+        std::size_t items;
+        bool known;
+    };
+
+    const char* cursor;
+    const char* end;
+    std::vector<Count> counts;
+    bool matches;
+    bool human_readable;
+};
+
+// Whether serializing `input` with an SPrintfSerializer would write
+// exactly [expected_begin, expected_end).
+template <class T>
+bool equals(const T & input, const char* expected_begin, const char* expected_end, bool human_readable = true) {
+    SPrintfComparator comparator(expected_begin, expected_end, human_readable);
+    ser::serialize(comparator, input);
+    return comparator.equal();
+}
+
+}  // namespace serde_sprintf
+}  // namespace kingw
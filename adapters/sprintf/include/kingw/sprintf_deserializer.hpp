@@ -1,6 +1,13 @@
 #pragma once
 
+#include <string>
+
+#include "kingw/de/chunked_input.hpp"
 #include "kingw/de/deserializer.hpp"
+#include "kingw/de/deserialize_in_place.hpp"
+#include "kingw/de/for_each_element.hpp"
+#include "kingw/de/try_deserialize.hpp"
+#include "kingw/de/validate.hpp"
 
 
 namespace kingw {
@@ -12,14 +19,25 @@ class SPrintfDeserializer :
 public:
     class SPrintfDeserializationException : public de::DeserializationException {
     public:
-        explicit SPrintfDeserializationException(serde::string_view message);
+        explicit SPrintfDeserializationException(serde::string_view message,
+            de::ErrorCode code = de::ErrorCode::Custom);
     };
 
     SPrintfDeserializer(serde::string_view input, bool human_readable = true);
+    // Reads from input that arrives in chunks. See de::ChunkedInput.
+    // Elements are parsed as soon as their '\0' delimiter arrives. Strings
+    // are not borrowed, since the chunk they are in may be gone after the
+    // next one, and last_end() may point into a chunk that is gone.
+    SPrintfDeserializer(de::ChunkedInput & input, bool human_readable = true);
     bool is_human_readable() const override;
     const char* last_end() const;
 
     // Basic Types
+    // The input is not self-describing. deserialize_any() reads strings,
+    // negative and fractional numbers, and units, but an unsigned integer
+    // looks just like the count in front of a sequence, map or struct, so
+    // it fails with ErrorCode::InvalidType. serde::Document and
+    // serde::transcode() can't read containers from this format.
     void deserialize_any(de::Visitor & visitor) override;
     void deserialize_bool(de::Visitor & visitor) override;
     void deserialize_i8(de::Visitor & visitor) override;
@@ -40,14 +58,37 @@ public:
         serde::string_view name,
         const FieldNames & field_names,
         de::Visitor & visitor) override;
+    void deserialize_bytes(de::Visitor & visitor) override;
+    // Skips an unknown struct field only if its value is a single element
+    // that can't be a count: a string, or a negative or fractional number.
+    // Any all-digit value fails with ErrorCode::InvalidType, because it may
+    // be the count of a sequence, map or struct. That includes plain
+    // unsigned integers, so a producer that adds an unsigned field, or any
+    // container, still breaks consumers that don't know the field.
+    void deserialize_ignored_any(de::Visitor & visitor) override;
 
     class SPrintfSeqAccess : public de::Deserializer::SeqAccess
     {
     public:
         explicit SPrintfSeqAccess(SPrintfDeserializer & parent);
         bool has_next() override;
+        std::size_t size_hint() const override;
         void next_element(de::Deserialize & element) override;
+        std::size_t next_bool_elements(bool* output, std::size_t len) override;
+        std::size_t next_i8_elements(std::int8_t* output, std::size_t len) override;
+        std::size_t next_i16_elements(std::int16_t* output, std::size_t len) override;
+        std::size_t next_i32_elements(std::int32_t* output, std::size_t len) override;
+        std::size_t next_i64_elements(std::int64_t* output, std::size_t len) override;
+        std::size_t next_u8_elements(std::uint8_t* output, std::size_t len) override;
+        std::size_t next_u16_elements(std::uint16_t* output, std::size_t len) override;
+        std::size_t next_u32_elements(std::uint32_t* output, std::size_t len) override;
+        std::size_t next_u64_elements(std::uint64_t* output, std::size_t len) override;
+        std::size_t next_f32_elements(float* output, std::size_t len) override;
+        std::size_t next_f64_elements(double* output, std::size_t len) override;
     private:
+        template <class T, class Read>
+        std::size_t next_basic_elements(T* output, std::size_t len, Read read);
+
         SPrintfDeserializer & parent;
         unsigned index;
         unsigned count;
@@ -58,6 +99,7 @@ public:
     public:
         explicit SPrintfMapAccess(SPrintfDeserializer & parent);
         bool has_next() override;
+        std::size_t size_hint() const override;
         void next_key(de::Deserialize & key) override;
         void next_value(de::Deserialize & value) override;
         void next_entry(de::Deserialize & key, de::Deserialize & value) override;
@@ -68,12 +110,46 @@ public:
     };
 
 protected:
+    void raise(const de::Error & error) override;
+
+    // These report errors through fail() and return 0 or false.
     serde::string_view next_delimited_string();
+    bool next_bool();
+    std::int64_t next_i64();
+    std::uint64_t next_u64();
+    double next_f64();
+
+    // Trusted input is parsed in place, without first looking for the
+    // '\0' after each token, wherever a later '\0' bounds the parse.
+    // skip_token() moves past the token ending at `end`.
+    bool parse_in_place();
+    void skip_token(const char* end);
 
 private:
+    // Whether there are bytes left in buffer, after getting more if there is
+    // a chunked input. Only complete elements are added to buffer, so trusted
+    // input can still be parsed in place.
+    bool has_input();
+    bool refill();
+    // Borrowed from the input unless it arrives in chunks.
+    void visit_string_token(de::Visitor & visitor, serde::string_view value);
+    void find_delimited_end();
+    serde::string_view terminated(serde::string_view token);
+
     serde::string_view buffer;
+    // Just past the last '\0' in buffer, or its start if there is none.
+    const char* delimited_end;
     const char* last_end_;
     bool human_readable;
+
+    // Chunked input only. `held` is what arrived after the last delimiter,
+    // and `pending` joins it with the next chunk when buffer needs both.
+    de::ChunkedInput* chunks;
+    std::string held;
+    std::string pending;
+
+    // Copy of a last token that has no '\0' after it, for parsing.
+    std::string last_token;
 };
 
 template <class T>
@@ -83,5 +159,20 @@ const char* from_string(T & output, serde::string_view input, bool human_readabl
     return deserializer.last_end();
 }
 
+// Deserializes without throwing. See de::try_deserialize().
+template <class T>
+de::Error try_from_string(T & output, serde::string_view input, bool human_readable = true) {
+    SPrintfDeserializer deserializer(input, human_readable);
+    return de::try_deserialize(deserializer, output);
+}
+
+// Checks that the input is a valid T, without constructing one.
+// See de::validate().
+template <class T>
+de::Error validate(serde::string_view input, bool human_readable = true) {
+    SPrintfDeserializer deserializer(input, human_readable);
+    return de::validate<T>(deserializer);
+}
+
 }  // namespace serde_sprintf
 }  // namespace kingw
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "kingw/ser/serializer.hpp"
 
 
@@ -34,6 +36,22 @@ public:
     void serialize_char(char value) override;
     void serialize_string(serde::string_view value) override;
 
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
 protected:
     // Lists/Sequences
     // Use serialize_seq() instead.
@@ -65,7 +83,19 @@ protected:
 private:
     void advance(std::size_t distance);
 
+    // Unknown lengths are written as a fixed-width placeholder, which
+    // the matching *_end() overwrites with the number of items.
+    void begin_count(std::size_t len);
+    void count_item();
+    void end_count();
+
+    struct Count {
+        char* placeholder;  // nullptr if the length was known up front
+        std::size_t items;
+    };
+
     Buffer buffer;
+    std::vector<Count> counts;
     char* last_end_;
     bool human_readable;
 };
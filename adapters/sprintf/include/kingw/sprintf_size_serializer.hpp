@@ -0,0 +1,98 @@
+#pragma once
+
+#include "kingw/ser/size_serializer.hpp"
+
+
+namespace kingw {
+namespace serde_sprintf {
+
+// Counts the size of the buffer SPrintfSerializer needs for a value,
+// without formatting anything. Integers are measured from their bits,
+// and floating point numbers from their integer part where that is exact.
+//
+// size() includes the '\0' after every token, including the last one, so
+// an SPrintfSerializer given exactly size() bytes never runs out of room.
+// Its last_end() is then size() - 1 bytes from the start of the buffer.
+class SPrintfSizeSerializer :
+    public ser::SizeSerializer
+{
+public:
+    explicit SPrintfSizeSerializer(bool human_readable = true);
+    bool is_human_readable() const override;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
+protected:
+    // Lists/Sequences
+    // Use serialize_seq() instead.
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & element) override;
+    void seq_end() override;
+
+    // Maps
+    // Use serialize_map() instead.
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & key) override;
+    void map_serialize_value(const ser::Serialize & value) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    // Use serialize_struct() instead.
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & field) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    // One token and its '\0'.
+    void add_token(std::size_t len);
+    template <class T, class U>
+    void add_seq(const T* values, std::size_t len, void (SPrintfSizeSerializer::*add_element)(U));
+    void add_i64(std::int64_t value);
+    void add_u64(std::uint64_t value);
+    void add_f64(double value);
+    void add_length(std::size_t len);
+
+    bool human_readable;
+};
+
+// Size of the buffer to_buffer() needs for `input`.
+template <class T>
+std::size_t buffer_size(const T & input, bool human_readable = true) {
+    SPrintfSizeSerializer serializer(human_readable);
+    ser::serialize(serializer, input);
+    return serializer.size();
+}
+
+}  // namespace serde_sprintf
+}  // namespace kingw
@@ -0,0 +1,289 @@
+#include "kingw/sprintf_comparator.hpp"
+
+#include <cstring>
+
+#include "kingw/sprintf_serializer.hpp"
+
+
+namespace kingw {
+namespace serde_sprintf {
+
+namespace {
+// Same as SPrintfSerializer's placeholder for unknown lengths.
+constexpr std::size_t COUNT_DIGITS = 20;
+
+// Room for any number SPrintfSerializer writes, including "%lf" of DBL_MAX.
+constexpr std::size_t SCRATCH_SIZE = 512;
+}  // namespace
+
+SPrintfComparator::SPrintfComparator(const char* expected_begin, const char* expected_end, bool human_readable)
+    : cursor(expected_begin), end(expected_end), matches(true), human_readable(human_readable) { }
+
+bool SPrintfComparator::is_human_readable() const {
+    return human_readable;
+}
+
+bool SPrintfComparator::equal() const {
+    return matches && counts.empty() && cursor == end;
+}
+
+void SPrintfComparator::expect(const char* token, std::size_t len) {
+    if (!matches) {
+        return;
+    }
+    if (static_cast<std::size_t>(end - cursor) < len || std::memcmp(cursor, token, len) != 0) {
+        matches = false;
+        return;
+    }
+    cursor += len;
+    // SPrintfSerializer delimits every token with '\0',
+    // except the last one if the buffer ended right after it.
+    if (cursor != end) {
+        if (*cursor != '\0') {
+            matches = false;
+            return;
+        }
+        ++cursor;
+    }
+}
+
+void SPrintfComparator::expect_i64(std::int64_t value) {
+    if (matches) {
+        char scratch[SCRATCH_SIZE];
+        SPrintfSerializer formatter(scratch, scratch + SCRATCH_SIZE, human_readable);
+        formatter.serialize_i64(value);
+        expect(scratch, formatter.last_end() - scratch);
+    }
+}
+
+void SPrintfComparator::expect_u64(std::uint64_t value) {
+    if (matches) {
+        char scratch[SCRATCH_SIZE];
+        SPrintfSerializer formatter(scratch, scratch + SCRATCH_SIZE, human_readable);
+        formatter.serialize_u64(value);
+        expect(scratch, formatter.last_end() - scratch);
+    }
+}
+
+void SPrintfComparator::expect_f64(double value) {
+    if (matches) {
+        char scratch[SCRATCH_SIZE];
+        SPrintfSerializer formatter(scratch, scratch + SCRATCH_SIZE, human_readable);
+        formatter.serialize_f64(value);
+        expect(scratch, formatter.last_end() - scratch);
+    }
+}
+
+template <class T, class U>
+void SPrintfComparator::expect_seq(const T* values, std::size_t len, void (SPrintfComparator::*expect_element)(U)) {
+    expect_u64(len);
+    for (std::size_t i = 0; i < len && matches; ++i) {
+        (this->*expect_element)(values[i]);
+    }
+}
+
+void SPrintfComparator::serialize_bool(bool value) {
+    expect_i64(value);
+}
+void SPrintfComparator::serialize_i8(std::int8_t value) {
+    expect_i64(value);
+}
+void SPrintfComparator::serialize_i16(std::int16_t value) {
+    expect_i64(value);
+}
+void SPrintfComparator::serialize_i32(std::int32_t value) {
+    expect_i64(value);
+}
+void SPrintfComparator::serialize_i64(std::int64_t value) {
+    expect_i64(value);
+}
+void SPrintfComparator::serialize_u8(std::uint8_t value) {
+    expect_u64(value);
+}
+void SPrintfComparator::serialize_u16(std::uint16_t value) {
+    expect_u64(value);
+}
+void SPrintfComparator::serialize_u32(std::uint32_t value) {
+    expect_u64(value);
+}
+void SPrintfComparator::serialize_u64(std::uint64_t value) {
+    expect_u64(value);
+}
+void SPrintfComparator::serialize_f32(float value) {
+    expect_f64(value);
+}
+void SPrintfComparator::serialize_f64(double value) {
+    expect_f64(value);
+}
+void SPrintfComparator::serialize_char(char value) {
+    expect(&value, 1);
+}
+void SPrintfComparator::serialize_string(serde::string_view value) {
+    expect(value.data(), value.size());
+}
+
+void SPrintfComparator::serialize_bool_seq(const bool* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_i64);
+}
+void SPrintfComparator::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_i64);
+}
+void SPrintfComparator::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_i64);
+}
+void SPrintfComparator::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_i64);
+}
+void SPrintfComparator::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_i64);
+}
+void SPrintfComparator::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_u64);
+}
+void SPrintfComparator::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_u64);
+}
+void SPrintfComparator::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_u64);
+}
+void SPrintfComparator::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_u64);
+}
+void SPrintfComparator::serialize_f32_seq(const float* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_f64);
+}
+void SPrintfComparator::serialize_f64_seq(const double* values, std::size_t len) {
+    expect_seq(values, len, &SPrintfComparator::expect_f64);
+}
+
+void SPrintfComparator::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    expect_u64(len);
+    expect(reinterpret_cast<const char*>(data), len);
+}
+
+
+///
+/// Sequences
+///
+
+void SPrintfComparator::seq_begin(std::size_t len) {
+    begin_count(len);
+}
+
+void SPrintfComparator::seq_serialize_element(const ser::Serialize & element) {
+    if (matches) {
+        count_item();
+        element.serialize(*this);
+    }
+}
+
+void SPrintfComparator::seq_end() {
+    end_count();
+}
+
+
+///
+/// Maps
+///
+
+void SPrintfComparator::map_begin(std::size_t len) {
+    begin_count(len);
+}
+
+void SPrintfComparator::map_serialize_key(const ser::Serialize & key) {
+    if (matches) {
+        count_item();
+        key.serialize(*this);
+    }
+}
+
+void SPrintfComparator::map_serialize_value(const ser::Serialize & value) {
+    if (matches) {
+        value.serialize(*this);
+    }
+}
+
+void SPrintfComparator::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    map_serialize_key(key);
+    map_serialize_value(value);
+}
+
+void SPrintfComparator::map_end() {
+    end_count();
+}
+
+
+///
+/// Structs
+///
+
+void SPrintfComparator::struct_begin(serde::string_view, std::size_t len) {
+    begin_count(len);
+}
+
+void SPrintfComparator::struct_serialize_field(serde::string_view name, const ser::Serialize & field) {
+    if (matches) {
+        count_item();
+        serialize_string(name);
+        field.serialize(*this);
+    }
+}
+
+void SPrintfComparator::struct_skip_field(serde::string_view) {
+    // No-op
+}
+
+void SPrintfComparator::struct_end() {
+    end_count();
+}
+
+
+///
+/// Lengths
+///
+
+void SPrintfComparator::begin_count(std::size_t len) {
+    if (len != UNKNOWN_LENGTH) {
+        expect_u64(len);
+        counts.push_back(Count{ 0, 0, true });
+        return;
+    }
+
+    // Read the back-patched placeholder, to check once the items are known.
+    std::size_t expected = 0;
+    if (matches) {
+        if (static_cast<std::size_t>(end - cursor) < COUNT_DIGITS) {
+            matches = false;
+        } else {
+            for (std::size_t i = 0; i < COUNT_DIGITS; ++i) {
+                if (cursor[i] < '0' || cursor[i] > '9') {
+                    matches = false;
+                    break;
+                }
+                expected = expected * 10 + (cursor[i] - '0');
+            }
+        }
+        expect(cursor, COUNT_DIGITS);
+    }
+    counts.push_back(Count{ expected, 0, false });
+}
+
+void SPrintfComparator::count_item() {
+    if (!counts.empty()) {
+        ++counts.back().items;
+    }
+}
+
+void SPrintfComparator::end_count() {
+    if (counts.empty()) {
+        return;
+    }
+    const Count count = counts.back();
+    counts.pop_back();
+    if (!count.known && count.items != count.expected) {
+        matches = false;
+    }
+}
+
+}  // namespace serde_sprintf
+}  // namespace kingw
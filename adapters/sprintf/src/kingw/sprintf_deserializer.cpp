@@ -1,35 +1,134 @@
 #include "kingw/sprintf_deserializer.hpp"
 
+#include <cstdlib>
+#include <limits>
+
 
 namespace kingw {
 namespace serde_sprintf {
 
-SPrintfDeserializer::SPrintfDeserializationException::SPrintfDeserializationException(serde::string_view message)
-    : de::DeserializationException(message) { }
+namespace {
+
+// Same range check that the integral visitors apply in visit_i64()/visit_u64(),
+// including truncating trusted input.
+template <class T, class U>
+T narrow(de::Deserializer & deserializer, U value) {
+    if (   (value >= std::numeric_limits<T>::min()
+        && value <= std::numeric_limits<T>::max())
+        || deserializer.trusted()) {
+        return static_cast<T>(value);
+    } else {
+        deserializer.fail(de::ErrorCode::InvalidValue, "number outside range");
+        return 0;
+    }
+}
+
+// Parse the plain decimal digits that SPrintfSerializer writes without
+// strtol(), which also handles whitespace, signs and overflow. Returns
+// where the digits stop, or nullptr if there are none, or more than 18,
+// which may not fit. Those are left to strtol() and strtoul().
+const char* parse_digits(const char* iter, const char* end, std::uint64_t & output) {
+    const char* const begin = iter;
+    std::uint64_t value = 0;
+    while (iter != end && *iter >= '0' && *iter <= '9') {
+        value = value * 10 + static_cast<std::uint64_t>(*iter - '0');
+        ++iter;
+    }
+    if (iter == begin || iter - begin > 18) {
+        return nullptr;
+    }
+    output = value;
+    return iter;
+}
+
+// Same, with an optional '-' first.
+const char* parse_digits(const char* iter, const char* end, std::int64_t & output) {
+    const bool negative = iter != end && *iter == '-';
+    std::uint64_t magnitude = 0;
+    const char* stop = parse_digits(iter + negative, end, magnitude);
+    if (stop != nullptr) {
+        output = negative ? -static_cast<std::int64_t>(magnitude) : static_cast<std::int64_t>(magnitude);
+    }
+    return stop;
+}
+
+}  // namespace
+
+SPrintfDeserializer::SPrintfDeserializationException::SPrintfDeserializationException(serde::string_view message, de::ErrorCode code)
+    : de::DeserializationException(message, code) { }
 
 SPrintfDeserializer::SPrintfDeserializer(serde::string_view input, bool human_readable)
-    : buffer(input), last_end_(buffer.begin()), human_readable(human_readable) { }
+    : buffer(input), last_end_(buffer.begin()), human_readable(human_readable), chunks(nullptr)
+{
+    find_delimited_end();
+}
+
+SPrintfDeserializer::SPrintfDeserializer(de::ChunkedInput & input, bool human_readable)
+    : buffer(), delimited_end(nullptr), last_end_(nullptr), human_readable(human_readable), chunks(&input) { }
 
 bool SPrintfDeserializer::is_human_readable() const {
     return human_readable;
 }
 
+void SPrintfDeserializer::raise(const de::Error & error) {
+    if (error.code == de::ErrorCode::NotImplemented) {
+        de::Deserializer::raise(error);
+    } else {
+        KINGW_SERDE_THROW(SPrintfDeserializationException(error.message, error.code));
+    }
+}
+
 const char* SPrintfDeserializer::last_end() const {
     return last_end_;
 }
 
 // Basic Types
 void SPrintfDeserializer::deserialize_any(de::Visitor & visitor) {
-    throw SPrintfDeserializationException("deserialize_any() not implemented");
-}
-void SPrintfDeserializer::deserialize_bool(de::Visitor & visitor) {
+    // The output is not self-describing, so the type of an element is
+    // guessed from what it looks like. A sequence, map or struct starts
+    // with its count, which looks like any other unsigned integer, so
+    // that fails like in deserialize_ignored_any() instead of reading the
+    // count as the value and leaving its elements behind.
+    const bool at_end = !has_input();
     serde::string_view next = next_delimited_string();
     if (next.size() == 0) {
-        throw SPrintfDeserializationException("buffer is empty");
-    } else if (next.size() != 1 || next[0] != '0' || next[0] != '1') {
-        throw SPrintfDeserializationException("element is not a boolean");
-    } else {
-        visitor.visit_bool(next[0] == '1');
+        if (at_end) {
+            fail(de::ErrorCode::EndOfInput, "buffer is empty");
+        } else {
+            visitor.visit_unit();  // Written by serialize_unit()
+        }
+        return;
+    }
+
+    const char* iter = next.begin();
+    while (iter != next.end() && *iter >= '0' && *iter <= '9') { ++iter; }
+    if (iter == next.end()) {
+        fail(de::ErrorCode::InvalidType, "cannot tell an unsigned integer from a sequence, map or struct");
+        return;
+    }
+
+    const serde::string_view number = terminated(next);
+    char* end{};
+    if (next[0] == '-') {
+        const std::int64_t value = std::strtol(number.begin(), &end, 10);
+        if (end == number.end()) {
+            visitor.visit_i64(value);
+            return;
+        }
+    }
+    if (next[0] == '-' || next[0] == '.' || (next[0] >= '0' && next[0] <= '9')) {
+        const double value = std::strtod(number.begin(), &end);
+        if (end == number.end()) {
+            visitor.visit_f64(value);
+            return;
+        }
+    }
+    visit_string_token(visitor, next);
+}
+void SPrintfDeserializer::deserialize_bool(de::Visitor & visitor) {
+    const bool value = next_bool();
+    if (!failed()) {
+        visitor.visit_bool(value);
     }
 }
 void SPrintfDeserializer::deserialize_i8(de::Visitor & visitor) {
@@ -42,17 +141,9 @@ void SPrintfDeserializer::deserialize_i32(de::Visitor & visitor) {
     deserialize_i64(visitor);
 }
 void SPrintfDeserializer::deserialize_i64(de::Visitor & visitor) {
-    serde::string_view next = next_delimited_string();
-    if (next.size() == 0) {
-        throw SPrintfDeserializationException("buffer is empty");
-    } else {
-        char* end{};
-        std::int64_t value = std::strtol(next.begin(), &end, 10);
-        if (end == next.end()) {
-            visitor.visit_i64(value);
-        } else {
-            throw SPrintfDeserializationException("element is not an integer or is too long");
-        }
+    const std::int64_t value = next_i64();
+    if (!failed()) {
+        visitor.visit_i64(value);
     }
 }
 void SPrintfDeserializer::deserialize_u8(de::Visitor & visitor) {
@@ -65,42 +156,26 @@ void SPrintfDeserializer::deserialize_u32(de::Visitor & visitor) {
     deserialize_u64(visitor);
 }
 void SPrintfDeserializer::deserialize_u64(de::Visitor & visitor) {
-    serde::string_view next = next_delimited_string();
-    if (next.size() == 0) {
-        throw SPrintfDeserializationException("buffer is empty");
-    } else {
-        char* end{};
-        std::uint64_t value = std::strtoul(next.begin(), &end, 10);
-        if (end == next.end()) {
-            visitor.visit_u64(value);
-        } else {
-            throw SPrintfDeserializationException("element is not an unsigned integer or is too long");
-        }
+    const std::uint64_t value = next_u64();
+    if (!failed()) {
+        visitor.visit_u64(value);
     }
 }
 void SPrintfDeserializer::deserialize_f32(de::Visitor & visitor) {
     deserialize_f64(visitor);
 }
 void SPrintfDeserializer::deserialize_f64(de::Visitor & visitor) {
-    serde::string_view next = next_delimited_string();
-    if (next.size() == 0) {
-        throw SPrintfDeserializationException("buffer is empty");
-    } else {
-        char* end{};
-        double value = std::strtod(next.begin(), &end);
-        if (end == next.end()) {
-            visitor.visit_f64(value);
-        } else {
-            throw SPrintfDeserializationException("element is not a float/double or is too long");
-        }
+    const double value = next_f64();
+    if (!failed()) {
+        visitor.visit_f64(value);
     }
 }
 void SPrintfDeserializer::deserialize_char(de::Visitor & visitor) {
     serde::string_view next = next_delimited_string();
     if (next.size() == 0) {
-        throw SPrintfDeserializationException("buffer is empty");
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
     } else if (next.size() != 1) {
-        throw SPrintfDeserializationException("element is not a character");
+        fail(de::ErrorCode::InvalidLength, "element is not a character");
     } else {
         visitor.visit_char(next[0]);
     }
@@ -108,9 +183,9 @@ void SPrintfDeserializer::deserialize_char(de::Visitor & visitor) {
 void SPrintfDeserializer::deserialize_string(de::Visitor & visitor) {
     serde::string_view next = next_delimited_string();
     if (next.size() == 0) {
-        throw SPrintfDeserializationException("buffer is empty");
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
     } else {
-        visitor.visit_string(next);
+        visit_string_token(visitor, next);
     }
 }
 void SPrintfDeserializer::deserialize_seq(de::Visitor & visitor) {
@@ -129,47 +204,153 @@ void SPrintfDeserializer::deserialize_struct(
     // TODO
     deserialize_map(visitor);
 }
+void SPrintfDeserializer::deserialize_bytes(de::Visitor & visitor) {
+    // Written by SPrintfSerializer::serialize_bytes() as a length,
+    // followed by that many raw bytes and a '\0' delimiter.
+    const std::uint64_t len = next_u64();
+    while (len >= buffer.size() && refill()) { }
+    if (failed()) {
+        return;
+    } else if (len > buffer.size()) {
+        fail(de::ErrorCode::EndOfInput, "buffer is too short for bytes");
+        return;
+    }
+    const char* data = buffer.begin();
+    const char* iter = data + len;
+    last_end_ = iter;
+    if (iter != buffer.end()) {
+        if (*iter != '\0' && !trusted()) {
+            fail(de::ErrorCode::Syntax, "bytes are not followed by a delimiter");
+            return;
+        }
+        ++iter;  // Skip '\0'
+    }
+    buffer = serde::string_view(iter, buffer.end() - iter);
+    visitor.visit_bytes(reinterpret_cast<const std::uint8_t*>(data), len);
+}
+void SPrintfDeserializer::deserialize_ignored_any(de::Visitor &) {
+    // The output is not self-describing. A sequence, map or struct starts
+    // with its count, which looks like any other unsigned integer, and its
+    // elements would be read back as the following keys. So only a value
+    // that can't be a count, which is a single delimited element, is skipped.
+    const bool at_end = !has_input();
+    serde::string_view next = next_delimited_string();
+    if (at_end) {
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
+        return;
+    }
+    const char* iter = next.begin();
+    while (iter != next.end() && *iter >= '0' && *iter <= '9') { ++iter; }
+    if (next.size() != 0 && iter == next.end()) {
+        fail(de::ErrorCode::InvalidType, "cannot skip a value that may be a sequence, map or struct");
+    }
+}
 
 SPrintfDeserializer::SPrintfSeqAccess::SPrintfSeqAccess(SPrintfDeserializer & parent)
     : parent(parent), index(0), count(0)
 {
+    report_to(parent);
     // Get the number of elements in the sequence
     de::deserialize(parent, count);
 }
 bool SPrintfDeserializer::SPrintfSeqAccess::has_next() {
-    return index < count;
+    return index < count && !parent.failed();
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::size_hint() const {
+    return count - index;
 }
 void SPrintfDeserializer::SPrintfSeqAccess::next_element(de::Deserialize & element) {
     if (has_next()) {
-        element.deserialize(parent);
+        parent.deserialize_at(index, element);
         ++index;
     } else {
-        throw SPrintfDeserializationException("end of sequence reached");
+        fail(de::ErrorCode::EndOfInput, "end of sequence reached");
     }
 }
 
+// Elements are parsed straight from the buffer instead of through
+// deserialize_at(), so the index of a failed element is added here.
+template <class T, class Read>
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_basic_elements(T* output, std::size_t len, Read read) {
+    std::size_t n = 0;
+#if KINGW_SERDE_EXCEPTIONS
+    try {
+#endif
+        for (; n < len && has_next(); ++n, ++index) {
+            output[n] = read();
+            if (parent.failed()) {
+                parent.add_error_path(index);
+                break;
+            }
+        }
+#if KINGW_SERDE_EXCEPTIONS
+    } catch (de::DeserializationException & e) {
+        e.add_path(index);
+        throw;
+    }
+#endif
+    return n;
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_bool_elements(bool* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return parent.next_bool(); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_i8_elements(std::int8_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return narrow<std::int8_t>(parent, parent.next_i64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_i16_elements(std::int16_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return narrow<std::int16_t>(parent, parent.next_i64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_i32_elements(std::int32_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return narrow<std::int32_t>(parent, parent.next_i64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_i64_elements(std::int64_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return parent.next_i64(); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_u8_elements(std::uint8_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return narrow<std::uint8_t>(parent, parent.next_u64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_u16_elements(std::uint16_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return narrow<std::uint16_t>(parent, parent.next_u64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_u32_elements(std::uint32_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return narrow<std::uint32_t>(parent, parent.next_u64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_u64_elements(std::uint64_t* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return parent.next_u64(); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_f32_elements(float* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return static_cast<float>(parent.next_f64()); });
+}
+std::size_t SPrintfDeserializer::SPrintfSeqAccess::next_f64_elements(double* output, std::size_t len) {
+    return next_basic_elements(output, len, [this] { return parent.next_f64(); });
+}
+
 SPrintfDeserializer::SPrintfMapAccess::SPrintfMapAccess(SPrintfDeserializer & parent)
     : parent(parent), index(0), count(0)
 {
+    report_to(parent);
     // Get the number of entries in the map
     de::deserialize(parent, count);
 }
 bool SPrintfDeserializer::SPrintfMapAccess::has_next() {
-    return index < count;
+    return index < count && !parent.failed();
+}
+std::size_t SPrintfDeserializer::SPrintfMapAccess::size_hint() const {
+    return count - index;
 }
 void SPrintfDeserializer::SPrintfMapAccess::next_key(de::Deserialize & key) {
     if (has_next()) {
         key.deserialize(parent);
     } else {
-        throw SPrintfDeserializationException("end of map reached");
+        fail(de::ErrorCode::EndOfInput, "end of map reached");
     }
 }
 void SPrintfDeserializer::SPrintfMapAccess::next_value(de::Deserialize & value) {
     if (has_next()) {
-        value.deserialize(parent);
+        parent.deserialize_at(index, value);
         ++index;
     } else {
-        throw SPrintfDeserializationException("end of map reached");
+        fail(de::ErrorCode::EndOfInput, "end of map reached");
     }
 }
 void SPrintfDeserializer::SPrintfMapAccess::next_entry(de::Deserialize & key, de::Deserialize & value) {
@@ -177,7 +358,116 @@ void SPrintfDeserializer::SPrintfMapAccess::next_entry(de::Deserialize & key, de
     next_value(value);
 }
 
+bool SPrintfDeserializer::next_bool() {
+    if (parse_in_place()) {
+        const bool value = buffer[0] == '1';
+        skip_token(buffer.begin() + 1);
+        return value;
+    }
+    serde::string_view next = next_delimited_string();
+    if (next.size() == 0) {
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
+        return false;
+    } else if (next.size() != 1 || (next[0] != '0' && next[0] != '1')) {
+        fail(de::ErrorCode::InvalidType, "element is not a boolean");
+        return false;
+    } else {
+        return next[0] == '1';
+    }
+}
+
+std::int64_t SPrintfDeserializer::next_i64() {
+    std::int64_t value = 0;
+    if (parse_in_place()) {
+        const char* stop = parse_digits(buffer.begin(), buffer.end(), value);
+        if (stop != nullptr && *stop == '\0') {
+            skip_token(stop);
+            return value;
+        }
+        char* end{};
+        value = std::strtol(buffer.begin(), &end, 10);
+        skip_token(end);
+        return value;
+    }
+    const serde::string_view token = next_delimited_string();
+    if (parse_digits(token.begin(), token.end(), value) == token.end()) {
+        return value;
+    }
+    serde::string_view next = terminated(token);
+    if (next.size() == 0) {
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
+        return 0;
+    } else {
+        char* end{};
+        value = std::strtol(next.begin(), &end, 10);
+        if (end == next.end()) {
+            return value;
+        } else {
+            fail(de::ErrorCode::InvalidType, "element is not an integer or is too long");
+            return 0;
+        }
+    }
+}
+
+std::uint64_t SPrintfDeserializer::next_u64() {
+    std::uint64_t value = 0;
+    if (parse_in_place()) {
+        const char* stop = parse_digits(buffer.begin(), buffer.end(), value);
+        if (stop != nullptr && *stop == '\0') {
+            skip_token(stop);
+            return value;
+        }
+        char* end{};
+        value = std::strtoul(buffer.begin(), &end, 10);
+        skip_token(end);
+        return value;
+    }
+    const serde::string_view token = next_delimited_string();
+    if (parse_digits(token.begin(), token.end(), value) == token.end()) {
+        return value;
+    }
+    serde::string_view next = terminated(token);
+    if (next.size() == 0) {
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
+        return 0;
+    } else {
+        char* end{};
+        value = std::strtoul(next.begin(), &end, 10);
+        if (end == next.end()) {
+            return value;
+        } else {
+            fail(de::ErrorCode::InvalidType, "element is not an unsigned integer or is too long");
+            return 0;
+        }
+    }
+}
+
+double SPrintfDeserializer::next_f64() {
+    if (parse_in_place()) {
+        char* end{};
+        const double value = std::strtod(buffer.begin(), &end);
+        skip_token(end);
+        return value;
+    }
+    serde::string_view next = terminated(next_delimited_string());
+    if (next.size() == 0) {
+        fail(de::ErrorCode::EndOfInput, "buffer is empty");
+        return 0;
+    } else {
+        char* end{};
+        double value = std::strtod(next.begin(), &end);
+        if (end == next.end()) {
+            return value;
+        } else {
+            fail(de::ErrorCode::InvalidType, "element is not a float/double or is too long");
+            return 0;
+        }
+    }
+}
+
 serde::string_view SPrintfDeserializer::next_delimited_string() {
+    has_input();
+
     // Find the next EOF, or the end of the input.
     const char* iter = buffer.begin();
     while (iter != buffer.end() && *iter != '\0') { ++iter; }
@@ -196,5 +486,91 @@ serde::string_view SPrintfDeserializer::next_delimited_string() {
     return result;
 }
 
+bool SPrintfDeserializer::parse_in_place() {
+    // A token that starts before the last '\0' ends at a '\0' within the
+    // buffer, so strtol() and friends can't read past it. The last token
+    // may not be delimited, so it is found like untrusted input.
+    return trusted() && has_input() && buffer.begin() < delimited_end;
+}
+
+serde::string_view SPrintfDeserializer::terminated(serde::string_view token) {
+    // strtol() and friends stop at the '\0' after a token. The last token
+    // may not have one, so it is parsed from a copy instead.
+    if (token.end() < delimited_end) {
+        return token;
+    }
+    last_token.assign(token.begin(), token.size());
+    return serde::string_view(last_token.data(), last_token.size());
+}
+
+void SPrintfDeserializer::find_delimited_end() {
+    const char* iter = buffer.end();
+    while (iter != buffer.begin() && iter[-1] != '\0') { --iter; }
+    delimited_end = iter;
+}
+
+void SPrintfDeserializer::skip_token(const char* end) {
+    // Trusted input: the token ends where parsing stopped, at its '\0'.
+    last_end_ = end;
+    const char* next = end < buffer.end() ? end + 1 : buffer.end();
+    buffer = serde::string_view(next, buffer.end() - next);
+}
+
+void SPrintfDeserializer::visit_string_token(de::Visitor & visitor, serde::string_view value) {
+    // Chunked input is only borrowed until the next chunk, or is a copy
+    // in `held`/`pending` that refill() overwrites, so it is transient.
+    if (chunks == nullptr) {
+        visitor.visit_borrowed_string(value);
+    } else {
+        visitor.visit_string(value);
+    }
+}
+
+bool SPrintfDeserializer::has_input() {
+    return buffer.size() != 0 || refill();
+}
+
+bool SPrintfDeserializer::refill() {
+    if (chunks == nullptr) {
+        return false;
+    }
+
+    // Only complete elements are added to the buffer. Whatever follows the
+    // last delimiter is held back until the rest of its element arrives.
+    // What is left of the buffer (the start of long bytes) is held too,
+    // because the chunk it points into may be gone after next_chunk().
+    const std::size_t before = buffer.size();
+    held.insert(0, buffer.begin(), before);
+    buffer = serde::string_view();
+
+    while (buffer.size() <= before) {
+        serde::string_view chunk = chunks->next_chunk();  // May suspend
+        if (chunk.size() == 0) {
+            // End of the input. The last element needs no delimiter.
+            pending.swap(held);
+            held.clear();
+            buffer = serde::string_view(pending.data(), pending.size());
+            break;
+        }
+
+        const char* last = chunk.end();
+        while (last != chunk.begin() && last[-1] != '\0') { --last; }
+        if (held.size() == 0) {
+            // Usual case: the chunk starts with a new element. Read it in place.
+            buffer = serde::string_view(chunk.begin(), last - chunk.begin());
+            held.assign(last, chunk.end() - last);
+        } else if (last == chunk.begin()) {
+            held.append(chunk.begin(), chunk.size());
+        } else {
+            held.append(chunk.begin(), last - chunk.begin());
+            pending.swap(held);
+            held.assign(last, chunk.end() - last);
+            buffer = serde::string_view(pending.data(), pending.size());
+        }
+    }
+    find_delimited_end();
+    return buffer.size() > before;
+}
+
 }  // namespace serde_sprintf
 }  // namespace kingw
@@ -3,6 +3,8 @@
 #include <cstdio>
 #include <cstring>
 
+#include "kingw/serde/exceptions.hpp"
+
 
 namespace kingw {
 namespace serde_sprintf {
@@ -38,7 +40,7 @@ void SPrintfSerializer::serialize_i64(std::int64_t value) {
     if (ret >= 0) {
         advance(ret);
     } else {
-        throw SPrintfSerializationException("failed to serialize integer");
+        KINGW_SERDE_THROW(SPrintfSerializationException("failed to serialize integer"));
     }
 }
 void SPrintfSerializer::serialize_u8(std::uint8_t value) {
@@ -55,7 +57,7 @@ void SPrintfSerializer::serialize_u64(std::uint64_t value) {
     if (ret >= 0) {
         advance(ret);
     } else {
-        throw SPrintfSerializationException("failed to serialize unsigned integer");
+        KINGW_SERDE_THROW(SPrintfSerializationException("failed to serialize unsigned integer"));
     }
 }
 void SPrintfSerializer::serialize_f32(float value) {
@@ -66,7 +68,7 @@ void SPrintfSerializer::serialize_f64(double value) {
     if (ret >= 0) {
         advance(ret);
     } else {
-        throw SPrintfSerializationException("failed to serialize floating point type");
+        KINGW_SERDE_THROW(SPrintfSerializationException("failed to serialize floating point type"));
     }
 }
 void SPrintfSerializer::serialize_char(char value) {
@@ -74,7 +76,7 @@ void SPrintfSerializer::serialize_char(char value) {
     if (ret >= 0) {
         advance(ret);
     } else {
-        throw SPrintfSerializationException("failed to serialize character");
+        KINGW_SERDE_THROW(SPrintfSerializationException("failed to serialize character"));
     }
 }
 void SPrintfSerializer::serialize_string(serde::string_view value) {
@@ -82,7 +84,97 @@ void SPrintfSerializer::serialize_string(serde::string_view value) {
         std::copy(value.begin(), value.end(), buffer.begin);
         advance(value.size());
     } else {
-        throw SPrintfSerializationException("failed to serialize string - too long");
+        KINGW_SERDE_THROW(SPrintfSerializationException("failed to serialize string - too long"));
+    }
+}
+
+void SPrintfSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_i64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_i64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_i64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_i64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_i64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_u64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_u64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_u64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_u64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_f64(values[i]);
+    }
+    seq_end();
+}
+void SPrintfSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    seq_begin(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        SPrintfSerializer::serialize_f64(values[i]);
+    }
+    seq_end();
+}
+
+void SPrintfSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    // Bytes may contain '\0', so they can't be delimited like a string.
+    // Serialize the number of bytes first, then the raw bytes.
+    SPrintfSerializer::serialize_u64(len);
+    if (len <= buffer.size()) {
+        std::memcpy(buffer.begin, data, len);
+        advance(len);
+    } else {
+        KINGW_SERDE_THROW(SPrintfSerializationException("failed to serialize bytes - too long"));
     }
 }
 
@@ -93,20 +185,17 @@ void SPrintfSerializer::serialize_string(serde::string_view value) {
 
 void SPrintfSerializer::seq_begin(std::size_t len) {
     // Serialize the number of elements in the sequence.
-    // If len is not provided, then throw an exception.
-    if (len == UNKNOWN_LENGTH) {
-        throw SPrintfSerializationException("SPrintfSerializer::serialize_seq() requires length parameter");
-    } else {
-        ser::serialize(*this, len);
-    }
+    // If len is not provided, then it is filled in by the end call.
+    begin_count(len);
 }
 
 void SPrintfSerializer::seq_serialize_element(const ser::Serialize & element) {
+    count_item();
     element.serialize(*this);
 }
 
 void SPrintfSerializer::seq_end() {
-    // No-op
+    end_count();
 }
 
 
@@ -116,15 +205,12 @@ void SPrintfSerializer::seq_end() {
 
 void SPrintfSerializer::map_begin(std::size_t len) {
     // Serialize the number of entries in the map.
-    // If len is not provided, then throw an exception.
-    if (len == UNKNOWN_LENGTH) {
-        throw SPrintfSerializationException("SPrintfSerializer::serialize_map() requires length parameter");
-    } else {
-        ser::serialize(*this, len);
-    }
+    // If len is not provided, then it is filled in by the end call.
+    begin_count(len);
 }
 
 void SPrintfSerializer::map_serialize_key(const ser::Serialize & key) {
+    count_item();
     key.serialize(*this);
 }
 
@@ -138,7 +224,7 @@ void SPrintfSerializer::map_serialize_entry(const ser::Serialize & key, const se
 }
 
 void SPrintfSerializer::map_end() {
-    // No-op
+    end_count();
 }
 
 
@@ -148,15 +234,12 @@ void SPrintfSerializer::map_end() {
 
 void SPrintfSerializer::struct_begin(serde::string_view name, std::size_t len) {
     // Serialize the number of fields in the struct.
-    // If len is not provided, then throw an exception.
-    if (len == UNKNOWN_LENGTH) {
-        throw SPrintfSerializationException("SPrintfSerializer::serialize_struct() requires length parameter");
-    } else {
-        ser::serialize(*this, len);
-    }
+    // If len is not provided, then it is filled in by the end call.
+    begin_count(len);
 }
 
 void SPrintfSerializer::struct_serialize_field(serde::string_view name, const ser::Serialize & field) {
+    count_item();
     serialize_string(name);
     field.serialize(*this);
 }
@@ -166,13 +249,55 @@ void SPrintfSerializer::struct_skip_field(serde::string_view name) {
 }
 
 void SPrintfSerializer::struct_end() {
-    // No-op
+    end_count();
 }
 
 std::size_t SPrintfSerializer::Buffer::size() const {
     return end - begin;
 }
 
+///
+/// Lengths
+///
+
+namespace {
+// Enough digits for any std::uint64_t. The deserializer reads the
+// leading zeros of the placeholder like any other number.
+constexpr std::size_t COUNT_DIGITS = 20;
+}  // namespace
+
+void SPrintfSerializer::begin_count(std::size_t len) {
+    if (len == UNKNOWN_LENGTH) {
+        char* placeholder = buffer.begin;
+        serialize_string(serde::string_view("00000000000000000000", COUNT_DIGITS));
+        counts.push_back(Count{ placeholder, 0 });
+    } else {
+        ser::serialize(*this, len);
+        counts.push_back(Count{ nullptr, 0 });
+    }
+}
+
+void SPrintfSerializer::count_item() {
+    if (!counts.empty()) {
+        ++counts.back().items;
+    }
+}
+
+void SPrintfSerializer::end_count() {
+    if (counts.empty()) {
+        return;
+    }
+    const Count count = counts.back();
+    counts.pop_back();
+    if (count.placeholder != nullptr) {
+        // Format into a temporary, since snprintf() would overwrite
+        // the '\0' delimiter after the placeholder.
+        char digits[COUNT_DIGITS + 1];
+        std::snprintf(digits, sizeof(digits), "%020lu", count.items);
+        std::memcpy(count.placeholder, digits, COUNT_DIGITS);
+    }
+}
+
 void SPrintfSerializer::advance(std::size_t distance) {
     auto size_ = buffer.size();
     if (distance < size_) {
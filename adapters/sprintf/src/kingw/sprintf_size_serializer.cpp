@@ -0,0 +1,225 @@
+#include "kingw/sprintf_size_serializer.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+
+namespace kingw {
+namespace serde_sprintf {
+
+namespace {
+// Same as SPrintfSerializer's placeholder for unknown lengths.
+constexpr std::size_t COUNT_DIGITS = 20;
+
+// "%lf" writes a '.' and 6 decimals after the integer part.
+constexpr std::size_t DECIMALS = 7;
+
+// Below this, the integer part fits in a std::uint64_t, and a double
+// is precise enough to tell whether rounding carries into a new digit.
+constexpr double EXACT_LIMIT = 1e15;
+constexpr double POWERS_OF_10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+};
+
+// Length of std::snprintf(..., "%lf", value).
+std::size_t float_length(double value) {
+    const double magnitude = std::fabs(value);
+    if (magnitude < EXACT_LIMIT) {
+        const std::size_t digits = ser::decimal_length(static_cast<std::uint64_t>(magnitude));
+        // Rounding to 6 decimals can only add a digit within 0.0000005
+        // of the next power of 10. Leave a margin for the subtraction.
+        if (magnitude < POWERS_OF_10[digits] - 0.000001) {
+            return (std::signbit(value) ? 1 : 0) + digits + DECIMALS;
+        }
+    }
+    // Large, NaN, infinite, or about to round up: let the C library decide.
+    return std::snprintf(nullptr, 0, "%lf", value);
+}
+}  // namespace
+
+SPrintfSizeSerializer::SPrintfSizeSerializer(bool human_readable)
+    : human_readable(human_readable) { }
+
+bool SPrintfSizeSerializer::is_human_readable() const {
+    return human_readable;
+}
+
+void SPrintfSizeSerializer::add_token(std::size_t len) {
+    add(len + 1);
+}
+
+void SPrintfSizeSerializer::add_i64(std::int64_t value) {
+    add_token(ser::decimal_length(value));
+}
+
+void SPrintfSizeSerializer::add_u64(std::uint64_t value) {
+    add_token(ser::decimal_length(value));
+}
+
+void SPrintfSizeSerializer::add_f64(double value) {
+    add_token(float_length(value));
+}
+
+void SPrintfSizeSerializer::add_length(std::size_t len) {
+    // Mirrors SPrintfSerializer::begin_count().
+    if (len == UNKNOWN_LENGTH) {
+        add_token(COUNT_DIGITS);
+    } else {
+        add_u64(len);
+    }
+}
+
+template <class T, class U>
+void SPrintfSizeSerializer::add_seq(const T* values, std::size_t len, void (SPrintfSizeSerializer::*add_element)(U)) {
+    add_u64(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        (this->*add_element)(values[i]);
+    }
+}
+
+void SPrintfSizeSerializer::serialize_bool(bool value) {
+    add_i64(value);
+}
+void SPrintfSizeSerializer::serialize_i8(std::int8_t value) {
+    add_i64(value);
+}
+void SPrintfSizeSerializer::serialize_i16(std::int16_t value) {
+    add_i64(value);
+}
+void SPrintfSizeSerializer::serialize_i32(std::int32_t value) {
+    add_i64(value);
+}
+void SPrintfSizeSerializer::serialize_i64(std::int64_t value) {
+    add_i64(value);
+}
+void SPrintfSizeSerializer::serialize_u8(std::uint8_t value) {
+    add_u64(value);
+}
+void SPrintfSizeSerializer::serialize_u16(std::uint16_t value) {
+    add_u64(value);
+}
+void SPrintfSizeSerializer::serialize_u32(std::uint32_t value) {
+    add_u64(value);
+}
+void SPrintfSizeSerializer::serialize_u64(std::uint64_t value) {
+    add_u64(value);
+}
+void SPrintfSizeSerializer::serialize_f32(float value) {
+    add_f64(value);
+}
+void SPrintfSizeSerializer::serialize_f64(double value) {
+    add_f64(value);
+}
+void SPrintfSizeSerializer::serialize_char(char) {
+    add_token(1);
+}
+void SPrintfSizeSerializer::serialize_string(serde::string_view value) {
+    add_token(value.size());
+}
+
+void SPrintfSizeSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_i64);
+}
+void SPrintfSizeSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_i64);
+}
+void SPrintfSizeSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_i64);
+}
+void SPrintfSizeSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_i64);
+}
+void SPrintfSizeSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_i64);
+}
+void SPrintfSizeSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_u64);
+}
+void SPrintfSizeSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_u64);
+}
+void SPrintfSizeSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_u64);
+}
+void SPrintfSizeSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_u64);
+}
+void SPrintfSizeSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_f64);
+}
+void SPrintfSizeSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    add_seq(values, len, &SPrintfSizeSerializer::add_f64);
+}
+
+void SPrintfSizeSerializer::serialize_bytes(const std::uint8_t*, std::size_t len) {
+    add_u64(len);
+    add_token(len);
+}
+
+
+///
+/// Sequences
+///
+
+void SPrintfSizeSerializer::seq_begin(std::size_t len) {
+    add_length(len);
+}
+
+void SPrintfSizeSerializer::seq_serialize_element(const ser::Serialize & element) {
+    element.serialize(*this);
+}
+
+void SPrintfSizeSerializer::seq_end() {
+    // No-op
+}
+
+
+///
+/// Maps
+///
+
+void SPrintfSizeSerializer::map_begin(std::size_t len) {
+    add_length(len);
+}
+
+void SPrintfSizeSerializer::map_serialize_key(const ser::Serialize & key) {
+    key.serialize(*this);
+}
+
+void SPrintfSizeSerializer::map_serialize_value(const ser::Serialize & value) {
+    value.serialize(*this);
+}
+
+void SPrintfSizeSerializer::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    key.serialize(*this);
+    value.serialize(*this);
+}
+
+void SPrintfSizeSerializer::map_end() {
+    // No-op
+}
+
+
+///
+/// Structs
+///
+
+void SPrintfSizeSerializer::struct_begin(serde::string_view, std::size_t len) {
+    add_length(len);
+}
+
+void SPrintfSizeSerializer::struct_serialize_field(serde::string_view name, const ser::Serialize & field) {
+    add_token(name.size());
+    field.serialize(*this);
+}
+
+void SPrintfSizeSerializer::struct_skip_field(serde::string_view) {
+    // No-op
+}
+
+void SPrintfSizeSerializer::struct_end() {
+    // No-op
+}
+
+}  // namespace serde_sprintf
+}  // namespace kingw
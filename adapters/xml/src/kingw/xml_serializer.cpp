@@ -1,6 +1,10 @@
 #include "kingw/xml_serializer.hpp"
 
 #include <cstring>
+#include <string>
+
+#include "kingw/serde/base64.hpp"
+#include "kingw/serde/exceptions.hpp"
 
 
 namespace kingw {
@@ -56,6 +60,69 @@ void XmlSerializer::serialize_string(serde::string_view value) {
     stream.write(value.data(), value.size());
 }
 
+void XmlSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+void XmlSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    for (std::size_t i = 0; i < len; ++i) {
+        stream << "<element>" << values[i] << "</element>";
+    }
+}
+
+void XmlSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    // Like xs:base64Binary. The base64 alphabet never needs escaping.
+    std::string encoded(serde::base64_encoded_size(len), '\0');
+    serde::base64_encode(data, len, &encoded[0]);
+    stream.write(encoded.data(), encoded.size());
+}
+
 
 ///
 /// Sequences 
@@ -80,7 +147,7 @@ void XmlSerializer::map_begin(std::size_t len) {
 }
 void XmlSerializer::map_serialize_key(const ser::Serialize & key) {
     if (!key.traits().is_string) {
-        throw XmlSerializationException("XmlSerializer map key is not a string");
+        KINGW_SERDE_THROW(XmlSerializationException("XmlSerializer map key is not a string"));
     }
     auto tag = serde_xml::to_string(key);
     stream << "<" << tag << ">";
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "kingw/serde/templates/stdvector.hpp"
+#include "kingw/serde/derive.hpp"
+#include "kingw/serde_json.hpp"
+#include "kingw/serde_sprintf.hpp"
+using namespace kingw;
+
+
+/// A struct made up entirely of basic types.
+struct Sample {
+    bool flag;
+    std::int8_t i8;
+    std::int16_t i16;
+    std::int32_t i32;
+    std::int64_t i64;
+    std::uint8_t u8;
+    std::uint16_t u16;
+    std::uint32_t u32;
+    std::uint64_t u64;
+    float f32;
+    double f64;
+};
+
+DERIVE_SERDE(Sample,
+    ("flag", &Self::flag)
+    ("i8",   &Self::i8)
+    ("i16",  &Self::i16)
+    ("i32",  &Self::i32)
+    ("i64",  &Self::i64)
+    ("u8",   &Self::u8)
+    ("u16",  &Self::u16)
+    ("u32",  &Self::u32)
+    ("u64",  &Self::u64)
+    ("f32",  &Self::f32)
+    ("f64",  &Self::f64));
+
+
+namespace {
+
+/// Run `fn` `iterations` times and return the average duration in microseconds.
+template <class Fn>
+double time_us(int iterations, Fn fn) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - begin).count() / iterations;
+}
+
+void report_trusted(const char* name, double validated_us, double trusted_us) {
+    std::cout << name << ": validated " << validated_us << " us, trusted "
+        << trusted_us << " us, speedup " << validated_us / trusted_us << "x\n";
+}
+
+}  // namespace
+
+
+int main() {
+    const std::size_t count = 10000;
+    const int iterations = 20;
+
+    std::vector<Sample> samples;
+    for (std::size_t i = 0; i < count; ++i) {
+        samples.push_back(Sample{ i % 2 == 0,
+            static_cast<std::int8_t>(i % 100), static_cast<std::int16_t>(i % 1000),
+            static_cast<std::int32_t>(i), static_cast<std::int64_t>(i) * 1000,
+            static_cast<std::uint8_t>(i % 200), static_cast<std::uint16_t>(i % 60000),
+            static_cast<std::uint32_t>(i), static_cast<std::uint64_t>(i) * 1000,
+            static_cast<float>(i) / 4, static_cast<double>(i) / 8 });
+    }
+
+    //
+    // SPrintf: a vector of structs, where every field is a basic type.
+    // Most of the time goes to splitting tokens, parsing numbers and
+    // matching field names, rather than to the visitors.
+    //
+    std::vector<char> buffer(count * 256);
+    char* end = serde_sprintf::to_buffer(samples, buffer.data(), buffer.data() + buffer.size());
+    serde::string_view input(buffer.data(), end - buffer.data());
+
+    std::vector<Sample> output;
+    double validated_us = time_us(iterations, [&]() {
+        output.clear();
+        serde_sprintf::SPrintfDeserializer deserializer(input);
+        de::deserialize(deserializer, output);
+    });
+
+    // The same, skipping validation. Only faster if the benchmarks are
+    // built with NDEBUG, or with KINGW_SERDE_VALIDATE_TRUSTED=OFF.
+    double trusted_us = time_us(iterations, [&]() {
+        output.clear();
+        serde_sprintf::SPrintfDeserializer deserializer(input);
+        deserializer.set_trusted(true);
+        de::deserialize(deserializer, output);
+    });
+    report_trusted("sprintf vector<Sample>", validated_us, trusted_us);
+
+    //
+    // JSON: one std::int32_t per JsonDeserializer, from an already-parsed array.
+    //
+    nlohmann::json numbers = nlohmann::json::array();
+    for (std::size_t i = 0; i < count * 10; ++i) {
+        numbers.push_back(static_cast<std::int32_t>(i));
+    }
+
+    std::int64_t sum = 0;
+    validated_us = time_us(iterations, [&]() {
+        for (const auto & number : numbers) {
+            std::int32_t value = 0;
+            serde_json::JsonDeserializer deserializer(number);
+            de::deserialize(deserializer, value);
+            sum += value;
+        }
+    });
+    trusted_us = time_us(iterations, [&]() {
+        for (const auto & number : numbers) {
+            std::int32_t value = 0;
+            serde_json::JsonDeserializer deserializer(number);
+            deserializer.set_trusted(true);
+            de::deserialize(deserializer, value);
+            sum += value;
+        }
+    });
+    report_trusted("json int32_t", validated_us, trusted_us);
+
+    //
+    // JSON: the same numbers as one std::vector<std::int32_t>,
+    // which are type and range checked in batches.
+    //
+    std::vector<std::int32_t> batch;
+    validated_us = time_us(iterations, [&]() {
+        batch.clear();
+        serde_json::JsonDeserializer deserializer(numbers);
+        de::deserialize(deserializer, batch);
+        sum += batch.size();
+    });
+    trusted_us = time_us(iterations, [&]() {
+        batch.clear();
+        serde_json::JsonDeserializer deserializer(numbers);
+        deserializer.set_trusted(true);
+        de::deserialize(deserializer, batch);
+        sum += batch.size();
+    });
+    report_trusted("json vector<int32_t>", validated_us, trusted_us);
+
+    return sum == 0;  // Keep the loops from being optimized away
+}
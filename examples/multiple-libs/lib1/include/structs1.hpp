@@ -1,5 +1,7 @@
 #pragma once
 
+#include "kingw/serde/declare.hpp"
+
 #include "structs2.hpp"
 
 
@@ -8,3 +10,5 @@ struct MyStruct {
     double value2;
     MyStruct2 s;
 };
+
+DECLARE_SERDE(MyStruct);
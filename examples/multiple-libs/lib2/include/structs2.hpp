@@ -3,7 +3,11 @@
 #include <vector>
 #include <string>
 
+#include "kingw/serde/declare.hpp"
+
 
 struct MyStruct2 {
     std::vector<std::string> contents;
 };
+
+DECLARE_SERDE(MyStruct2);
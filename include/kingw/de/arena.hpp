@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+
+#include "kingw/serde/memory_resource.hpp"
+
+#if KINGW_SERDE_PMR
+
+namespace kingw {
+namespace de {
+
+/// @brief Memory arena to deserialize a whole message into
+///
+/// Owns a `std::pmr::monotonic_buffer_resource`. Give `resource()` to
+/// the outermost `std::pmr` container, and every element deserialized
+/// into it (nested `std::pmr::vector`, `std::pmr::map`, and
+/// `std::pmr::string` included) allocates from the same arena:
+///
+/// ```
+/// de::ArenaScope arena;
+/// std::pmr::vector<std::pmr::string> names(arena.resource());
+/// serde_json::from_string(names, contents);
+/// ```
+///
+/// Allocation is a pointer bump, and deallocation does nothing. All of
+/// the memory is returned at once when the scope ends or `release()` is
+/// called, so everything deserialized into the arena must be destroyed
+/// (or no longer used) by then.
+///
+/// Not thread-safe, like the resource it wraps.
+class ArenaScope {
+public:
+    /// @brief ArenaScope Constructor
+    /// @param initial_size Size of the first block to allocate from
+    ///                     `upstream`, or 0 for the default.
+    ///                     Roughly the size of a typical message.
+    /// @param upstream Resource to allocate blocks from
+    explicit ArenaScope(
+        std::size_t initial_size = 0,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : arena(initial_size > 0
+            ? std::pmr::monotonic_buffer_resource(initial_size, upstream)
+            : std::pmr::monotonic_buffer_resource(upstream)) { }
+
+    /// @brief ArenaScope Constructor
+    ///
+    /// Allocates from `buffer` first, such as a stack array, and only
+    /// goes to `upstream` once it is full.
+    ///
+    /// @param buffer Memory to allocate from first. Must outlive the scope.
+    /// @param size Size of `buffer` in bytes
+    /// @param upstream Resource to allocate more blocks from
+    ArenaScope(
+        void* buffer,
+        std::size_t size,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : arena(buffer, size, upstream) { }
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope & operator=(const ArenaScope &) = delete;
+
+    /// @brief The arena, for constructing `std::pmr` containers
+    /// @return Resource that lives as long as this scope
+    std::pmr::memory_resource* resource() { return &arena; }
+
+    /// @brief Return all memory to `upstream` and start over
+    ///
+    /// Anything deserialized into the arena must already be destroyed.
+    void release() { arena.release(); }
+
+private:
+    /// @brief Resource that every allocation comes from
+    std::pmr::monotonic_buffer_resource arena;
+};
+
+}  // namespace de
+}  // namespace kingw
+
+#endif  // KINGW_SERDE_PMR
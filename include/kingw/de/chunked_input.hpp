@@ -0,0 +1,105 @@
+#pragma once
+
+#include <functional>
+
+#include "kingw/serde/fiber.hpp"
+#include "kingw/serde/string_view.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Input that arrives in chunks, for resumable deserialization
+///
+/// Deserializers normally need the whole input up front, so a reader
+/// has to buffer a complete message before it can start decoding it.
+/// A `ChunkedInput` instead runs the decode as soon as the first chunk
+/// arrives. When the deserializer runs out of bytes, it calls
+/// `next_chunk()`, which suspends the decode and returns from `feed()`.
+/// The next `feed()` resumes it where it left off. Decoding then
+/// overlaps with receiving, instead of starting after the last byte.
+///
+/// The decode runs on a `serde::Fiber`, so that it can suspend from
+/// anywhere inside nested visitors. Formats that support chunked input
+/// take a `ChunkedInput` in their constructor:
+///
+/// ```
+/// Example output;
+/// de::ChunkedInput input([&output](de::ChunkedInput & input) {
+///     serde_sprintf::SPrintfDeserializer deserializer(input);
+///     de::deserialize(deserializer, output);
+/// });
+/// while (!input.feed(receive_some_bytes())) { }
+/// ```
+///
+/// Errors thrown by the decode are thrown from `feed()` or `finish()`.
+/// Decode with `de::try_deserialize()` to keep them instead.
+///
+/// A chunk only has to stay valid until `feed()` returns. Formats copy
+/// the part of a chunk that they have not used yet before suspending.
+class ChunkedInput {
+public:
+    /// @brief Function that deserializes from the input
+    using Decode = std::function<void(ChunkedInput & input)>;
+
+    /// @brief Stack size used unless another is given to the constructor
+    constexpr static std::size_t DEFAULT_STACK_SIZE = serde::Fiber::DEFAULT_STACK_SIZE;
+
+    /// @brief ChunkedInput Constructor
+    ///
+    /// The decode does not start until the first call to `feed()`.
+    ///
+    /// @param decode Function that deserializes from this input
+    /// @param stack_size Size of the stack that `decode` runs on.
+    ///                   Deeply nested input needs more.
+    explicit ChunkedInput(Decode decode, std::size_t stack_size = DEFAULT_STACK_SIZE);
+
+    /// @brief ChunkedInput Destructor
+    ///
+    /// If the decode is still waiting for input, it is resumed as if
+    /// `finish()` was called, so that it can clean up. Its error is ignored.
+    ~ChunkedInput();
+
+    ChunkedInput(const ChunkedInput &) = delete;
+    ChunkedInput & operator=(const ChunkedInput &) = delete;
+
+    /// @brief Run the decode with the next chunk of input
+    ///
+    /// Returns once the decode has used the chunk and asks for more, or
+    /// once it has finished. Empty chunks are ignored. After the decode
+    /// has finished, chunks are ignored as well.
+    ///
+    /// @param chunk Next bytes of the input. Must stay valid until this returns.
+    /// @return True once the decode has finished
+    bool feed(serde::string_view chunk);
+
+    /// @brief Signal the end of the input, and run the decode to completion
+    ///
+    /// The decode gets an empty chunk from now on, which formats treat
+    /// like the end of a complete buffer.
+    void finish();
+
+    /// @brief Whether the decode has finished
+    /// @return True once the decode has returned or thrown
+    bool done() const;
+
+    /// @brief Get the next chunk of input, suspending until there is one
+    ///
+    /// Called by formats from inside the decode only.
+    ///
+    /// @return The next chunk, or an empty view at the end of the input
+    serde::string_view next_chunk();
+
+private:
+    /// @brief Runs the decode
+    serde::Fiber fiber;
+
+    /// @brief Chunk given to `feed()` that `next_chunk()` has not returned yet
+    serde::string_view chunk;
+
+    /// @brief Whether `finish()` was called
+    bool ended;
+};
+
+}  // namespace de
+}  // namespace kingw
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "kingw/de/deserializer.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Deserialize over an existing value, reusing its storage
+///
+/// Same as `de::deserialize<T>()`, except that containers are
+/// overwritten instead of appended to. Vectors overwrite their
+/// existing elements and then shrink or grow to fit, strings reuse
+/// their capacity, and maps deserialize into the nodes of keys they
+/// already have. A loop that decodes messages of the same shape into
+/// the same object therefore stops allocating after the first one.
+///
+/// Like `de::try_deserialize()`, this must be included after the
+/// templates for `std::vector` etc. so that it can find their overloads.
+///
+/// `deserializer.in_place()` is turned on for the duration of the call.
+///
+/// @tparam T Type of object to deserialize
+/// @param deserializer Deserializer to extract from
+/// @param output Existing value to deserialize over
+template <class T>
+void deserialize_in_place(Deserializer & deserializer, T & output) {
+    struct Restore {
+        Deserializer & deserializer;
+        bool in_place;
+        ~Restore() { deserializer.set_in_place(in_place); }
+    } restore{ deserializer, deserializer.in_place() };
+
+    deserializer.set_in_place(true);
+    de::deserialize(deserializer, output);
+}
+
+}  // namespace de
+}  // namespace kingw
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "kingw/de/deserializer.hpp"
+#include "kingw/de/field_mask.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Deserialize only the selected fields of a struct
+///
+/// Same as `de::deserialize<T>()`, except that the fields of the struct
+/// named `mask.struct_name()` that are not selected in `mask` are skipped,
+/// wherever that struct appears in `output`. Skipped fields are left as
+/// they were. See `de::FieldMask`.
+///
+/// Like `de::try_deserialize()`, this must be included after the
+/// templates for `std::vector` etc. so that it can find their overloads.
+///
+/// `deserializer.field_mask()` is set to `mask` for the duration of the call.
+///
+/// @tparam T Type of object to deserialize
+/// @param deserializer Deserializer to extract from
+/// @param output Value to deserialize into
+/// @param mask Fields to deserialize
+template <class T>
+void deserialize_projected(Deserializer & deserializer, T & output, const FieldMask & mask) {
+    struct Restore {
+        Deserializer & deserializer;
+        const FieldMask* field_mask;
+        ~Restore() { deserializer.set_field_mask(field_mask); }
+    } restore{ deserializer, deserializer.field_mask() };
+
+    deserializer.set_field_mask(&mask);
+    de::deserialize(deserializer, output);
+}
+
+}  // namespace de
+}  // namespace kingw
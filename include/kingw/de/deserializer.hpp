@@ -1,22 +1,118 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 #include "kingw/de/deserialize.hpp"
+#include "kingw/de/field_mask.hpp"
+#include "kingw/serde/exceptions.hpp"
 #include "kingw/serde/string_view.hpp"
 
 
+/// @brief Whether trusted deserializers validate their input anyway
+///
+/// Defined to 1 when `NDEBUG` is not defined, so that debug builds keep
+/// reporting malformed input even where `Deserializer::set_trusted()`
+/// was called. Define it to 0 or 1 beforehand (or with the CMake option
+/// `KINGW_SERDE_VALIDATE_TRUSTED`) to choose regardless of the build type.
+/// It is read when the library itself is compiled.
+#if !defined(KINGW_SERDE_VALIDATE_TRUSTED)
+#if defined(NDEBUG)
+#define KINGW_SERDE_VALIDATE_TRUSTED 0
+#else
+#define KINGW_SERDE_VALIDATE_TRUSTED 1
+#endif
+#endif
+
+
 namespace kingw {
 namespace de {
 
+/// @brief Kind of problem that stopped deserialization
+enum class ErrorCode {
+    None = 0,        ///< No error
+    InvalidType,     ///< The input has a different type than was requested
+    InvalidValue,    ///< The input has the right type, but a value that doesn't fit
+    InvalidLength,   ///< A string, sequence, or struct has the wrong number of items
+    UnknownField,    ///< A struct has a field that the output does not have
+    EndOfInput,      ///< There is nothing left to read
+    Syntax,          ///< The input is malformed
+    NotImplemented,  ///< The Visitor or Deserializer does not support this
+    Custom,          ///< Anything else
+};
+
+/// @brief A deserialization error that can be reported without throwing
+///
+/// Returned by `de::try_deserialize()`. Converts to true if there was an error.
+struct Error {
+    /// @brief Error Constructor. Not an error.
+    Error() = default;
+
+    /// @brief Error Constructor
+    /// @param code Kind of error
+    /// @param message Cause of the error. Always a string literal.
+    /// @param path Location of the error in the input
+    Error(ErrorCode code, const char* message, std::string path = std::string())
+        : code(code), message(message), path(std::move(path)) { }
+
+    /// @brief Kind of error, or `ErrorCode::None`
+    ErrorCode code = ErrorCode::None;
+
+    /// @brief Cause of the error. Always a string literal.
+    const char* message = "";
+
+    /// @brief Location of the error in the input, such as `orders[17].price`
+    ///
+    /// Empty if the error is at the top level, or if the format
+    /// does not track locations. See `Deserializer::deserialize_at()`.
+    std::string path;
+
+    /// @brief Whether this is an error
+    /// @return False if `code` is `ErrorCode::None`
+    explicit operator bool() const { return code != ErrorCode::None; }
+};
+
 /// @brief Common exception class that should be used for deserialization exceptions
 class DeserializationException : public std::runtime_error {
 public:
     /// @brief DeserializationException Constructor
     /// @param message Cause of the exception
-    explicit DeserializationException(serde::string_view message);
+    /// @param code Kind of error
+    explicit DeserializationException(serde::string_view message, ErrorCode code = ErrorCode::Custom);
+
+    /// @brief Kind of error
+    /// @return The `ErrorCode` this exception was constructed with
+    ErrorCode code() const;
+
+    /// @brief Location of the error in the input, such as `orders[17].price`
+    /// @return The path, or an empty string if it is not known
+    const std::string & path() const;
+
+    /// @brief Cause of the exception, prefixed by `path()` if there is one
+    /// @return For example, `"orders[17].price: json value was not a number"`
+    const char* what() const noexcept override;
+
+    /// @brief Add a sequence index to the start of `path()`
+    ///
+    /// Called while the exception propagates out of each level of the
+    /// input, so that the path is only built for inputs that fail.
+    ///
+    /// @param index Index of the element that failed
+    void add_path(std::size_t index);
+
+    /// @brief Add a struct field name or map key to the start of `path()`
+    /// @see add_path(std::size_t)
+    /// @param key Name of the field that failed
+    void add_path(serde::string_view key);
+
+private:
+    ErrorCode code_;
+    std::string path_;
+    std::string what_;  // path_ and the message, once path_ is not empty
 };
 
 // Forward-declare from later in this file
@@ -97,9 +193,159 @@ public:
         Iterator end_;
     };
 
+    /// @brief Returned by `size_hint()` when the length is not known
+    constexpr static std::size_t UNKNOWN_LENGTH = -1;
+
+    /// @brief Deserializer Constructor
+    Deserializer();
+
+    /// @brief Deserializer Copy Constructor
+    ///
+    /// The copy starts out with the same error state and settings, but
+    /// they are not shared. Use `report_to()` to share them.
+    Deserializer(const Deserializer & other);
+
+    /// @brief Deserializer Copy Assignment
+    /// @see Deserializer(const Deserializer &)
+    Deserializer & operator=(const Deserializer & other);
+
     /// @brief Deserializer Destructor
     virtual ~Deserializer() = default;
 
+    /// @brief Report a deserialization error
+    ///
+    /// Anything that finds a problem with the input (this deserializer,
+    /// its `SeqAccess` and `MapAccess`, and the visitors given to it)
+    /// reports it here instead of throwing directly.
+    ///
+    /// If `throw_on_error()` is true, which is the default, this throws
+    /// the error as a `DeserializationException`. See `raise()`.
+    ///
+    /// Otherwise, the first error is kept in `error()` and later errors
+    /// are ignored. The caller must return normally, and the rest of
+    /// the deserialization winds down without doing any more work:
+    /// `has_next()` returns false and nothing else is written to the
+    /// output. Whatever was already written to the output is unspecified.
+    ///
+    /// @param code Kind of error
+    /// @param message Cause of the error. Must be a string literal.
+    void fail(ErrorCode code, const char* message);
+
+    /// @brief Whether an error has been reported while not throwing
+    /// @return True if `error()` holds an error
+    bool failed() const;
+
+    /// @brief The first error reported while not throwing
+    /// @return The first error, or an `Error` with `ErrorCode::None`
+    const Error & error() const;
+
+    /// @brief Whether `fail()` throws an exception
+    /// @return True by default
+    bool throw_on_error() const;
+
+    /// @brief Choose whether `fail()` throws or records errors
+    ///
+    /// `de::try_deserialize()` turns this off for the duration of the call.
+    ///
+    /// @param enabled True to throw, false to record
+    void set_throw_on_error(bool enabled);
+
+    /// @brief Whether containers are deserialized in place
+    ///
+    /// When true, `std::vector`, `std::map`, and `std::unordered_map`
+    /// overwrite their existing elements, reusing their storage, and
+    /// then drop any elements that were not in the input. Otherwise,
+    /// they append or insert into what is already there.
+    ///
+    /// @return False by default
+    /// @see de::deserialize_in_place()
+    bool in_place() const;
+
+    /// @brief Choose whether containers are deserialized in place
+    ///
+    /// `de::deserialize_in_place()` turns this on for the duration of the call.
+    ///
+    /// @param enabled True to reuse existing elements, false to append
+    void set_in_place(bool enabled);
+
+    /// @brief Whether the input is trusted to be well-formed
+    ///
+    /// When true, formats and the default visitors skip checks that only
+    /// fail on malformed input, such as type checks, range checks, and
+    /// delimiter checks. Use this for data that this program serialized
+    /// itself. Malformed input is then no longer reported reliably:
+    /// numbers that don't fit are truncated, and values of the wrong type
+    /// are converted however the format happens to convert them.
+    ///
+    /// Always false when `KINGW_SERDE_VALIDATE_TRUSTED` is 1.
+    ///
+    /// @return False by default
+    bool trusted() const;
+
+    /// @brief Choose whether the input is trusted to be well-formed
+    /// @param enabled True to skip validation, false to validate
+    void set_trusted(bool enabled);
+
+    /// @brief Fields to deserialize, for one struct
+    ///
+    /// When set, `DERIVE_DESERIALIZE()` structs named
+    /// `field_mask()->struct_name()` skip every field that is not
+    /// selected, leaving it unchanged in the output.
+    ///
+    /// @return Nullptr by default, meaning every field
+    /// @see de::deserialize_projected()
+    const FieldMask* field_mask() const;
+
+    /// @brief Choose which fields of a struct to deserialize
+    ///
+    /// `de::deserialize_projected()` sets this for the duration of the call.
+    ///
+    /// @param mask Fields to deserialize, or nullptr for all of them.
+    ///             Must outlive its use by this deserializer.
+    void set_field_mask(const FieldMask* mask);
+
+    /// @brief Share the error state and settings of another deserializer
+    ///
+    /// A deserializer that creates nested deserializers (such as one
+    /// per element) uses this so that errors in the nested ones end up
+    /// in the same place, and follow the same `throw_on_error()`,
+    /// `in_place()`, `trusted()`, and `field_mask()` settings.
+    ///
+    /// @param parent Deserializer whose error state to share.
+    ///               Must outlive this deserializer.
+    void report_to(Deserializer & parent);
+
+    /// @brief Add a sequence index to the start of `error().path`
+    ///
+    /// Does nothing unless an error has been recorded. Adds to the
+    /// path of a failure while not throwing, like
+    /// `DeserializationException::add_path()` does while throwing.
+    ///
+    /// @param index Index of the element that failed
+    void add_error_path(std::size_t index);
+
+    /// @brief Add a struct field name or map key to the start of `error().path`
+    /// @see add_error_path(std::size_t)
+    /// @param key Name of the field that failed
+    void add_error_path(serde::string_view key);
+
+    /// @brief Deserialize an element of a sequence from this deserializer
+    ///
+    /// Same as `output.deserialize(*this)`, except that if it fails,
+    /// `index` is added to the error path, whether the error is thrown
+    /// or recorded. `SeqAccess` implementations use this so that errors
+    /// can say where they are. Nothing extra is done if it succeeds.
+    ///
+    /// @param index Index of the element in its sequence
+    /// @param output Output location
+    void deserialize_at(std::size_t index, de::Deserialize & output);
+
+    /// @brief Deserialize a struct field or map value from this deserializer
+    /// @see deserialize_at(std::size_t, de::Deserialize &)
+    /// @param key Name of the field or key of the entry
+    /// @param output Output location
+    void deserialize_at(serde::string_view key, de::Deserialize & output);
+
     /// @brief Whether this deserializes from a readable format.
     ///
     /// This refers to the format of the string contents (for example)
@@ -154,6 +400,33 @@ public:
         const FieldNames & field_names, 
         de::Visitor & visitor) = 0;
 
+    /// @brief Deserialize a blob of bytes
+    ///
+    /// Binary formats can give the visitor their raw bytes through
+    /// `Visitor::visit_bytes()`. Text formats can decode them first,
+    /// for example from base64.
+    ///
+    /// The default implementation calls `deserialize_seq()`, so the
+    /// blob is read like a sequence of `std::uint8_t`.
+    ///
+    /// @param visitor Handles the deserialized value
+    virtual void deserialize_bytes(de::Visitor & visitor);
+
+    /// @brief Skip over the next value, whatever its type
+    ///
+    /// Used by `de::deserialize<de::IgnoredAny>()` for input that the
+    /// output has nowhere to put, such as unknown struct fields.
+    ///
+    /// Formats should override this to skip the value structurally,
+    /// without materializing or allocating anything. They do not have
+    /// to call the visitor at all.
+    ///
+    /// The default implementation calls `deserialize_any()`, so the
+    /// value is given to the visitor, which then ignores it.
+    ///
+    /// @param visitor Handles the deserialized value, if it is visited
+    virtual void deserialize_ignored_any(de::Visitor & visitor);
+
     /// @brief Provides a Visitor access to each element of a sequence
     ///
     /// This is an abstract, untyped representation of a list/sequence
@@ -180,6 +453,18 @@ public:
         /// @return True/False if this abstract list has more elements
         virtual bool has_next() = 0;
 
+        /// @brief Number of elements remaining in this abstract list, if known
+        ///
+        /// Visitors use this to reserve space for the whole list up front.
+        /// It is only a hint. A visitor must still stop when `has_next()`
+        /// returns false, and should not trust a huge hint from untrusted
+        /// input. See `de::cautious_size_hint()`.
+        ///
+        /// The default implementation returns `UNKNOWN_LENGTH`.
+        ///
+        /// @return Number of elements remaining, or `UNKNOWN_LENGTH`
+        virtual std::size_t size_hint() const;
+
         /// @brief Requests to deserialize the next element in the list
         ///
         /// The `Deserialize` element parameter knows how to deserialize
@@ -188,6 +473,63 @@ public:
         ///
         /// @param element Output location
         virtual void next_element(de::Deserialize & element) = 0;
+
+        /// @brief Requests to deserialize up to `len` basic values at once
+        ///
+        /// Fills `output` with the next elements of the list, stopping
+        /// early if the list runs out. The values are converted exactly
+        /// as `de::deserialize<T>()` would convert a single element.
+        ///
+        /// The default implementations call `next_element()` once per
+        /// element. A `Deserializer` that knows the layout of its list
+        /// can override these to parse a whole batch in a tight loop,
+        /// without a `Visitor` or `Accessor` per element.
+        ///
+        /// `de::next_elements()` picks the right function by type.
+        ///
+        /// @param output Output location of at least `len` elements
+        /// @param len Maximum number of elements to deserialize
+        /// @return Number of elements deserialized into `output`. If an
+        ///         element fails without throwing, it is not counted and
+        ///         the batch stops there.
+        virtual std::size_t next_bool_elements(bool* output, std::size_t len);
+        virtual std::size_t next_i8_elements(std::int8_t* output, std::size_t len);
+        virtual std::size_t next_i16_elements(std::int16_t* output, std::size_t len);
+        virtual std::size_t next_i32_elements(std::int32_t* output, std::size_t len);
+        virtual std::size_t next_i64_elements(std::int64_t* output, std::size_t len);
+        virtual std::size_t next_u8_elements(std::uint8_t* output, std::size_t len);
+        virtual std::size_t next_u16_elements(std::uint16_t* output, std::size_t len);
+        virtual std::size_t next_u32_elements(std::uint32_t* output, std::size_t len);
+        virtual std::size_t next_u64_elements(std::uint64_t* output, std::size_t len);
+        virtual std::size_t next_f32_elements(float* output, std::size_t len);
+        virtual std::size_t next_f64_elements(double* output, std::size_t len);
+
+        /// @brief Report errors to `deserializer` instead of throwing them
+        ///
+        /// A `Deserializer` calls this on the `SeqAccess` it creates so
+        /// that generic code, like `DERIVE_SERDE()`, can report problems
+        /// with the sequence through `fail()`.
+        ///
+        /// @param deserializer Deserializer to report to. Must outlive this.
+        void report_to(Deserializer & deserializer);
+
+        /// @brief Report a deserialization error
+        ///
+        /// Calls `Deserializer::fail()` on the deserializer given to
+        /// `report_to()`, or throws a `DeserializationException` if there
+        /// isn't one.
+        ///
+        /// @param code Kind of error
+        /// @param message Cause of the error. Must be a string literal.
+        void fail(ErrorCode code, const char* message);
+
+        /// @brief Whether the deserializer given to `report_to()` has failed
+        /// @return `Deserializer::failed()`, or false if there isn't one
+        bool failed() const;
+
+    private:
+        /// @brief Where errors are reported, or nullptr to throw them
+        Deserializer* reporter = nullptr;
     };
 
     /// @brief Provides a Visitor access to each element of a map
@@ -216,6 +558,16 @@ public:
         /// @return True/False if this abstract map has more entries
         virtual bool has_next() = 0;
 
+        /// @brief Number of entries remaining in this abstract map, if known
+        ///
+        /// Visitors use this to reserve space for the whole map up front.
+        /// It is only a hint. See `SeqAccess::size_hint()`.
+        ///
+        /// The default implementation returns `UNKNOWN_LENGTH`.
+        ///
+        /// @return Number of entries remaining, or `UNKNOWN_LENGTH`
+        virtual std::size_t size_hint() const;
+
         /// @brief Requests to deserialize the key for the current map entry
         ///
         /// The `Deserialize` key parameter knows how to deserialize
@@ -255,7 +607,51 @@ public:
         /// @param key Output location
         /// @param value Output location
         virtual void next_entry(de::Deserialize & key, de::Deserialize & value) = 0;
+
+        /// @brief Report errors to `deserializer` instead of throwing them
+        /// @see SeqAccess::report_to()
+        /// @param deserializer Deserializer to report to. Must outlive this.
+        void report_to(Deserializer & deserializer);
+
+        /// @brief Report a deserialization error
+        /// @see SeqAccess::fail()
+        /// @param code Kind of error
+        /// @param message Cause of the error. Must be a string literal.
+        void fail(ErrorCode code, const char* message);
+
+    private:
+        /// @brief Where errors are reported, or nullptr to throw them
+        Deserializer* reporter = nullptr;
     };
+
+protected:
+    /// @brief Throw an error reported to `fail()` while `throw_on_error()`
+    ///
+    /// The default implementation throws `Visitor::NotImplementedException`
+    /// for `ErrorCode::NotImplemented`, and `DeserializationException`
+    /// for everything else. A format can override this to throw its own
+    /// exception class, as long as it derives from those.
+    ///
+    /// When exceptions are disabled, this calls `std::abort()` instead.
+    ///
+    /// @param error Error to throw
+    virtual void raise(const Error & error);
+
+private:
+    /// @brief Errors and settings shared by a deserializer and everything it reports to
+    struct SharedState {
+        Error error;
+        bool throw_on_error = true;
+        bool in_place = false;
+        bool trusted = false;
+        const FieldMask* field_mask = nullptr;
+    };
+
+    /// @brief State used unless `report_to()` shares another one
+    SharedState own_state;
+
+    /// @brief Either `own_state` or the parent's
+    SharedState* state;
 };
 
 /// @brief Base class for a visitor that analyzes `Deserializer` results.
@@ -330,8 +726,71 @@ public:
     virtual void visit_f64(double value);
     virtual void visit_char(char value);
     virtual void visit_string(serde::string_view value);
+
+    /// @brief Visit a string that is borrowed from the deserializer's input
+    ///
+    /// `visit_string()` may be given a transient string, such as a buffer
+    /// that is overwritten as soon as the call returns. A visitor that
+    /// wants to keep the string must copy it.
+    ///
+    /// A `Deserializer` calls `visit_borrowed_string()` instead when the
+    /// string points directly into its input data, and so stays valid for
+    /// as long as that input does. A visitor may keep the `string_view`
+    /// without copying it, like the `StringViewVisitor` used by
+    /// `de::deserialize<serde::string_view>()`.
+    ///
+    /// The default implementation calls `visit_string()`, so visitors that
+    /// copy strings anyway do not need to implement this.
+    ///
+    /// @param value Deserialized value from the deserializer
+    virtual void visit_borrowed_string(serde::string_view value);
+
+    /// @brief Visit a blob of bytes
+    ///
+    /// Like `visit_string()`, the bytes may be transient, so a visitor
+    /// that wants to keep them must copy them.
+    ///
+    /// @param data Deserialized bytes from the deserializer
+    /// @param len Number of bytes
+    virtual void visit_bytes(const std::uint8_t* data, std::size_t len);
+
+    /// @brief Visit a value that has no content, such as JSON `null`
+    ///
+    /// Only `Deserializer::deserialize_any()` produces this, for
+    /// self-describing formats that have such a value.
+    virtual void visit_unit();
+
     virtual void visit_seq(de::Deserializer::SeqAccess & value);
     virtual void visit_map(de::Deserializer::MapAccess & value);
+
+    /// @brief Report errors to `deserializer` instead of throwing them
+    ///
+    /// The default `de::deserialize<T>()` implementations call this with
+    /// the deserializer they were given, so that their visitors respect
+    /// `Deserializer::throw_on_error()`. Custom visitors should do the same.
+    /// A visitor that never reports to a deserializer always throws.
+    ///
+    /// @param deserializer Deserializer to report to. Must outlive this.
+    void report_to(Deserializer & deserializer);
+
+protected:
+    /// @brief Report a deserialization error
+    ///
+    /// Calls `Deserializer::fail()` on the deserializer given to
+    /// `report_to()`, or throws a `DeserializationException` if there
+    /// isn't one. Return normally afterwards without writing the output.
+    ///
+    /// @param code Kind of error
+    /// @param message Cause of the error. Must be a string literal.
+    void fail(ErrorCode code, const char* message);
+
+    /// @brief Whether the deserializer given to `report_to()` is trusted
+    /// @return `Deserializer::trusted()`, or false if there isn't one
+    bool trusted() const;
+
+private:
+    /// @brief Where errors are reported, or nullptr to throw them
+    Deserializer* reporter = nullptr;
 };
 
 
@@ -380,5 +839,93 @@ Accessor<T> accessor(T & output) {
     return Accessor<T>(output);
 }
 
+/// @brief Deserialize up to `len` elements of a sequence into an array.
+///
+/// This generic version deserializes each element individually
+/// through `seq.next_element()`. Arrays of basic types instead pick
+/// one of the non-template overloads below, which hand the entire
+/// array to the matching `SeqAccess::next_*_elements()` function.
+///
+/// @tparam T Type of element to deserialize
+/// @param seq Sequence to extract from
+/// @param output Output location of at least `len` elements
+/// @param len Maximum number of elements to deserialize
+/// @return Number of elements deserialized into `output`. An element
+///         that failed without throwing is not counted.
+template <class T>
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, T* output, std::size_t len) {
+    std::size_t count = 0;
+    while (count < len && seq.has_next()) {
+        de::Accessor<T> accessor(output[count]);
+        seq.next_element(accessor);
+        if (seq.failed()) {
+            break;
+        }
+        ++count;
+    }
+    return count;
+}
+
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, bool* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::int8_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::int16_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::int32_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::int64_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::uint8_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::uint16_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::uint32_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, std::uint64_t* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, float* output, std::size_t len);
+std::size_t next_elements(de::Deserializer::SeqAccess & seq, double* output, std::size_t len);
+
+/// @brief Number of elements worth reserving for a `size_hint()`.
+///
+/// A hint comes from the input data, so a malformed or hostile input
+/// could claim billions of elements and make a visitor allocate far more
+/// memory than the input could ever fill. This caps the reservation at
+/// about 1 MiB of elements. Anything beyond that grows as it is read.
+///
+/// @tparam T Type of element to reserve space for
+/// @param hint Result of `size_hint()`
+/// @return Number of elements to reserve, or 0 if the length is unknown
+template <class T>
+std::size_t cautious_size_hint(std::size_t hint) {
+    constexpr std::size_t max_bytes = 1024 * 1024;
+    constexpr std::size_t max_elements = max_bytes / sizeof(T) > 0 ? max_bytes / sizeof(T) : 1;
+    if (hint == de::Deserializer::UNKNOWN_LENGTH) {
+        return 0;
+    }
+    return hint < max_elements ? hint : max_elements;
+}
+
+/// @brief Construct a temporary that uses a container's allocator
+///
+/// Visitors deserialize map keys and values into temporaries before
+/// moving them into the container. If the element type is allocator
+/// aware, like `std::pmr::string`, the temporary has to use the same
+/// memory as the container. Otherwise it would allocate from the
+/// default resource, and the move would copy everything again.
+///
+/// @tparam T Type to construct
+/// @tparam Alloc Allocator of the container, which `T` may rebind
+/// @param allocator Result of `get_allocator()`
+/// @return `T(allocator)` if `T` uses `Alloc`, otherwise `T{}`
+template <class T, class Alloc>
+typename std::enable_if<std::uses_allocator<T, Alloc>::value
+    && std::is_constructible<T, const Alloc &>::value, T>::type
+construct_with_allocator(const Alloc & allocator) {
+    return T(allocator);
+}
+
+/// @brief Construct a temporary that does not use an allocator
+///
+/// @see construct_with_allocator()
+template <class T, class Alloc>
+typename std::enable_if<!(std::uses_allocator<T, Alloc>::value
+    && std::is_constructible<T, const Alloc &>::value), T>::type
+construct_with_allocator(const Alloc &) {
+    return T{};
+}
+
 }  // namespace de
 }  // namespace kingw
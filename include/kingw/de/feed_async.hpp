@@ -0,0 +1,150 @@
+#pragma once
+
+#include "kingw/de/chunked_input.hpp"
+#include "kingw/serde/exceptions.hpp"
+
+// Only available when compiled as C++20 with coroutines.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define KINGW_SERDE_COROUTINES 1
+#else
+#define KINGW_SERDE_COROUTINES 0
+#endif
+
+#if KINGW_SERDE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Coroutine returned by `de::feed_async()`
+///
+/// Does nothing until it is awaited. `co_await` resumes the awaiting
+/// coroutine once the decode has finished, and throws its error, if any.
+class AsyncFeed {
+public:
+    struct promise_type {
+        AsyncFeed get_return_object() {
+            return AsyncFeed(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            // Resume the awaiting coroutine directly, without growing the stack.
+            struct Continue {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                    const std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+                void await_resume() noexcept { }
+            };
+            return Continue{};
+        }
+
+        void return_void() { }
+
+        void unhandled_exception() {
+#if KINGW_SERDE_EXCEPTIONS
+            exception = std::current_exception();
+#else
+            std::terminate();
+#endif
+        }
+
+        std::coroutine_handle<> continuation;
+#if KINGW_SERDE_EXCEPTIONS
+        std::exception_ptr exception;
+#endif
+    };
+
+    AsyncFeed(AsyncFeed && other) noexcept
+        : handle(std::exchange(other.handle, nullptr)) { }
+
+    ~AsyncFeed() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    AsyncFeed(const AsyncFeed &) = delete;
+    AsyncFeed & operator=(const AsyncFeed &) = delete;
+    AsyncFeed & operator=(AsyncFeed &&) = delete;
+
+    bool await_ready() const noexcept {
+        return handle.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    void await_resume() {
+#if KINGW_SERDE_EXCEPTIONS
+        if (handle.promise().exception) {
+            std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+        }
+#endif
+    }
+
+private:
+    explicit AsyncFeed(std::coroutine_handle<promise_type> handle)
+        : handle(handle) { }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/// @brief Feed a `ChunkedInput` from an asynchronous byte source
+///
+/// Lets a coroutine decode straight from a non-blocking socket or pipe.
+/// Each chunk is awaited with `co_await source.next_chunk()`, which must
+/// give something convertible to `serde::string_view`, such as a view
+/// or a `std::string`. An empty chunk is the end of the input, like
+/// `read()` returning 0. The chunk is fed to `input` as it is, so a view
+/// only has to stay valid until the next `co_await`; formats copy the
+/// part that they have not used yet.
+///
+/// ```
+/// Example output;
+/// de::ChunkedInput input([&output](de::ChunkedInput & input) {
+///     serde_sprintf::SPrintfDeserializer deserializer(input);
+///     de::deserialize(deserializer, output);
+/// });
+/// co_await de::feed_async(input, connection);
+/// ```
+///
+/// The decode itself runs synchronously inside each `feed()`, on the
+/// `ChunkedInput`'s fiber, so visitors and formats don't change. Only
+/// the waiting for input is asynchronous. Errors from the decode or the
+/// source are thrown from the `co_await`.
+///
+/// The source's awaitable has to accept any `std::coroutine_handle<>`.
+/// Only available when compiled as C++20; see `KINGW_SERDE_COROUTINES`.
+///
+/// @tparam Source Type of the byte source
+/// @param input Input to feed. Must outlive the returned `AsyncFeed`.
+/// @param source Source of the chunks. Must outlive the returned `AsyncFeed`.
+/// @return Coroutine that finishes once the decode has finished
+template <class Source>
+AsyncFeed feed_async(ChunkedInput & input, Source & source) {
+    while (!input.done()) {
+        // Keep an owning chunk, such as a std::string, alive while it is fed.
+        auto && data = co_await source.next_chunk();
+        const serde::string_view chunk(data);
+        if (chunk.size() == 0) {
+            input.finish();
+        } else {
+            input.feed(chunk);
+        }
+    }
+}
+
+}  // namespace de
+}  // namespace kingw
+
+#endif  // KINGW_SERDE_COROUTINES
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "kingw/serde/string_view.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Set of fields of one struct to deserialize
+///
+/// Many consumers only need a few fields of a large message. Give a
+/// `FieldMask` to `de::deserialize_projected()` and `DERIVE_DESERIALIZE()`
+/// structs with a matching name deserialize only the selected fields.
+/// The other fields are skipped without being parsed where the format
+/// allows it, and are left as they were in the output.
+///
+/// Fields are selected by `field_number`: the one-based position of the
+/// field in `DERIVE_SERDE()`. For example, with
+///   DERIVE_SERDE(Example,
+///     ("foo", &Self::foo)    // field_number 1
+///     ("bar", &Self::bar));  // field_number 2
+/// then `FieldMask("Example").select(2)` deserializes only "bar".
+///
+/// The mask applies to every struct with the same name, however deep
+/// it is nested, and to no other struct.
+class FieldMask {
+public:
+    /// @brief FieldMask Constructor. No fields are selected.
+    /// @param struct_name Name of the struct, as given to `DERIVE_SERDE()`.
+    ///                    Must outlive this mask.
+    explicit FieldMask(serde::string_view struct_name)
+        : name(struct_name) {}
+
+    /// @brief Name of the struct that this mask applies to
+    /// @return Name given to the constructor
+    serde::string_view struct_name() const {
+        return name;
+    }
+
+    /// @brief Select a field to be deserialized
+    /// @param field_number One-based position of the field
+    /// @return This mask, to chain calls
+    FieldMask & select(std::size_t field_number) {
+        const std::size_t word = field_number / 64;
+        if (word >= words.size()) {
+            words.resize(word + 1, 0);
+        }
+        words[word] |= std::uint64_t{ 1 } << (field_number % 64);
+        return *this;
+    }
+
+    /// @brief Whether a field is selected
+    /// @param field_number One-based position of the field
+    /// @return True if `select(field_number)` was called
+    bool selected(std::size_t field_number) const {
+        const std::size_t word = field_number / 64;
+        return word < words.size() && (words[word] >> (field_number % 64)) & 1;
+    }
+
+private:
+    /// @brief Name of the struct that this mask applies to
+    serde::string_view name;
+
+    /// @brief One bit per `field_number`
+    std::vector<std::uint64_t> words;
+};
+
+}  // namespace de
+}  // namespace kingw
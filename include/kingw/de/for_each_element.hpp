@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "kingw/de/deserializer.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Visitor for `de::for_each_element()`
+///
+/// @tparam T Type of each element
+/// @tparam F Callback, called with a `T &`
+template <class T, class F>
+class ForEachElementVisitor : public de::Visitor {
+public:
+    /// @brief ForEachElementVisitor Constructor
+    /// @param deserializer Deserializer the sequence comes from
+    /// @param callback Called with each element
+    ForEachElementVisitor(de::Deserializer & deserializer, F & callback)
+        : deserializer(deserializer), callback(callback) { }
+
+    /// @brief Explanation of what this Visitor is expecting
+    /// @return A string literal
+    const char* expecting() const override { return "a sequence of items"; }
+
+    /// @brief Deserialize each element into the same `T`, and hand it
+    /// to the callback before deserializing the next one.
+    ///
+    /// Basic types are read in batches with `de::next_elements()`,
+    /// like `std::vector` does, into a small buffer on the stack.
+    ///
+    /// @param seq Data from `Deserializer`
+    void visit_seq(de::Deserializer::SeqAccess & seq) override {
+        visit_elements(seq, std::is_arithmetic<T>());
+    }
+
+    /// @brief Number of elements given to the callback
+    std::size_t count = 0;
+
+private:
+    void visit_elements(de::Deserializer::SeqAccess & seq, std::false_type) {
+        T element{};
+        de::Accessor<T> accessor(element);
+        while (seq.has_next()) {
+            seq.next_element(accessor);
+            if (deserializer.failed()) {
+                return;
+            }
+            callback(element);
+            ++count;
+        }
+    }
+
+    void visit_elements(de::Deserializer::SeqAccess & seq, std::true_type) {
+        constexpr std::size_t BATCH = 64;
+        T elements[BATCH];
+        while (seq.has_next()) {
+            // The elements read before a failure are still good.
+            const std::size_t len = de::next_elements(seq, elements, BATCH);
+            for (std::size_t i = 0; i < len; ++i) {
+                callback(elements[i]);
+            }
+            count += len;
+            if (deserializer.failed()) {
+                return;
+            }
+        }
+    }
+
+    de::Deserializer & deserializer;
+    F & callback;
+};
+
+/// @brief Deserialize a sequence one element at a time
+///
+/// Instead of collecting the whole sequence into a `std::vector<T>`,
+/// every element is deserialized into the same `T`, which is then
+/// given to `callback` before the next one is read. The memory used
+/// does not depend on the length of the sequence:
+///
+/// ```
+/// std::size_t total = 0;
+/// de::for_each_element<Row>(deserializer, [&](Row & row) {
+///     total += row.amount;
+/// });
+/// ```
+///
+/// Each element is deserialized in place over the previous one, like
+/// `de::deserialize_in_place()`, so that strings and containers inside
+/// it keep their capacity. That also means a struct field that is
+/// missing from one element keeps its value from the one before.
+///
+/// How much of the input is held in memory at once is up to the
+/// `Deserializer`. Formats that parse their whole input up front
+/// still do, but none of the output is kept.
+///
+/// If an element fails to deserialize, `callback` is not called for it,
+/// and the error is thrown or recorded in `deserializer` as usual.
+///
+/// @tparam T Type of each element
+/// @tparam F Callback, called with a `T &`
+/// @param deserializer Deserializer to extract from
+/// @param callback Called with each element, which is only valid
+///                 until it returns
+/// @return Number of elements given to `callback`
+template <class T, class F>
+std::size_t for_each_element(Deserializer & deserializer, F && callback) {
+    struct Restore {
+        Deserializer & deserializer;
+        bool in_place;
+        ~Restore() { deserializer.set_in_place(in_place); }
+    } restore{ deserializer, deserializer.in_place() };
+
+    deserializer.set_in_place(true);
+    ForEachElementVisitor<T, typename std::remove_reference<F>::type> visitor(deserializer, callback);
+    visitor.report_to(deserializer);
+    deserializer.deserialize_seq(visitor);
+    return visitor.count;
+}
+
+}  // namespace de
+}  // namespace kingw
@@ -0,0 +1,17 @@
+#pragma once
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Placeholder for a value that is skipped instead of deserialized
+///
+/// `de::deserialize<IgnoredAny>()` calls `Deserializer::deserialize_ignored_any()`,
+/// which lets a format skip over the next value, no matter its type,
+/// without materializing it. Use it for input that the output has nowhere
+/// to put. For example, `DERIVE_SERDE()` skips the values of struct
+/// fields it does not know about.
+struct IgnoredAny {};
+
+}  // namespace de
+}  // namespace kingw
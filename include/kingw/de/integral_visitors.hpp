@@ -3,6 +3,9 @@
 #include <cstdint>
 
 #include "kingw/de/deserializer.hpp"
+#include "kingw/de/ignored_any.hpp"
+#include "kingw/serde/bytes.hpp"
+#include "kingw/serde/memory_resource.hpp"
 
 
 namespace kingw {
@@ -302,5 +305,84 @@ public:
     void visit_string(serde::string_view value) override;
 };
 
+#if KINGW_SERDE_PMR
+/// @brief Default std::pmr::string Visitor
+///
+/// Only visit_string() is accepted. The string keeps its own
+/// memory resource, so it can be part of an arena.
+/// @see kingw::de::Visitor for usage info.
+///
+/// Used in the default implementation of deserialize<std::pmr::string>().
+class PmrStringVisitor : public de::Visitor {
+public:
+    std::pmr::string & output;
+    explicit PmrStringVisitor(std::pmr::string & output);
+    const char* expecting() const override;
+    void visit_string(serde::string_view value) override;
+};
+#endif
+
+/// @brief Default string_view Visitor
+///
+/// Only visit_borrowed_string() is accepted. A transient string from
+/// visit_string() would dangle, so a DeserializationException is thrown.
+/// The output only stays valid for as long as the deserializer's input.
+/// @see kingw::de::Visitor for usage info.
+///
+/// Used in the default implementation of deserialize<serde::string_view>().
+class StringViewVisitor : public de::Visitor {
+public:
+    serde::string_view & output;
+    explicit StringViewVisitor(serde::string_view & output);
+    const char* expecting() const override;
+    void visit_string(serde::string_view value) override;
+    void visit_borrowed_string(serde::string_view value) override;
+};
+
+/// @brief Default ByteBuf Visitor
+///
+/// Accepts visit_bytes(), or visit_seq() of u8 values for
+/// formats without a native byte array.
+/// @see kingw::de::Visitor for usage info.
+///
+/// Used in the default implementation of deserialize<serde::ByteBuf>().
+class ByteBufVisitor : public de::Visitor {
+public:
+    serde::ByteBuf & output;
+    explicit ByteBufVisitor(serde::ByteBuf & output);
+    const char* expecting() const override;
+    void visit_bytes(const std::uint8_t* data, std::size_t len) override;
+    void visit_seq(de::Deserializer::SeqAccess & seq) override;
+};
+
+/// @brief Default IgnoredAny Visitor
+///
+/// Accepts everything and keeps none of it. Sequences and maps are
+/// drained, ignoring each of their elements.
+/// @see kingw::de::Visitor for usage info.
+///
+/// Used in the default implementation of deserialize<de::IgnoredAny>().
+class IgnoredAnyVisitor : public de::Visitor {
+public:
+    const char* expecting() const override;
+    void visit_bool(bool value) override;
+    void visit_i8(std::int8_t value) override;
+    void visit_i16(std::int16_t value) override;
+    void visit_i32(std::int32_t value) override;
+    void visit_i64(std::int64_t value) override;
+    void visit_u8(std::uint8_t value) override;
+    void visit_u16(std::uint16_t value) override;
+    void visit_u32(std::uint32_t value) override;
+    void visit_u64(std::uint64_t value) override;
+    void visit_f32(float value) override;
+    void visit_f64(double value) override;
+    void visit_char(char value) override;
+    void visit_string(serde::string_view value) override;
+    void visit_bytes(const std::uint8_t* data, std::size_t len) override;
+    void visit_unit() override;
+    void visit_seq(de::Deserializer::SeqAccess & seq) override;
+    void visit_map(de::Deserializer::MapAccess & map) override;
+};
+
 }  // namespace de
 }  // namespace kingw
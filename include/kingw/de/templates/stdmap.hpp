@@ -4,6 +4,7 @@
 
 #include "kingw/de/deserialize.hpp"
 #include "kingw/de/deserializer.hpp"
+#include "kingw/de/validate.hpp"
 
 
 namespace kingw {
@@ -16,12 +17,18 @@ namespace de {
 ///
 /// @tparam K Map key type
 /// @tparam V Map value type
-template <class K, class V>
+/// @tparam C Key comparison
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class K, class V, class C = std::less<K>,
+          class A = std::allocator<std::pair<const K, V>>>
 class StdMapVisitor : public de::Visitor {
 public:
     /// @brief StdMapVisitor Constructor
     /// @param output Reference of variable to deserialize into
-    explicit StdMapVisitor(std::map<K, V> & output) : output(output) { }
+    /// @param in_place Reuse the existing entries instead of merging.
+    ///                 See `Deserializer::in_place()`.
+    explicit StdMapVisitor(std::map<K, V, C, A> & output, bool in_place = false)
+        : output(output), in_place(in_place) { }
 
     /// @brief Explanation of what this Visitor is expecting
     /// @return A string literal
@@ -45,11 +52,18 @@ public:
     /// then call `accessor.deserialize()` on both the key and the
     /// value accessors to fill the data.
     ///
+    /// The entries are merged into the map, replacing the values of
+    /// existing keys, unless `in_place` is set. See `visit_map_in_place()`.
+    ///
     /// @param seq Data from `Deserializer`
     void visit_map(de::Deserializer::MapAccess & map) override {
+        if (in_place) {
+            visit_map_in_place(map);
+            return;
+        }
         while (map.has_next()) {
-            K key{};
-            V value{};
+            K key = de::construct_with_allocator<K>(output.get_allocator());
+            V value = de::construct_with_allocator<V>(output.get_allocator());
             de::Accessor<K> key_accessor(key);
             de::Accessor<V> value_accessor(value);
             map.next_entry(key_accessor, value_accessor);
@@ -58,8 +72,46 @@ public:
     }
 
 private:
+    /// @brief Replace the contents of `output` with the entries in `map`
+    ///
+    /// The value of a key that was already in the map is deserialized
+    /// over the existing value, and its node is moved over as-is, so
+    /// neither the node nor the value's own storage is reallocated.
+    /// Keys that are no longer in the input are removed at the end.
+    ///
+    /// Moving nodes requires C++17. Before that, the map is cleared first.
+    ///
+    /// @param map Data from `Deserializer`
+    void visit_map_in_place(de::Deserializer::MapAccess & map) {
+#if defined(__cpp_lib_node_extract)
+        std::map<K, V, C, A> old(output.key_comp(), output.get_allocator());
+        old.swap(output);
+        K key = de::construct_with_allocator<K>(output.get_allocator());
+        de::Accessor<K> key_accessor(key);
+        while (map.has_next()) {
+            map.next_key(key_accessor);
+            auto node = old.extract(key);
+            if (node) {
+                de::Accessor<V> value_accessor(node.mapped());
+                map.next_value(value_accessor);
+                output.insert(std::move(node));
+            } else {
+                de::Accessor<V> value_accessor(output[key]);
+                map.next_value(value_accessor);
+            }
+        }
+#else
+        output.clear();
+        in_place = false;
+        visit_map(map);
+#endif
+    }
+
     /// @brief Reference of variable to deserialize into
-    std::map<K, V> & output;
+    std::map<K, V, C, A> & output;
+
+    /// @brief Whether to reuse the existing entries
+    bool in_place;
 };
 
 /// @brief `deserialize()` specialization for std::map.
@@ -69,14 +121,36 @@ private:
 ///
 /// @tparam K Map key type
 /// @tparam V Map value type
+/// @tparam C Key comparison
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
 /// @param deserializer Deserializer to extract from
 /// @param output Output location
-template <class K, class V>
-void deserialize(Deserializer & deserializer, std::map<K, V> & output) {
-    StdMapVisitor<K, V> visitor(output);
+template <class K, class V, class C, class A>
+void deserialize(Deserializer & deserializer, std::map<K, V, C, A> & output) {
+    StdMapVisitor<K, V, C, A> visitor(output, deserializer.in_place());
+    visitor.report_to(deserializer);
     deserializer.deserialize_map(visitor);
 }
 
+/// @brief `Validator` specialization for std::map.
+///
+/// Validates each key and value without allocating the map.
+///
+/// @tparam K Map key type
+/// @tparam V Map value type
+/// @tparam C Key comparison
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class K, class V, class C, class A>
+struct Validator<std::map<K, V, C, A>> {
+    /// @brief Check the next value in `deserializer` against `std::map<K, V>`
+    /// @param deserializer Deserializer to extract from
+    static void validate(Deserializer & deserializer) {
+        ValidateMapVisitor<K, V> visitor;
+        visitor.report_to(deserializer);
+        deserializer.deserialize_map(visitor);
+    }
+};
+
 /// @brief Generic `Deserialize` implementation that defers to `de::deserialize<T>()`.
 ///
 /// This Serde implementation uses dynamic dispatch to reduce compilation
@@ -87,12 +161,12 @@ void deserialize(Deserializer & deserializer, std::map<K, V> & output) {
 /// the template type.
 ///
 /// @tparam T Type of object to deserialize
-template <class K, class V>
-class Accessor<std::map<K, V>> : public de::Deserialize {
+template <class K, class V, class C, class A>
+class Accessor<std::map<K, V, C, A>> : public de::Deserialize {
 public:
     /// @brief de::Accessor Constructor
     /// @param output Reference of variable to deserialize into
-    explicit Accessor(std::map<K, V> & output) : output(output) {
+    explicit Accessor(std::map<K, V, C, A> & output) : output(output) {
     }
 
     /// @brief Invoke `de::deserialize<T>()`
@@ -104,12 +178,12 @@ public:
     /// @brief Get the traits of type T
     /// @return `TypeTraits::of<T>()`
     serde::TypeTraits traits() const override {
-        return serde::TypeTraits::of<std::map<K, V>>();
+        return serde::TypeTraits::of<std::map<K, V, C, A>>();
     };
 
 private:
     /// @brief Reference of variable to deserialize into
-    std::map<K, V> & output;
+    std::map<K, V, C, A> & output;
 };
 
 /// @brief Helper function to construct `de::Accessor<T>`
@@ -117,9 +191,9 @@ private:
 /// @tparam T Type of object to deserialize
 /// @param output Reference of variable to deserialize into
 /// @return `de::Accessor<T>`
-template <class K, class V>
-Accessor<std::map<K, V>> accessor(std::map<K, V> & output) {
-    return Accessor<std::map<K, V>>(output);
+template <class K, class V, class C, class A>
+Accessor<std::map<K, V, C, A>> accessor(std::map<K, V, C, A> & output) {
+    return Accessor<std::map<K, V, C, A>>(output);
 }
 
 }  // namespace de
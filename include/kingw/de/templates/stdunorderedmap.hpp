@@ -0,0 +1,195 @@
+#pragma once
+
+#include <unordered_map>
+#include <utility>
+
+#include "kingw/de/deserialize.hpp"
+#include "kingw/de/deserializer.hpp"
+#include "kingw/de/validate.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Generic Visitor class for `std::unordered_map<K, V>` deserialization
+///
+/// Used by `deserialize<std::unordered_map<K, V>>()`.
+/// You probably won't manually use this yourself, but you can if you need to.
+///
+/// @tparam K Map key type
+/// @tparam V Map value type
+/// @tparam H Key hash
+/// @tparam E Key equality
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class K, class V, class H = std::hash<K>, class E = std::equal_to<K>,
+          class A = std::allocator<std::pair<const K, V>>>
+class StdUnorderedMapVisitor : public de::Visitor {
+public:
+    /// @brief StdUnorderedMapVisitor Constructor
+    /// @param output Reference of variable to deserialize into
+    /// @param in_place Reuse the existing entries instead of merging.
+    ///                 See `Deserializer::in_place()`.
+    explicit StdUnorderedMapVisitor(std::unordered_map<K, V, H, E, A> & output, bool in_place = false)
+        : output(output), in_place(in_place) { }
+
+    /// @brief Explanation of what this Visitor is expecting
+    /// @return A string literal
+    const char* expecting() const override { return "a map of items"; }
+
+    /// @brief Extract items from `map` and put them into `output`
+    ///
+    /// This works the same way as `StdMapVisitor<K, V>::visit_map()`,
+    /// except that the buckets for every entry are reserved up front
+    /// if the `Deserializer` knows how many entries there are. This
+    /// avoids rehashing the table as it grows.
+    ///
+    /// @param map Data from `Deserializer`
+    void visit_map(de::Deserializer::MapAccess & map) override {
+        if (in_place) {
+            visit_map_in_place(map);
+            return;
+        }
+        const std::size_t hint = de::cautious_size_hint<std::pair<const K, V>>(map.size_hint());
+        output.reserve(output.size() + hint);
+        while (map.has_next()) {
+            K key = de::construct_with_allocator<K>(output.get_allocator());
+            V value = de::construct_with_allocator<V>(output.get_allocator());
+            de::Accessor<K> key_accessor(key);
+            de::Accessor<V> value_accessor(value);
+            map.next_entry(key_accessor, value_accessor);
+            output[std::move(key)] = std::move(value);
+        }
+    }
+
+private:
+    /// @brief Replace the contents of `output` with the entries in `map`
+    ///
+    /// The value of a key that was already in the map is deserialized
+    /// over the existing value, and its node is moved over as-is, so
+    /// neither the node nor the value's own storage is reallocated.
+    /// Only the bucket array is allocated again, once per call.
+    /// Keys that are no longer in the input are removed at the end.
+    ///
+    /// Moving nodes requires C++17. Before that, the map is cleared first.
+    ///
+    /// @param map Data from `Deserializer`
+    void visit_map_in_place(de::Deserializer::MapAccess & map) {
+#if defined(__cpp_lib_node_extract)
+        std::unordered_map<K, V, H, E, A> old(
+            0, output.hash_function(), output.key_eq(), output.get_allocator());
+        old.swap(output);
+        output.reserve(old.size());  // The bucket array is the only allocation
+        K key = de::construct_with_allocator<K>(output.get_allocator());
+        de::Accessor<K> key_accessor(key);
+        while (map.has_next()) {
+            map.next_key(key_accessor);
+            auto node = old.extract(key);
+            if (node) {
+                de::Accessor<V> value_accessor(node.mapped());
+                map.next_value(value_accessor);
+                output.insert(std::move(node));
+            } else {
+                de::Accessor<V> value_accessor(output[key]);
+                map.next_value(value_accessor);
+            }
+        }
+#else
+        output.clear();
+        in_place = false;
+        visit_map(map);
+#endif
+    }
+
+    /// @brief Reference of variable to deserialize into
+    std::unordered_map<K, V, H, E, A> & output;
+
+    /// @brief Whether to reuse the existing entries
+    bool in_place;
+};
+
+/// @brief `deserialize()` specialization for std::unordered_map.
+///
+/// Since `std::unordered_map` is a template, this definition has to be
+/// available anywhere a `std::unordered_map` is deserialized.
+///
+/// @tparam K Map key type
+/// @tparam V Map value type
+/// @tparam H Key hash
+/// @tparam E Key equality
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+/// @param deserializer Deserializer to extract from
+/// @param output Output location
+template <class K, class V, class H, class E, class A>
+void deserialize(Deserializer & deserializer, std::unordered_map<K, V, H, E, A> & output) {
+    StdUnorderedMapVisitor<K, V, H, E, A> visitor(output, deserializer.in_place());
+    visitor.report_to(deserializer);
+    deserializer.deserialize_map(visitor);
+}
+
+/// @brief `Validator` specialization for std::unordered_map.
+///
+/// Validates each key and value without allocating the map.
+///
+/// @tparam K Map key type
+/// @tparam V Map value type
+/// @tparam H Key hash
+/// @tparam E Key equality
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class K, class V, class H, class E, class A>
+struct Validator<std::unordered_map<K, V, H, E, A>> {
+    /// @brief Check the next value in `deserializer` against `std::unordered_map<K, V>`
+    /// @param deserializer Deserializer to extract from
+    static void validate(Deserializer & deserializer) {
+        ValidateMapVisitor<K, V> visitor;
+        visitor.report_to(deserializer);
+        deserializer.deserialize_map(visitor);
+    }
+};
+
+/// @brief Generic `Deserialize` implementation that defers to `de::deserialize<T>()`.
+///
+/// This Serde implementation uses dynamic dispatch to reduce compilation
+/// overhead. If your class does not inherit from `Deserialize`, then you
+/// will be required to use this class to use a `Deserializer`.
+///
+/// `de::accessor(item)` is a helper function that avoids having to write
+/// the template type.
+///
+/// @tparam T Type of object to deserialize
+template <class K, class V, class H, class E, class A>
+class Accessor<std::unordered_map<K, V, H, E, A>> : public de::Deserialize {
+public:
+    /// @brief de::Accessor Constructor
+    /// @param output Reference of variable to deserialize into
+    explicit Accessor(std::unordered_map<K, V, H, E, A> & output) : output(output) {
+    }
+
+    /// @brief Invoke `de::deserialize<T>()`
+    /// @param deserializer Deserializer to extract from
+    void deserialize(de::Deserializer & deserializer) override {
+        de::deserialize(deserializer, output);
+    }
+
+    /// @brief Get the traits of type T
+    /// @return `TypeTraits::of<T>()`
+    serde::TypeTraits traits() const override {
+        return serde::TypeTraits::of<std::unordered_map<K, V, H, E, A>>();
+    };
+
+private:
+    /// @brief Reference of variable to deserialize into
+    std::unordered_map<K, V, H, E, A> & output;
+};
+
+/// @brief Helper function to construct `de::Accessor<T>`
+/// Avoids having to write the template type during construction.
+/// @tparam T Type of object to deserialize
+/// @param output Reference of variable to deserialize into
+/// @return `de::Accessor<T>`
+template <class K, class V, class H, class E, class A>
+Accessor<std::unordered_map<K, V, H, E, A>> accessor(std::unordered_map<K, V, H, E, A> & output) {
+    return Accessor<std::unordered_map<K, V, H, E, A>>(output);
+}
+
+}  // namespace de
+}  // namespace kingw
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <type_traits>
 #include <vector>
 
 #include "kingw/de/deserializer.hpp"
+#include "kingw/de/validate.hpp"
 
 
 namespace kingw {
@@ -14,12 +16,16 @@ namespace de {
 /// You probably won't manually use this yourself, but you can if you need to.
 ///
 /// @tparam T Vector element type
-template <class T>
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class T, class A = std::allocator<T>>
 class StdVectorVisitor : public de::Visitor {
 public:
     /// @brief StdVectorVisitor Constructor
     /// @param output Reference of variable to deserialize into
-    explicit StdVectorVisitor(std::vector<T> & output) : output(output) { }
+    /// @param in_place Overwrite the existing elements instead of appending.
+    ///                 See `Deserializer::in_place()`.
+    explicit StdVectorVisitor(std::vector<T, A> & output, bool in_place = false)
+        : output(output), in_place(in_place) { }
 
     /// @brief Explanation of what this Visitor is expecting
     /// @return A string literal
@@ -42,18 +48,49 @@ public:
     /// through `seq.next_element()`. The `Deserializer` can
     /// then call `accessor.deserialize()` to fill the data.
     ///
+    /// Vectors of basic types are filled in batches instead, using
+    /// `de::next_elements()`. The `Deserializer` can then parse each batch
+    /// straight into the vector's storage. Any other type of element uses
+    /// a batch size of one, which is the same as one `next_element()` each.
+    ///
+    /// If the `Deserializer` knows how long the list is, the vector
+    /// reserves space for all of it first, and basic types read the
+    /// whole list as a single batch.
+    ///
+    /// The elements are appended to the vector, unless `in_place` is set.
+    /// Then they are deserialized over the existing elements, starting
+    /// with the first one, so that their own storage (such as the
+    /// capacity of a string) is reused. Any existing elements beyond
+    /// the end of the list are removed afterwards.
+    ///
     /// @param seq Data from `Deserializer`
     void visit_seq(de::Deserializer::SeqAccess & seq) override {
-        while (seq.has_next()) {
-            output.push_back({});
-            de::Accessor<T> accessor(output.back());
-            seq.next_element(accessor);
+        std::size_t end = in_place ? 0 : output.size();  // Just beyond the last deserialized element
+        const std::size_t hint = de::cautious_size_hint<T>(seq.size_hint());
+        output.reserve(end + hint);
+
+        std::size_t batch = 1;
+        if (std::is_arithmetic<T>::value) {
+            batch = hint > 0 ? hint : 64;
         }
+
+        std::size_t count = 0;
+        do {
+            if (output.size() < end + batch) {
+                output.resize(end + batch);
+            }
+            count = de::next_elements(seq, output.data() + end, batch);
+            end += count;
+        } while (count == batch && seq.has_next());
+        output.resize(end);
     }
 
 private:
     /// @brief Reference of variable to deserialize into
-    std::vector<T> & output;
+    std::vector<T, A> & output;
+
+    /// @brief Whether to overwrite the existing elements
+    bool in_place;
 };
 
 /// @brief `deserialize()` specialization for std::vector.
@@ -62,14 +99,33 @@ private:
 /// available anywhere a `std::vector` is deserialized.
 ///
 /// @tparam T Vector element type
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
 /// @param deserializer Deserializer to extract from
 /// @param output Output location
-template <class T>
-void deserialize(de::Deserializer & deserializer, std::vector<T> & output) {
-    StdVectorVisitor<T> visitor(output);
+template <class T, class A>
+void deserialize(de::Deserializer & deserializer, std::vector<T, A> & output) {
+    StdVectorVisitor<T, A> visitor(output, deserializer.in_place());
+    visitor.report_to(deserializer);
     deserializer.deserialize_seq(visitor);
 }
 
+/// @brief `Validator` specialization for std::vector.
+///
+/// Validates each element without allocating the vector.
+///
+/// @tparam T Vector element type
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class T, class A>
+struct Validator<std::vector<T, A>> {
+    /// @brief Check the next value in `deserializer` against `std::vector<T>`
+    /// @param deserializer Deserializer to extract from
+    static void validate(Deserializer & deserializer) {
+        ValidateSeqVisitor<T> visitor;
+        visitor.report_to(deserializer);
+        deserializer.deserialize_seq(visitor);
+    }
+};
+
 /// @brief Generic `Deserialize` implementation that defers to `de::deserialize<T>()`.
 ///
 /// This Serde implementation uses dynamic dispatch to reduce compilation
@@ -80,12 +136,13 @@ void deserialize(de::Deserializer & deserializer, std::vector<T> & output) {
 /// the template type.
 ///
 /// @tparam T Type of object to deserialize
-template <class T>
-class Accessor<std::vector<T>> : public de::Deserialize {
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
+template <class T, class A>
+class Accessor<std::vector<T, A>> : public de::Deserialize {
 public:
     /// @brief de::Accessor Constructor
     /// @param output Reference of variable to deserialize into
-    explicit Accessor(std::vector<T> & output) : output(output) {
+    explicit Accessor(std::vector<T, A> & output) : output(output) {
     }
 
     /// @brief Invoke `de::deserialize<T>()`
@@ -97,22 +154,23 @@ public:
     /// @brief Get the traits of type T
     /// @return `TypeTraits::of<T>()`
     serde::TypeTraits traits() const override {
-        return serde::TypeTraits::of<std::vector<T>>();
+        return serde::TypeTraits::of<std::vector<T, A>>();
     };
 
 private:
     /// @brief Reference of variable to deserialize into
-    std::vector<T> & output;
+    std::vector<T, A> & output;
 };
 
 /// @brief Helper function to construct `de::Accessor<T>`
 /// Avoids having to write the template type during construction.
 /// @tparam T Type of object to deserialize
+/// @tparam A Allocator, such as `std::pmr::polymorphic_allocator`
 /// @param output Reference of variable to deserialize into
 /// @return `de::Accessor<T>`
-template <class T>
-Accessor<std::vector<T>> accessor(std::vector<T> & output) {
-    return Accessor<std::vector<T>>(output);
+template <class T, class A>
+Accessor<std::vector<T, A>> accessor(std::vector<T, A> & output) {
+    return Accessor<std::vector<T, A>>(output);
 }
 
 }  // namespace de
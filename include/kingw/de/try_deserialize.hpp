@@ -0,0 +1,43 @@
+#pragma once
+
+#include "kingw/de/deserializer.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Deserialize without throwing exceptions
+///
+/// Same as `de::deserialize<T>()`, except that errors are returned
+/// instead of thrown. This avoids the cost of unwinding through every
+/// nested visitor for malformed input, and works when compiled with
+/// `-fno-exceptions`.
+///
+/// Like the adapters' `from_string()`, this must be included after the
+/// templates for `std::vector` etc. so that it can find their overloads.
+///
+/// `deserializer.throw_on_error()` is turned off for the duration of
+/// the call. If the deserializer had already failed, that earlier error
+/// is returned. After an error, the contents of `output` are unspecified.
+///
+/// @tparam T Type of object to deserialize
+/// @param deserializer Deserializer to extract from
+/// @param output Output location
+/// @return The first error, or an `Error` with `ErrorCode::None`
+template <class T>
+Error try_deserialize(Deserializer & deserializer, T & output) {
+    // Restore the previous setting even if something throws anyway,
+    // such as a custom visitor that does not report_to() the deserializer.
+    struct Restore {
+        Deserializer & deserializer;
+        bool throw_on_error;
+        ~Restore() { deserializer.set_throw_on_error(throw_on_error); }
+    } restore{ deserializer, deserializer.throw_on_error() };
+
+    deserializer.set_throw_on_error(false);
+    de::deserialize(deserializer, output);
+    return deserializer.error();
+}
+
+}  // namespace de
+}  // namespace kingw
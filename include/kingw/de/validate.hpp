@@ -0,0 +1,199 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "kingw/de/deserializer.hpp"
+#include "kingw/de/ignored_any.hpp"
+#include "kingw/serde/bytes.hpp"
+#include "kingw/serde/memory_resource.hpp"
+
+
+namespace kingw {
+namespace de {
+
+/// @brief Validate by deserializing into a temporary T
+///
+/// For types that have no cheaper way to be validated. This does
+/// everything `de::deserialize<T>()` does, including allocating.
+///
+/// @tparam T Default-constructible type of object to deserialize
+/// @param deserializer Deserializer to extract from
+template <class T>
+void validate_by_deserializing(Deserializer & deserializer) {
+    T output{};
+    de::deserialize(deserializer, output);
+}
+
+/// @brief Check that the input is a valid T, without constructing a T.
+///
+/// `Validator<T>::validate()` runs the same type checks and range checks
+/// as `de::deserialize<T>()`, and reports the same errors, but throws
+/// away every value instead of storing it. Use `de::validate<T>()` to
+/// call it.
+///
+/// There is no default implementation, just like `de::deserialize<T>()`.
+/// There are implementations for the same types as `de::deserialize<T>()`.
+/// Strings, bytes and the containers don't copy or allocate, and
+/// `DERIVE_DESERIALIZE()` defines one for its struct, so validation runs
+/// at the speed of the format's parser. `DECLARE_DESERIALIZE()` declares
+/// it next to the struct.
+///
+/// A type with a hand-written `deserialize<T>()` defines its `Validator<T>`
+/// in the same source (.cpp) file, and declares both next to the type.
+/// If there is no cheaper way, it can deserialize into a temporary:
+///
+/// ```
+/// template <>
+/// void kingw::de::Validator<Example>::validate(kingw::de::Deserializer & deserializer) {
+///     kingw::de::validate_by_deserializing<Example>(deserializer);
+/// }
+/// ```
+///
+/// @tparam T Type of object to check the input against
+template <class T>
+struct Validator {
+    /// @brief Check the next value in `deserializer` against T
+    ///
+    /// Errors are reported through `deserializer.fail()`,
+    /// like `de::deserialize<T>()` does.
+    ///
+    /// @param deserializer Deserializer to extract from
+    static void validate(Deserializer & deserializer);
+};
+
+// Defined in validate.cpp.
+template <> void Validator<bool>::validate(Deserializer & deserializer);
+template <> void Validator<std::int8_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::int16_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::int32_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::int64_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::uint8_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::uint16_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::uint32_t>::validate(Deserializer & deserializer);
+template <> void Validator<std::uint64_t>::validate(Deserializer & deserializer);
+template <> void Validator<float>::validate(Deserializer & deserializer);
+template <> void Validator<double>::validate(Deserializer & deserializer);
+template <> void Validator<char>::validate(Deserializer & deserializer);
+template <> void Validator<serde::string_view>::validate(Deserializer & deserializer);
+template <> void Validator<std::string>::validate(Deserializer & deserializer);
+#if KINGW_SERDE_PMR
+template <> void Validator<std::pmr::string>::validate(Deserializer & deserializer);
+#endif
+template <> void Validator<serde::ByteBuf>::validate(Deserializer & deserializer);
+template <> void Validator<IgnoredAny>::validate(Deserializer & deserializer);
+
+/// @brief `Deserialize` implementation that validates a T instead of deserializing it
+///
+/// Passed to `SeqAccess::next_element()` and `MapAccess::next_value()`
+/// etc. in place of an `Accessor<T>`, where there is no T to write to.
+///
+/// @tparam T Type of object to check the input against
+template <class T>
+class ValidateAccessor : public de::Deserialize {
+public:
+    /// @brief Invoke `Validator<T>::validate()`
+    /// @param deserializer Deserializer to extract from
+    void deserialize(de::Deserializer & deserializer) override {
+        Validator<T>::validate(deserializer);
+    }
+
+    /// @brief Get the traits of type T
+    /// @return `TypeTraits::of<T>()`
+    serde::TypeTraits traits() const override {
+        return serde::TypeTraits::of<T>();
+    }
+};
+
+/// @brief Validate every remaining element of a sequence as a T
+///
+/// Basic types are read in batches into a buffer on the stack, through
+/// `de::next_elements()`, like `std::vector<T>` reads them into its storage.
+///
+/// @tparam T Type of element to check the input against
+/// @param seq Sequence to extract from
+template <class T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+validate_elements(Deserializer::SeqAccess & seq) {
+    constexpr std::size_t BATCH = 64;
+    T buffer[BATCH];
+    while (seq.has_next() && de::next_elements(seq, buffer, BATCH) == BATCH) { }
+}
+
+/// @brief Validate every remaining element of a sequence as a T
+/// @see validate_elements()
+/// @tparam T Type of element to check the input against
+/// @param seq Sequence to extract from
+template <class T>
+typename std::enable_if<!std::is_arithmetic<T>::value>::type
+validate_elements(Deserializer::SeqAccess & seq) {
+    ValidateAccessor<T> accessor;
+    while (seq.has_next()) {
+        seq.next_element(accessor);
+    }
+}
+
+/// @brief Visitor that validates a sequence of T, such as for `std::vector<T>`
+/// @tparam T Type of element to check the input against
+template <class T>
+class ValidateSeqVisitor : public de::Visitor {
+public:
+    /// @brief Explanation of what this Visitor is expecting
+    /// @return A string literal
+    const char* expecting() const override { return "a sequence of items"; }
+
+    /// @brief Validate each element of `seq`
+    /// @param seq Data from `Deserializer`
+    void visit_seq(de::Deserializer::SeqAccess & seq) override {
+        de::validate_elements<T>(seq);
+    }
+};
+
+/// @brief Visitor that validates a map from K to V, such as for `std::map<K, V>`
+/// @tparam K Type of key to check the input against
+/// @tparam V Type of value to check the input against
+template <class K, class V>
+class ValidateMapVisitor : public de::Visitor {
+public:
+    /// @brief Explanation of what this Visitor is expecting
+    /// @return A string literal
+    const char* expecting() const override { return "a map of items"; }
+
+    /// @brief Validate each key and value of `map`
+    /// @param map Data from `Deserializer`
+    void visit_map(de::Deserializer::MapAccess & map) override {
+        ValidateAccessor<K> key;
+        ValidateAccessor<V> value;
+        while (map.has_next()) {
+            map.next_entry(key, value);
+        }
+    }
+};
+
+/// @brief Check that the input is a valid T, without constructing a T
+///
+/// Same as `de::try_deserialize<T>()`, except that nothing is written
+/// anywhere. See `Validator<T>`. Returns the error that deserializing a
+/// T would have returned.
+///
+/// Like `de::try_deserialize()`, this must be included after the
+/// templates for `std::vector` etc. so that it can find their validators.
+///
+/// @tparam T Type of object to check the input against
+/// @param deserializer Deserializer to extract from
+/// @return The first error, or an `Error` with `ErrorCode::None`
+template <class T>
+Error validate(Deserializer & deserializer) {
+    struct Restore {
+        Deserializer & deserializer;
+        bool throw_on_error;
+        ~Restore() { deserializer.set_throw_on_error(throw_on_error); }
+    } restore{ deserializer, deserializer.throw_on_error() };
+
+    deserializer.set_throw_on_error(false);
+    Validator<T>::validate(deserializer);
+    return deserializer.error();
+}
+
+}  // namespace de
+}  // namespace kingw
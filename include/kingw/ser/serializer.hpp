@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <iterator>
 #include <stdexcept>
 
 #include "kingw/ser/serialize.hpp"
@@ -38,6 +39,34 @@ public:
     virtual void serialize_char(char value) = 0;
     virtual void serialize_string(serde::string_view value) = 0;
 
+    // Contiguous Sequences of Basic Types
+    // Equivalent to serialize_seq(len) followed by one serialize_element()
+    // per value, which is also what the default implementations do.
+    // Override these to write a whole array without a virtual call,
+    // Accessor, and nested serialize() per element.
+    virtual void serialize_bool_seq(const bool* values, std::size_t len);
+    virtual void serialize_i8_seq(const std::int8_t* values, std::size_t len);
+    virtual void serialize_i16_seq(const std::int16_t* values, std::size_t len);
+    virtual void serialize_i32_seq(const std::int32_t* values, std::size_t len);
+    virtual void serialize_i64_seq(const std::int64_t* values, std::size_t len);
+    virtual void serialize_u8_seq(const std::uint8_t* values, std::size_t len);
+    virtual void serialize_u16_seq(const std::uint16_t* values, std::size_t len);
+    virtual void serialize_u32_seq(const std::uint32_t* values, std::size_t len);
+    virtual void serialize_u64_seq(const std::uint64_t* values, std::size_t len);
+    virtual void serialize_f32_seq(const float* values, std::size_t len);
+    virtual void serialize_f64_seq(const double* values, std::size_t len);
+
+    // Byte Blobs
+    // Binary formats can write the bytes as-is, and text formats can
+    // encode them, e.g. as base64. The default implementation writes
+    // a sequence of u8 with serialize_u8_seq().
+    virtual void serialize_bytes(const std::uint8_t* data, std::size_t len);
+
+    // Unit
+    // A value with no content, such as JSON null. The default
+    // implementation writes an empty string.
+    virtual void serialize_unit();
+
     class SerializeSeq
     {
     public:
@@ -116,5 +145,119 @@ Accessor<T> accessor(const T & item) {
     return Accessor<T>(item);
 }
 
+/// @brief Serialize a contiguous array of elements as a sequence.
+///
+/// This generic version serializes each element individually
+/// through `ser::accessor()`. Arrays of basic types instead pick
+/// one of the non-template overloads below, which hand the entire
+/// array to the matching `Serializer::serialize_*_seq()` function.
+///
+/// @tparam T Type of element to serialize
+/// @param serializer Serializer to insert into
+/// @param data Pointer to the first element
+/// @param len Number of elements
+template <class T>
+void serialize_array(ser::Serializer & serializer, const T* data, std::size_t len) {
+    auto seq = serializer.serialize_seq(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        seq.serialize_element(ser::accessor(data[i]));
+    }
+    seq.end();
+}
+
+void serialize_array(ser::Serializer & serializer, const bool* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::int8_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::int16_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::int32_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::int64_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::uint8_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::uint16_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::uint32_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const std::uint64_t* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const float* data, std::size_t len);
+void serialize_array(ser::Serializer & serializer, const double* data, std::size_t len);
+
+/// @brief Number of elements between two iterators, if it is cheap to find
+///
+/// Used by `ser::serialize_range()`. Only random access iterators can
+/// be measured without walking the range, which input iterators (such
+/// as a database cursor) can only do once.
+///
+/// @return Number of elements, or `Serializer::UNKNOWN_LENGTH`
+template <class Iterator>
+std::size_t range_length(Iterator begin, Iterator end, std::random_access_iterator_tag) {
+    return static_cast<std::size_t>(std::distance(begin, end));
+}
+template <class Iterator>
+std::size_t range_length(Iterator, Iterator, std::input_iterator_tag) {
+    return Serializer::UNKNOWN_LENGTH;
+}
+
+/// @brief Serialize a range of elements as a sequence.
+///
+/// The elements are serialized straight from the iterators, one by one,
+/// without collecting them into a container first. Any input iterator
+/// works, including ones that produce each element on the fly.
+///
+/// @tparam Iterator Input iterator type
+/// @param serializer Serializer to insert into
+/// @param begin First element
+/// @param end One past the last element
+/// @param len Number of elements, or `Serializer::UNKNOWN_LENGTH`
+template <class Iterator>
+void serialize_range(ser::Serializer & serializer, Iterator begin, Iterator end, std::size_t len) {
+    auto seq = serializer.serialize_seq(len);
+    for (; begin != end; ++begin) {
+        seq.serialize_element(ser::accessor(*begin));
+    }
+    seq.end();
+}
+
+/// @brief Serialize a range of elements as a sequence.
+///
+/// The length is only given to the serializer for random access
+/// iterators. See `ser::range_length()`.
+///
+/// @tparam Iterator Input iterator type
+/// @param serializer Serializer to insert into
+/// @param begin First element
+/// @param end One past the last element
+template <class Iterator>
+void serialize_range(ser::Serializer & serializer, Iterator begin, Iterator end) {
+    const std::size_t len = ser::range_length(begin, end,
+        typename std::iterator_traits<Iterator>::iterator_category());
+    ser::serialize_range(serializer, begin, end, len);
+}
+
+/// @brief Serialize elements from a callback as a sequence.
+///
+/// For producers that are not iterators, such as a cursor with a
+/// `fetch()` function. Each element is filled into the same `T`,
+/// which is serialized before the next one is requested:
+///
+/// ```
+/// ser::serialize_generator<Row>(serializer, [&](Row & row) {
+///     return cursor.fetch(row);
+/// });
+/// ```
+///
+/// The length is not known up front. Formats that write it first need
+/// to support `Serializer::UNKNOWN_LENGTH`.
+///
+/// @tparam T Type of each element
+/// @tparam F Callback, called with a `T &`. Fills it in and returns
+///           true, or returns false once there are no more elements.
+/// @param serializer Serializer to insert into
+/// @param next Callback that produces each element
+template <class T, class F>
+void serialize_generator(ser::Serializer & serializer, F && next) {
+    T element{};
+    auto seq = serializer.serialize_seq();
+    while (next(element)) {
+        seq.serialize_element(ser::accessor(element));
+    }
+    seq.end();
+}
+
 }  // namespace ser
 }  // namespace kingw
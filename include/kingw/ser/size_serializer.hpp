@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+namespace ser {
+
+/// @brief Base for serializers that only count the bytes a format would write
+///
+/// Each format derives its own, which mirrors what its serializer writes
+/// for every call, without writing anything. The caller can then allocate
+/// the output once, at its exact size, or use a stack buffer when it fits:
+///
+/// ```
+/// serde_sprintf::SPrintfSizeSerializer sizer;
+/// ser::serialize(sizer, message);
+/// std::vector<char> buffer(sizer.size());
+/// ```
+class SizeSerializer : public ser::Serializer
+{
+public:
+    /// @brief Number of bytes counted so far
+    std::size_t size() const { return size_; }
+
+    /// @brief Start counting again from 0
+    void reset() { size_ = 0; }
+
+protected:
+    /// @brief Count some bytes
+    void add(std::size_t len) { size_ += len; }
+
+private:
+    std::size_t size_ = 0;
+};
+
+/// @brief Number of characters in the decimal representation of an integer
+///
+/// Computed from the number of significant bits and one comparison,
+/// instead of formatting the number.
+///
+/// @param value Integer to measure
+/// @return Number of digits, at least 1
+std::size_t decimal_length(std::uint64_t value);
+
+/// @brief Number of characters in the decimal representation of an integer
+///
+/// @param value Integer to measure
+/// @return Number of digits, plus 1 for the '-' if `value` is negative
+std::size_t decimal_length(std::int64_t value);
+
+}  // namespace ser
+}  // namespace kingw
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+#include "kingw/ser/serializer.hpp"
+#include "kingw/serde/fiber.hpp"
+
+
+namespace kingw {
+namespace ser {
+
+/// @brief How much a `SlicedSerializer` writes in one call to `step()`
+///
+/// Whichever limit is reached first ends the slice. Both are checked
+/// between values, so a slice runs over by up to one value, or one
+/// contiguous array of numbers such as a `std::vector<int>`.
+struct SliceBudget {
+    /// @brief No limit on the number of bytes
+    constexpr static std::size_t UNLIMITED = -1;
+
+    /// @brief Bytes of data per slice
+    ///
+    /// Counted the same way for every format: the size of each number,
+    /// and the length of each string and byte array. The output may be
+    /// larger or smaller, but grows in proportion.
+    std::size_t bytes = UNLIMITED;
+
+    /// @brief Time per slice
+    ///
+    /// The clock is only read every `TIME_CHECK_INTERVAL` values.
+    std::chrono::steady_clock::duration time = std::chrono::steady_clock::duration::max();
+
+    /// @brief Number of values written between reads of the clock
+    constexpr static std::uint32_t TIME_CHECK_INTERVAL = 64;
+};
+
+/// @brief Serializes a little at a time, for event loops
+///
+/// Writing a large value in one `ser::serialize()` call blocks the
+/// thread until it is done. A `SlicedSerializer` runs the serialization
+/// in slices instead: each `step()` writes until it has used up its
+/// `SliceBudget`, then returns, and the next `step()` continues where the
+/// previous one stopped. Other work can run in between, so it doesn't
+/// have to wait for the whole value.
+///
+/// ```
+/// std::ofstream file("snapshot.txt");
+/// kingw::OStreamSerializer output(file);
+/// ser::SliceBudget budget;
+/// budget.time = std::chrono::milliseconds(2);
+/// ser::SlicedSerializer sliced(output, [&snapshot](ser::Serializer & serializer) {
+///     ser::serialize(serializer, snapshot);
+/// }, budget);
+/// while (!sliced.step()) {
+///     handle_requests();
+/// }
+/// ```
+///
+/// Every call is forwarded to `output`. The containers that are open in
+/// `output` are kept on a stack here, and the `ser::serialize<T>()` calls
+/// that are still in progress run on a `serde::Fiber`, which suspends
+/// between values. So `ser::serialize<T>()` does not need to change to
+/// be sliced, however deeply the value nests.
+///
+/// The value must not change until the serialization is done.
+class SlicedSerializer : public ser::Serializer
+{
+public:
+    /// @brief Function that serializes the value into the given serializer
+    using Encode = std::function<void(ser::Serializer & serializer)>;
+
+    /// @brief SlicedSerializer Constructor
+    ///
+    /// Nothing is written until the first call to `step()`.
+    ///
+    /// @param output Serializer to forward to. Must outlive this serializer.
+    /// @param encode Function that serializes into this serializer
+    /// @param budget Limits of each slice
+    /// @param stack_size Size of the stack that `encode` runs on.
+    ///                   Deeply nested data needs more.
+    SlicedSerializer(ser::Serializer & output, Encode encode, SliceBudget budget,
+        std::size_t stack_size = serde::Fiber::DEFAULT_STACK_SIZE);
+
+    /// @brief SlicedSerializer Destructor
+    ///
+    /// If the serialization is not done, it is abandoned: `encode` is
+    /// unwound with a `SerializationException`, which is ignored.
+    /// Without exceptions, it is finished instead.
+    ~SlicedSerializer();
+
+    SlicedSerializer(const SlicedSerializer &) = delete;
+    SlicedSerializer & operator=(const SlicedSerializer &) = delete;
+
+    /// @brief Write the next slice
+    ///
+    /// Errors thrown by `encode` or `output` are thrown from here.
+    ///
+    /// @return True once the whole value has been written
+    bool step();
+
+    /// @brief Whether the whole value has been written
+    /// @return True once `encode` has returned or thrown
+    bool done() const;
+
+    /// @brief Same as `output.is_human_readable()`
+    /// @return True if `output` is human readable
+    bool is_human_readable() const override;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs, Unit
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+    void serialize_unit() override;
+
+protected:
+    // Lists/Sequences
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & accessor) override;
+    void seq_end() override;
+
+    // Maps
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & accessor) override;
+    void map_serialize_value(const ser::Serialize & accessor) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    /// @brief Passes a nested value back through this serializer
+    class Forward;
+
+    /// @brief Count `bytes` against the budget, and suspend if it is used up
+    /// @param bytes Bytes of data just written
+    void spend(std::size_t bytes);
+
+    ser::Serializer & output;
+    SliceBudget budget;
+    serde::Fiber fiber;
+
+    // Containers open in `output`, innermost last
+    std::deque<SerializeSeq> seqs;
+    std::deque<SerializeMap> maps;
+    std::deque<SerializeStruct> structs;
+
+    // Progress through the current slice
+    std::size_t spent = 0;
+    std::uint32_t values = 0;
+    std::chrono::steady_clock::time_point deadline;
+    bool cancelled = false;
+};
+
+}  // namespace ser
+}  // namespace kingw
@@ -9,8 +9,8 @@
 namespace kingw {
 namespace ser {
 
-template <class K, class V>
-void serialize(ser::Serializer & serializer, const std::map<K, V> & data) {
+template <class K, class V, class C, class A>
+void serialize(ser::Serializer & serializer, const std::map<K, V, C, A> & data) {
     auto map = serializer.serialize_map(data.size());
     for (const auto & kvp : data) {
         map.serialize_entry(ser::accessor(kvp.first), ser::accessor(kvp.second));
@@ -18,23 +18,23 @@ void serialize(ser::Serializer & serializer, const std::map<K, V> & data) {
     map.end();
 }
 
-template <class K, class V>
-class Accessor<std::map<K, V>> : public ser::Serialize {
+template <class K, class V, class C, class A>
+class Accessor<std::map<K, V, C, A>> : public ser::Serialize {
 public:
-    explicit Accessor(const std::map<K, V> & item) : item(item) { }
+    explicit Accessor(const std::map<K, V, C, A> & item) : item(item) { }
     void serialize(ser::Serializer & serializer) const override {
         ser::serialize(serializer, item);
     }
     serde::TypeTraits traits() const override {
-        return serde::TypeTraits::of<std::map<K, V>>();
+        return serde::TypeTraits::of<std::map<K, V, C, A>>();
     };
 private:
-    const std::map<K, V> & item;
+    const std::map<K, V, C, A> & item;
 };
 
-template <class K, class V>
-Accessor<std::map<K, V>> accessor(const std::map<K, V> & item) {
-    return Accessor<std::map<K, V>>(item);
+template <class K, class V, class C, class A>
+Accessor<std::map<K, V, C, A>> accessor(const std::map<K, V, C, A> & item) {
+    return Accessor<std::map<K, V, C, A>>(item);
 }
 
 }  // namespace ser
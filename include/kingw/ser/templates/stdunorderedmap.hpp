@@ -0,0 +1,41 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "kingw/ser/serialize.hpp"
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+namespace ser {
+
+template <class K, class V, class H, class E, class A>
+void serialize(ser::Serializer & serializer, const std::unordered_map<K, V, H, E, A> & data) {
+    auto map = serializer.serialize_map(data.size());
+    for (const auto & kvp : data) {
+        map.serialize_entry(ser::accessor(kvp.first), ser::accessor(kvp.second));
+    }
+    map.end();
+}
+
+template <class K, class V, class H, class E, class A>
+class Accessor<std::unordered_map<K, V, H, E, A>> : public ser::Serialize {
+public:
+    explicit Accessor(const std::unordered_map<K, V, H, E, A> & item) : item(item) { }
+    void serialize(ser::Serializer & serializer) const override {
+        ser::serialize(serializer, item);
+    }
+    serde::TypeTraits traits() const override {
+        return serde::TypeTraits::of<std::unordered_map<K, V, H, E, A>>();
+    };
+private:
+    const std::unordered_map<K, V, H, E, A> & item;
+};
+
+template <class K, class V, class H, class E, class A>
+Accessor<std::unordered_map<K, V, H, E, A>> accessor(const std::unordered_map<K, V, H, E, A> & item) {
+    return Accessor<std::unordered_map<K, V, H, E, A>>(item);
+}
+
+}  // namespace ser
+}  // namespace kingw
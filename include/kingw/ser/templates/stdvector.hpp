@@ -9,32 +9,40 @@
 namespace kingw {
 namespace ser {
 
-template <class T>
-void serialize(ser::Serializer & serializer, const std::vector<T> & data) {
+template <class T, class A>
+void serialize(ser::Serializer & serializer, const std::vector<T, A> & data) {
+    // Vectors of basic types are handed to the Serializer in one call.
+    ser::serialize_array(serializer, data.data(), data.size());
+}
+
+// std::vector<bool> is bit-packed and has no data(),
+// so it is serialized one element at a time.
+template <class A>
+void serialize(ser::Serializer & serializer, const std::vector<bool, A> & data) {
     auto seq = serializer.serialize_seq(data.size());
-    for (const auto & element : data) {
+    for (bool element : data) {
         seq.serialize_element(ser::accessor(element));
     }
     seq.end();
 }
 
-template <class T>
-class Accessor<std::vector<T>> : public ser::Serialize {
+template <class T, class A>
+class Accessor<std::vector<T, A>> : public ser::Serialize {
 public:
-    explicit Accessor(const std::vector<T> & item) : item(item) { }
+    explicit Accessor(const std::vector<T, A> & item) : item(item) { }
     void serialize(ser::Serializer & serializer) const override {
         ser::serialize(serializer, item);
     }
     serde::TypeTraits traits() const override {
-        return serde::TypeTraits::of<std::vector<T>>();
+        return serde::TypeTraits::of<std::vector<T, A>>();
     };
 private:
-    const std::vector<T> & item;
+    const std::vector<T, A> & item;
 };
 
-template <class T>
-Accessor<std::vector<T>> accessor(const std::vector<T> & item) {
-    return Accessor<std::vector<T>>(item);
+template <class T, class A>
+Accessor<std::vector<T, A>> accessor(const std::vector<T, A> & item) {
+    return Accessor<std::vector<T, A>>(item);
 }
 
 }  // namespace ser
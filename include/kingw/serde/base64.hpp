@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace kingw {
+namespace serde {
+
+/// @brief Number of characters needed to base64-encode some bytes
+///
+/// Includes the '=' padding, so this is always a multiple of 4.
+///
+/// @param len Number of bytes to encode
+/// @return Number of characters `base64_encode()` will write
+std::size_t base64_encoded_size(std::size_t len);
+
+/// @brief Maximum number of bytes that some base64 characters decode into
+///
+/// The actual number may be up to 2 bytes smaller if the input is padded.
+///
+/// @param len Number of characters to decode
+/// @return Size of the buffer `base64_decode()` needs
+std::size_t base64_decoded_size(std::size_t len);
+
+/// @brief Encode bytes as standard (RFC 4648) base64, with padding
+///
+/// Uses SSSE3 or AVX2 when the CPU supports them, and a scalar
+/// implementation otherwise. All of them produce the same output.
+///
+/// @param input Bytes to encode
+/// @param len Number of bytes to encode
+/// @param output Buffer of at least `base64_encoded_size(len)` characters
+/// @return Pointer just beyond the last character written
+char* base64_encode(const std::uint8_t* input, std::size_t len, char* output);
+
+/// @brief Decode standard (RFC 4648) base64
+///
+/// The '=' padding is optional. Whitespace, the URL-safe alphabet,
+/// and non-zero bits after the last byte are not accepted.
+///
+/// Uses SSSE3 or AVX2 when the CPU supports them, and a scalar
+/// implementation otherwise. All of them produce the same output.
+///
+/// @param input Characters to decode
+/// @param len Number of characters to decode
+/// @param output Buffer of at least `base64_decoded_size(len)` bytes
+/// @param output_len Number of bytes written to `output`
+/// @return False if `input` is not valid base64
+bool base64_decode(const char* input, std::size_t len, std::uint8_t* output, std::size_t & output_len);
+
+}  // namespace serde
+}  // namespace kingw
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+namespace kingw {
+namespace serde {
+
+/// @brief An owned blob of bytes
+///
+/// `std::vector<std::uint8_t>` is serialized like any other vector,
+/// as a sequence of numbers. Wrap the bytes in a `ByteBuf` instead to
+/// use `Serializer::serialize_bytes()` and `Deserializer::deserialize_bytes()`.
+/// Binary formats can copy the bytes as-is, and text formats can encode
+/// them compactly, such as with base64.
+struct ByteBuf {
+    std::vector<std::uint8_t> bytes;
+};
+
+inline bool operator==(const ByteBuf & lh, const ByteBuf & rh) {
+    return lh.bytes == rh.bytes;
+}
+
+inline bool operator!=(const ByteBuf & lh, const ByteBuf & rh) {
+    return !(lh == rh);
+}
+
+}  // namespace serde
+}  // namespace kingw
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "kingw/ser/serialize.hpp"
+#include "kingw/de/deserialize.hpp"
+#include "kingw/de/validate.hpp"
+
+
+/// @brief Declares what DERIVE_SERIALIZE() defines
+/// @see DECLARE_SERDE() comments for usage info
+#define DECLARE_SERIALIZE(StructName) \
+template <> \
+void kingw::ser::serialize<StructName>(kingw::ser::Serializer & serializer, const StructName & input)
+
+/// @brief Declares what DERIVE_DESERIALIZE() defines
+/// @see DECLARE_SERDE() comments for usage info
+#define DECLARE_DESERIALIZE(StructName) \
+template <> \
+void kingw::de::deserialize<StructName>(kingw::de::Deserializer & deserializer, StructName & output); \
+template <> \
+void kingw::de::Validator<StructName>::validate(kingw::de::Deserializer & deserializer)
+
+/// @brief Declares what DERIVE_SERDE() defines
+///
+/// Example usage, in the header next to the struct:
+///   struct Example { int foo; double bar; };
+///   DECLARE_SERDE(Example);
+///
+/// and in one source file:
+///   DERIVE_SERDE(Example,
+///     ("Foo", &Self::foo)
+///     ("Bar", &Self::bar));
+///
+/// The primary templates are only declared, so the linker finds the one
+/// definition from DERIVE_SERDE() even without this. Declaring it lets
+/// every source file see that the specialization exists before using it,
+/// as the language asks.
+///
+/// @param StructName Type of class/struct
+#define DECLARE_SERDE(StructName) \
+DECLARE_SERIALIZE(StructName); \
+DECLARE_DESERIALIZE(StructName)
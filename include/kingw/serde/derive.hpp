@@ -4,6 +4,10 @@
 
 #include "kingw/ser/serializer.hpp"
 #include "kingw/de/deserializer.hpp"
+#include "kingw/de/field_mask.hpp"
+#include "kingw/de/ignored_any.hpp"
+#include "kingw/de/validate.hpp"
+#include "kingw/serde/declare.hpp"
 
 
 namespace kingw {
@@ -87,6 +91,27 @@ struct FieldDefinition {
         de::Accessor<Field> accessor(get(output));
         seq.next_element(accessor);
     }
+
+    /// @brief Helper function to validate this field without an object
+    ///
+    /// Also skips fields that are not selected by a `de::FieldMask`.
+    /// The `de::Validator` parses them without allocating, and formats
+    /// that are not self-describing cannot tell where a value ends otherwise.
+    ///
+    /// @see deserialize_map()
+    /// @param map de::Deserializer helper class, from deserialize_struct()
+    void validate_map(de::Deserializer::MapAccess & map) const {
+        de::ValidateAccessor<Field> accessor;
+        map.next_value(accessor);
+    }
+
+    /// @brief Helper function to validate this field without an object
+    /// @see deserialize_seq()
+    /// @param seq de::Deserializer helper class, from deserialize_struct()
+    void validate_seq(de::Deserializer::SeqAccess & seq) const {
+        de::ValidateAccessor<Field> accessor;
+        seq.next_element(accessor);
+    }
 };
 
 
@@ -188,8 +213,9 @@ struct StructDefinition<Struct> {
     /// @param output Instance of Struct to deserialize
     void deserialize(de::Deserializer & deserializer, Struct & output) const {
         // This struct has no fields.
-        // If deserialize returns any fields, then throw an exception.
+        // If deserialize returns any fields, then skip them.
         EmptyStructVisitor visitor;
+        visitor.report_to(deserializer);
         deserializer.deserialize_struct(struct_name(), {}, visitor);
     }
 
@@ -200,7 +226,10 @@ struct StructDefinition<Struct> {
     void deserialize_map_recurse(de::Deserializer::MapAccess & map, std::size_t field_index, Struct & output) const {
         // This function call is the end of the recursion chain.
         // If we haven't found the matching field by now, then it doesn't exist.
-        throw de::DeserializationException("unsupported key");
+        // Skip its value, so that the input can have fields we don't know about.
+        de::IgnoredAny ignored;
+        de::Accessor<de::IgnoredAny> accessor(ignored);
+        map.next_value(accessor);
     }
 
     /// @brief Recursive helper function for deserialize() to invoke for each field
@@ -210,6 +239,40 @@ struct StructDefinition<Struct> {
         // No-op. Stop recursing.
     }
 
+    /// @brief Recursive helper function for deserialize() to invoke for each field
+    /// @param seq de::Deserializer helper class, from deserialize_struct()
+    /// @param output Instance of Struct to deserialize
+    /// @param mask Fields to deserialize. The others are skipped.
+    void project_seq_recurse(de::Deserializer::SeqAccess &, Struct &, const de::FieldMask &) const {
+        // No-op. Stop recursing.
+    }
+
+    /// @brief Check that the input is a valid Struct, without constructing one
+    /// @see de::Validator
+    /// @param deserializer de::Deserialize to deserialize from
+    void validate(de::Deserializer & deserializer) const {
+        // Same as deserialize(). There is nothing to write either way.
+        EmptyStructVisitor visitor;
+        visitor.report_to(deserializer);
+        deserializer.deserialize_struct(struct_name(), {}, visitor);
+    }
+
+    /// @brief Recursive helper function for validate() to invoke for each field
+    /// @see deserialize_map_recurse()
+    /// @param map de::Deserializer helper class, from deserialize_struct()
+    /// @param field_index Index of the field to validate
+    void validate_map_recurse(de::Deserializer::MapAccess & map, std::size_t) const {
+        // Unknown fields are skipped, like in deserialize_map_recurse().
+        de::ValidateAccessor<de::IgnoredAny> accessor;
+        map.next_value(accessor);
+    }
+
+    /// @brief Recursive helper function for validate() to invoke for each field
+    /// @param seq de::Deserializer helper class, from deserialize_struct()
+    void validate_seq_recurse(de::Deserializer::SeqAccess &) const {
+        // No-op. Stop recursing.
+    }
+
     /// @brief Helper function that recursively inputs field names into names_arr
     /// @param names_arr Existing array with at least `field_number` elements
     void field_names(serde::string_view* names_arr) const {
@@ -225,7 +288,8 @@ struct StructDefinition<Struct> {
         return 0;
     }
 
-    /// @brief Custom visitor that throws an exception if any fields are found
+    /// @brief Custom visitor that skips any fields in a map, or reports
+    /// an error if there are any elements in a sequence
     ///
     /// This StructDefinition has no fields. There's nowhere to put the data.
     struct EmptyStructVisitor : public de::Visitor {
@@ -238,8 +302,11 @@ struct StructDefinition<Struct> {
         /// @brief Interpret and deserialize a map into the output struct instance
         /// @param map de::Deserializer helper object for deserializing key-value pairs
         void visit_map(de::Deserializer::MapAccess & map) override {
-            if (map.has_next()) {
-                throw de::DeserializationException("expected struct with no fields");
+            // Every field is unknown, so skip them all.
+            de::IgnoredAny ignored;
+            de::Accessor<de::IgnoredAny> accessor(ignored);
+            while (map.has_next()) {
+                map.next_entry(accessor, accessor);
             }
         }
 
@@ -247,7 +314,7 @@ struct StructDefinition<Struct> {
         /// @param seq de::Deserializer helper object for deserializing a sequence of elements
         void visit_seq(de::Deserializer::SeqAccess & seq) override {
             if (seq.has_next()) {
-                throw de::DeserializationException("expected struct with no fields");
+                fail(de::ErrorCode::InvalidLength, "expected struct with no fields");
             }
         }
     };
@@ -386,10 +453,28 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
         // TODO: Initializer list? Span?
         serde::string_view names[sizeof...(PreviousFields) + 1] = {};
         field_names(names);
-        de::Deserializer::FieldNames field_names(std::begin(names), std::end(names));
+        std::size_t num_names = field_number;
+
+        // A field mask for this struct limits it to the selected fields.
+        // Only those are requested from the deserializer, so that formats
+        // that look fields up by name don't even look for the others.
+        const de::FieldMask* mask = deserializer.field_mask();
+        if (mask != nullptr && mask->struct_name() != struct_name()) {
+            mask = nullptr;
+        }
+        if (mask != nullptr) {
+            num_names = 0;
+            for (std::size_t i = 0; i < field_number; i++) {
+                if (mask->selected(i + 1)) {
+                    names[num_names++] = names[i];
+                }
+            }
+        }
+        de::Deserializer::FieldNames field_names(names, names + num_names);
 
         // Deserialize using a custom visitor that will invoke deserialize_recurse().
-        StructVisitor visitor(output, *this);
+        StructVisitor visitor(output, *this, mask);
+        visitor.report_to(deserializer);
         deserializer.deserialize_struct(struct_name(), field_names, visitor);
     }
 
@@ -433,7 +518,67 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
         if (seq.has_next()) {
             field.deserialize_seq(seq, output);
         } else {
-            throw de::DeserializationException("number of elements in sequence does not match struct fields");
+            seq.fail(de::ErrorCode::InvalidLength, "number of elements in sequence does not match struct fields");
+        }
+    }
+
+    /// @brief Recursive helper function for deserialize() to invoke for each field
+    ///
+    /// Same as deserialize_seq_recurse(), except that fields that are not
+    /// selected in `mask` are skipped instead of deserialized.
+    ///
+    /// @param seq de::Deserializer helper class, from deserialize_struct()
+    /// @param output Instance of Struct to deserialize
+    /// @param mask Fields to deserialize. The others are skipped.
+    void project_seq_recurse(de::Deserializer::SeqAccess & seq, Struct & output, const de::FieldMask & mask) const {
+        previous_fields.project_seq_recurse(seq, output, mask);
+        if (!seq.has_next()) {
+            seq.fail(de::ErrorCode::InvalidLength, "number of elements in sequence does not match struct fields");
+        } else if (mask.selected(field_number)) {
+            field.deserialize_seq(seq, output);
+        } else {
+            field.validate_seq(seq);
+        }
+    }
+
+    /// @brief Check that the input is a valid Struct, without constructing one
+    ///
+    /// Walks the fields like deserialize() does, but validates each one
+    /// through `de::Validator<Field>` instead of deserializing into it.
+    ///
+    /// @see de::Validator
+    /// @param deserializer de::Deserialize to deserialize from
+    void validate(de::Deserializer & deserializer) const {
+        serde::string_view names[sizeof...(PreviousFields) + 1] = {};
+        field_names(names);
+        de::Deserializer::FieldNames field_names(std::begin(names), std::end(names));
+
+        StructValidator visitor(*this);
+        visitor.report_to(deserializer);
+        deserializer.deserialize_struct(struct_name(), field_names, visitor);
+    }
+
+    /// @brief Recursive helper function for validate() to invoke for each field
+    /// @see deserialize_map_recurse()
+    /// @param map de::Deserializer helper class, from deserialize_struct()
+    /// @param field_index Index of the field to validate
+    void validate_map_recurse(de::Deserializer::MapAccess & map, std::size_t field_index) const {
+        if (field_index == field_number) {
+            field.validate_map(map);
+        } else {
+            previous_fields.validate_map_recurse(map, field_index);
+        }
+    }
+
+    /// @brief Recursive helper function for validate() to invoke for each field
+    /// @see deserialize_seq_recurse()
+    /// @param seq de::Deserializer helper class, from deserialize_struct()
+    void validate_seq_recurse(de::Deserializer::SeqAccess & seq) const {
+        previous_fields.validate_seq_recurse(seq);
+        if (seq.has_next()) {
+            field.validate_seq(seq);
+        } else {
+            seq.fail(de::ErrorCode::InvalidLength, "number of elements in sequence does not match struct fields");
         }
     }
 
@@ -483,11 +628,15 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
         /// @brief Description of Struct
         StructDefinition defn;
 
+        /// @brief Fields to deserialize, or nullptr for all of them
+        const de::FieldMask* mask;
+
         /// @brief StructVisitor Constructor
         /// @param output Struct instance to deserialize into
         /// @param defn Description of Struct
-        explicit StructVisitor(Struct & output, StructDefinition defn)
-            : output(output), defn(defn) {}
+        /// @param mask Fields to deserialize, or nullptr for all of them
+        explicit StructVisitor(Struct & output, StructDefinition defn, const de::FieldMask* mask = nullptr)
+            : output(output), defn(defn), mask(mask) {}
 
         /// @brief Human-readable hint at what the visitor is expecting
         /// @return A string literal
@@ -504,7 +653,11 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
             FieldNameAccessor visitor(defn, field_index);
             while (map.has_next()) {
                 map.next_key(visitor);  // Put key to field_index, or 0
-                defn.deserialize_map_recurse(map, field_index, output);
+                if (mask != nullptr && !mask->selected(field_index)) {
+                    defn.validate_map_recurse(map, field_index);
+                } else {
+                    defn.deserialize_map_recurse(map, field_index, output);
+                }
             }
         }
 
@@ -512,9 +665,51 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
         /// @param seq de::Deserializer helper object for deserializing a sequence of elements
         void visit_seq(de::Deserializer::SeqAccess & seq) override {
             // Deserialize each field in order. Must match exactly.
-            defn.deserialize_seq_recurse(seq, output);
+            if (mask != nullptr) {
+                defn.project_seq_recurse(seq, output, *mask);
+            } else {
+                defn.deserialize_seq_recurse(seq, output);
+            }
+            if (seq.has_next()) {
+                fail(de::ErrorCode::InvalidLength, "number of elements in sequence does not match struct fields");
+            }
+        }
+    };
+
+    /// @brief Custom visitor for validating struct fields
+    /// @see StructVisitor
+    struct StructValidator : public de::Visitor {
+        /// @brief Description of Struct
+        StructDefinition defn;
+
+        /// @brief StructValidator Constructor
+        /// @param defn Description of Struct
+        explicit StructValidator(StructDefinition defn)
+            : defn(defn) {}
+
+        /// @brief Human-readable hint at what the visitor is expecting
+        /// @return A string literal
+        const char* expecting() const override {
+            return defn.struct_name().data();
+        }
+
+        /// @brief Validate each value of a map as the field named by its key
+        /// @param map de::Deserializer helper object for deserializing key-value pairs
+        void visit_map(de::Deserializer::MapAccess & map) override {
+            std::size_t field_index = 0;
+            FieldNameAccessor visitor(defn, field_index);
+            while (map.has_next()) {
+                map.next_key(visitor);
+                defn.validate_map_recurse(map, field_index);
+            }
+        }
+
+        /// @brief Validate each element of a sequence as the next field
+        /// @param seq de::Deserializer helper object for deserializing a sequence of elements
+        void visit_seq(de::Deserializer::SeqAccess & seq) override {
+            defn.validate_seq_recurse(seq);
             if (seq.has_next()) {
-                throw de::DeserializationException("number of elements in sequence does not match struct fields");
+                fail(de::ErrorCode::InvalidLength, "number of elements in sequence does not match struct fields");
             }
         }
     };
@@ -533,17 +728,24 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
         /// @brief Output param. One-based index - a `field_number` or 0
         std::size_t & output;
 
+        /// @brief Names of the fields, by `field_number` - 1
+        serde::string_view names[sizeof...(PreviousFields) + 1];
+
         /// @brief FieldNameAccessor Constructor
         /// @param defn Description of a class/struct that has member variables
         /// @param output Output param. One-based index - a `field_number` or 0
         FieldNameAccessor(StructDefinition defn, std::size_t & output)
-            : defn(defn), output(output) {}
+            : defn(defn), output(output), names()
+        {
+            defn.field_names(names);
+        }
 
         /// @brief Extract this object from the Deserializer
         /// @param deserializer Deserializer to extract from
         void deserialize(de::Deserializer & deserializer) override {
             // Get the field name. Should invoke `visit_string()` of
             // this object, see definitions below.
+            report_to(deserializer);
             deserializer.deserialize_string(*this);
         }
 
@@ -564,7 +766,13 @@ struct StructDefinition<Struct, Field, PreviousFields...> {
         /// @brief Set `output` to the `field_number` of the field named `key`, or 0
         /// @param key Name/identifier of the field
         void visit_string(serde::string_view value) override {
-            output = defn.index_of_field_name(value);
+            // Fields usually arrive in the order they were serialized in,
+            // so the one after the previous key is tried before the rest.
+            if (output < field_number && names[output] == value) {
+                ++output;
+            } else {
+                output = defn.index_of_field_name(value);
+            }
         }
     };
 };
@@ -579,7 +787,7 @@ void kingw::ser::serialize<StructName>(kingw::ser::Serializer & serializer, cons
     defn.serialize(serializer, input); \
 }
 
-/// @brief de::deserialize<T>() implementation helper
+/// @brief de::deserialize<T>() and de::Validator<T> implementation helper
 /// @see DERIVE_SERDE() comments for usage info
 #define DERIVE_DESERIALIZE(StructName, ...) \
 template <> \
@@ -587,6 +795,12 @@ void kingw::de::deserialize<StructName>(kingw::de::Deserializer & deserializer,
     using Self = StructName; \
     auto defn = kingw::serde::StructDefinition<StructName>(#StructName) __VA_ARGS__ ; \
     defn.deserialize(deserializer, output); \
+} \
+template <> \
+void kingw::de::Validator<StructName>::validate(kingw::de::Deserializer & deserializer) { \
+    using Self = StructName; \
+    auto defn = kingw::serde::StructDefinition<StructName>(#StructName) __VA_ARGS__ ; \
+    defn.validate(deserializer); \
 }
 
 /// @brief ser::serialize<T>() and de::deserialize<T>() implementation helper
@@ -624,6 +838,7 @@ void kingw::de::deserialize<StructName>(kingw::de::Deserializer & deserializer,
 /// was not found. Serde definitions may be defined in different source files
 /// or libraries and linked together. It is recommended to DERIVE_SERDE() in
 /// source files and NOT in header files or you may impact your compilation speed.
+/// Use DECLARE_SERDE() in the header instead, next to the struct.
 ///
 /// You may use DERIVE_SERIALIZE() and DERIVE_DESERIALIZE() instead if you only
 /// wish to have one of the two defined. DERIVE_SERDE() does both.
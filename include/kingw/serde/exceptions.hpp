@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdlib>
+
+/// @brief Whether this translation unit is compiled with exceptions
+///
+/// Defined to 0 when compiling with `-fno-exceptions` (or `/EHs-c-`).
+/// Errors that would have been thrown call `std::abort()` instead.
+/// Use `de::try_deserialize()` to deserialize without reaching them.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define KINGW_SERDE_EXCEPTIONS 1
+#else
+#define KINGW_SERDE_EXCEPTIONS 0
+#endif
+
+/// @brief Throw an exception, or abort if exceptions are disabled
+#if KINGW_SERDE_EXCEPTIONS
+#define KINGW_SERDE_THROW(exception) throw exception
+#else
+#define KINGW_SERDE_THROW(exception) std::abort()
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+
+namespace kingw {
+namespace serde {
+
+/// @brief A function running on its own stack, which can suspend and be resumed
+///
+/// Serializers and deserializers recurse through nested visitors and
+/// accessors, so their progress is kept on the C++ stack. Running them
+/// on a `Fiber` lets them stop in the middle, from any depth, and pick
+/// up later: `de::ChunkedInput` suspends a decode until more input
+/// arrives, and `ser::SlicedSerializer` suspends an encode once it has
+/// used up its time slice.
+///
+/// Uses POSIX ucontext, or fibers on Windows. Everything runs on the
+/// thread that calls `resume()`; nothing is synchronized.
+class Fiber {
+public:
+    /// @brief Stack size used unless another is given to the constructor
+    ///
+    /// Each level of nesting in the data takes some of the stack. The
+    /// stack ends in a guard page, so data that is nested too deeply for
+    /// it crashes the program with a stack overflow (SIGSEGV), like deep
+    /// recursion on any thread, instead of overwriting other memory.
+    /// Give a larger size for deeply nested input from untrusted sources.
+    constexpr static std::size_t DEFAULT_STACK_SIZE = 256 * 1024;
+
+    /// @brief Fiber Constructor
+    ///
+    /// `body` does not start until the first call to `resume()`.
+    ///
+    /// @param body Function to run on the fiber
+    /// @param stack_size Size of the fiber's stack, rounded up to whole pages.
+    ///                   Deeply nested data needs more.
+    explicit Fiber(std::function<void()> body, std::size_t stack_size = DEFAULT_STACK_SIZE);
+
+    /// @brief Fiber Destructor
+    ///
+    /// A fiber that is suspended is destroyed without unwinding its
+    /// stack. Let `body` return first, so that it can clean up.
+    ~Fiber();
+
+    Fiber(const Fiber &) = delete;
+    Fiber & operator=(const Fiber &) = delete;
+
+    /// @brief Run `body` until it calls `suspend()` or returns
+    ///
+    /// An exception thrown by `body` can't unwind past the switch between
+    /// stacks, so it is caught on the fiber and thrown again from here.
+    /// Does nothing once `body` has returned.
+    void resume();
+
+    /// @brief Return from `resume()`. Only called from inside `body`.
+    void suspend();
+
+    /// @brief Whether `body` has started and not returned yet
+    /// @return True while suspended, or while running
+    bool running() const;
+
+    /// @brief Whether `body` has returned or thrown
+    /// @return True once finished
+    bool done() const;
+
+private:
+    /// @brief Stack and saved registers, which are platform-specific
+    class Context;
+
+    /// @brief Stack and saved registers
+    std::unique_ptr<Context> context;
+};
+
+}  // namespace serde
+}  // namespace kingw
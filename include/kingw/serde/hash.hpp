@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+namespace serde {
+
+/// @brief A 128-bit hash
+struct Hash128 {
+    std::uint64_t low;
+    std::uint64_t high;
+
+    bool operator==(const Hash128 & other) const {
+        return low == other.low && high == other.high;
+    }
+    bool operator!=(const Hash128 & other) const {
+        return !(*this == other);
+    }
+};
+
+/// @brief The ways a `Hasher` can mix whole stripes into its accumulators
+///
+/// They all give the same hashes. Only the scalar one is available
+/// everywhere; the others need an x86 CPU that supports them.
+enum class HashKernel {
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/// @brief Streaming, non-cryptographic 64/128-bit hash of some bytes
+///
+/// Built like XXH3: the input is split into 64-byte stripes, each one
+/// mixed into eight 64-bit accumulators with one 32x32-bit multiply
+/// per lane, which maps directly onto SSE2 and AVX2. Those are used
+/// when the CPU supports them. Every implementation gives the same
+/// result, which only depends on the bytes, not on how they were split
+/// between calls to `update()`, nor on the platform.
+///
+/// It is not the XXH3 algorithm, and does not give the same hashes.
+///
+/// The hasher never allocates. Bytes are collected into a small buffer
+/// inside it until a whole stripe is available.
+class Hasher {
+public:
+    /// @brief Hasher Constructor
+    /// @param seed Gives a different hash for the same bytes
+    explicit Hasher(std::uint64_t seed = 0);
+
+    /// @brief Hasher Constructor, using a given kernel instead of the fastest
+    ///
+    /// Meant for tests and benchmarks. A kernel that is not `supported()`
+    /// falls back to `HashKernel::Scalar`.
+    /// @param seed Gives a different hash for the same bytes
+    /// @param kernel Kernel to mix stripes with
+    Hasher(std::uint64_t seed, HashKernel kernel);
+
+    /// @brief Whether a kernel is built in and runs on this CPU
+    static bool supported(HashKernel kernel);
+
+    /// @brief Start again, as if newly constructed
+    /// @param seed Gives a different hash for the same bytes
+    void reset(std::uint64_t seed = 0);
+
+    /// @brief Add some bytes to the hash
+    /// @param data Bytes to add
+    /// @param len Number of bytes
+    void update(const void* data, std::size_t len) {
+        // Whole stripes are never left in the buffer. Checking len against
+        // STRIPE_SIZE as well lets the compiler see that the copy fits.
+        const std::size_t room = STRIPE_SIZE - buffered;
+        if (len < STRIPE_SIZE && len < room) {
+            std::memcpy(buffer + buffered, data, len);
+            buffered += len;
+            total += len;
+        } else {
+            update_stripes(static_cast<const std::uint8_t*>(data), len);
+        }
+    }
+
+    /// @brief 64-bit hash of the bytes added so far
+    ///
+    /// More bytes may still be added afterwards.
+    std::uint64_t digest() const;
+
+    /// @brief 128-bit hash of the bytes added so far
+    ///
+    /// More bytes may still be added afterwards.
+    Hash128 digest128() const;
+
+    /// @brief Number of bytes in each stripe
+    constexpr static std::size_t STRIPE_SIZE = 64;
+
+private:
+    void update_stripes(const std::uint8_t* data, std::size_t len);
+    void finish(std::uint64_t (&output)[8]) const;
+
+    using Accumulate = void (*)(std::uint64_t* acc, const std::uint8_t* input,
+        std::size_t stripes, const std::uint64_t* secret, std::size_t & stripe);
+
+    Accumulate accumulate;          ///< Kernel chosen at construction
+    alignas(32) std::uint64_t acc[8];
+    std::uint64_t secret[16];       ///< Per-lane keys, derived from the seed
+    std::uint8_t buffer[STRIPE_SIZE];
+    std::size_t buffered;           ///< Bytes in `buffer`, less than STRIPE_SIZE
+    std::size_t stripe;             ///< Stripes since the last scramble
+    std::uint64_t total;            ///< Bytes added in total
+};
+
+}  // namespace serde
+
+
+namespace ser {
+
+/// @brief Feeds a value into a `serde::Hasher` instead of formatting it
+///
+/// Every basic value is added as a one-byte tag for its type, followed
+/// by its little-endian bytes. Strings, bytes, and field names are
+/// added with their length first. Sequences, maps, and structs add a
+/// tag at their beginning and end, but not their length, so the hash
+/// is the same whether or not the length was known up front. The name
+/// of a struct is not added, but the names of its fields are.
+///
+/// Nothing is allocated, and the value is only walked once.
+///
+/// Two values with the same hash almost certainly serialize to the
+/// same calls, and so to the same output in any format. Floating point
+/// numbers are added as their bits, so `0.0` and `-0.0` differ.
+class HashSerializer : public ser::Serializer
+{
+public:
+    /// @brief HashSerializer Constructor
+    /// @param hasher Hasher to add to. Must outlive the serializer.
+    /// @param human_readable Value for `is_human_readable()`
+    explicit HashSerializer(serde::Hasher & hasher, bool human_readable = false);
+    bool is_human_readable() const override;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
+    // Unit
+    void serialize_unit() override;
+
+protected:
+    // Lists/Sequences
+    // Use serialize_seq() instead.
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & accessor) override;
+    void seq_end() override;
+
+    // Maps
+    // Use serialize_map() instead.
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & key) override;
+    void map_serialize_value(const ser::Serialize & value) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    // Use serialize_struct() instead.
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    template <class T>
+    void write_value(std::uint8_t tag, T value);
+    template <class T>
+    void write_seq(std::uint8_t tag, const T* values, std::size_t len);
+    void write_string(std::uint8_t tag, serde::string_view value);
+
+    serde::Hasher & hasher;
+    bool human_readable;
+};
+
+}  // namespace ser
+
+
+namespace serde {
+
+/// @brief 64-bit hash of a value, in a single pass and without allocating
+///
+/// ```
+/// std::uint64_t key = serde::hash(message);
+/// ```
+///
+/// See `ser::HashSerializer` for what is hashed.
+///
+/// @param value Value to hash
+/// @param seed Gives a different hash for the same value
+template <class T>
+std::uint64_t hash(const T & value, std::uint64_t seed = 0) {
+    serde::Hasher hasher(seed);
+    ser::HashSerializer serializer(hasher);
+    ser::serialize(serializer, value);
+    return hasher.digest();
+}
+
+/// @brief 128-bit hash of a value, in a single pass and without allocating
+///
+/// See `ser::HashSerializer` for what is hashed.
+///
+/// @param value Value to hash
+/// @param seed Gives a different hash for the same value
+template <class T>
+serde::Hash128 hash128(const T & value, std::uint64_t seed = 0) {
+    serde::Hasher hasher(seed);
+    ser::HashSerializer serializer(hasher);
+    ser::serialize(serializer, value);
+    return hasher.digest128();
+}
+
+}  // namespace serde
+}  // namespace kingw
@@ -0,0 +1,19 @@
+#pragma once
+
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+#endif
+
+/// @brief Whether this translation unit has `std::pmr`
+///
+/// Defined to 1 when `<memory_resource>` is available (C++17).
+/// `std::pmr::string` and `de::ArenaScope` are only available then.
+/// `std::pmr::vector` and `std::pmr::map` work either way, since the
+/// container templates accept any allocator.
+#if defined(__cpp_lib_memory_resource)
+#define KINGW_SERDE_PMR 1
+#else
+#define KINGW_SERDE_PMR 0
+#endif
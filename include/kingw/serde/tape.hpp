@@ -0,0 +1,299 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "kingw/de/deserializer.hpp"
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+
+namespace ser { class TapeSerializer; }
+
+namespace serde {
+
+/// @brief A recording of the calls made to a `ser::Serializer`
+///
+/// Record a value once with a `ser::TapeSerializer`, which is little
+/// more than a `memcpy()` per call, then format it later, possibly on
+/// another thread and possibly more than once:
+///
+/// ```
+/// serde::Tape tape;
+/// ser::TapeSerializer recorder(tape);
+/// ser::serialize(recorder, message);      // Hot path
+///
+/// std::string json = serde_json::to_string(tape);    // Anywhere else
+/// ```
+///
+/// `ser::serialize(serializer, tape)` replays the calls into any other
+/// serializer, and a `de::TapeDeserializer` reads the tape back like
+/// any self-describing format, so it also works as a fast in-memory
+/// format for copying values between types.
+///
+/// The tape is one contiguous buffer in native byte order. It is only
+/// meant to be used by the process that recorded it, not stored or sent.
+class Tape {
+public:
+    /// @brief Kind of each entry in the tape
+    ///
+    /// Every value starts with its `Op`, followed by:
+    /// - Basic types: the value itself
+    /// - `String`, `Bytes`: a `std::size_t` length and the contents
+    /// - `*Seq`: a `std::size_t` length, padding to 8 bytes, and the elements
+    /// - `SeqBegin`, `MapBegin`: a `std::size_t` offset past the matching
+    ///   `*End`, a `std::size_t` length, then the elements (or keys and
+    ///   values), then `SeqEnd` or `MapEnd`
+    /// - `StructBegin`: an offset past the `StructEnd`, a `std::size_t`
+    ///   length, the name like a `String`, then `StructField` (followed by
+    ///   the name and the value) or `StructSkipField` (followed by the name)
+    ///   for each field, then `StructEnd`
+    enum class Op : std::uint8_t {
+        None,  ///< Not written, stands in for a missing value
+        Bool, I8, I16, I32, I64, U8, U16, U32, U64, F32, F64, Char,
+        String, Bytes, Unit,
+        BoolSeq, I8Seq, I16Seq, I32Seq, I64Seq, U8Seq, U16Seq, U32Seq, U64Seq, F32Seq, F64Seq,
+        SeqBegin, SeqEnd,
+        MapBegin, MapEnd,
+        StructBegin, StructField, StructSkipField, StructEnd,
+    };
+
+    /// @brief Whether nothing has been recorded
+    bool empty() const { return bytes.empty(); }
+
+    /// @brief Size of the tape, in bytes
+    std::size_t size() const { return bytes.size(); }
+
+    /// @brief Contents of the tape, see `Op`
+    const unsigned char* data() const { return bytes.data(); }
+
+    /// @brief Forget everything recorded, but keep the memory for reuse
+    void clear() { bytes.clear(); }
+
+    /// @brief Allocate memory for recording `size` bytes up front
+    void reserve(std::size_t size) { bytes.reserve(size); }
+
+    /// @brief What the recording serializer's `is_human_readable()` returned
+    ///
+    /// Types may serialize differently for readable formats, so the tape
+    /// should be replayed into a serializer that returns the same.
+    bool is_human_readable() const { return human_readable; }
+
+private:
+    friend class ser::TapeSerializer;
+
+    std::vector<unsigned char> bytes;
+    bool human_readable = true;
+};
+
+}  // namespace serde
+
+
+namespace ser {
+
+/// @brief Records every call into a `serde::Tape`
+///
+/// Calls are appended to the tape, so serializing more than one value
+/// records each of them in order. Replaying the tape with
+/// `ser::serialize(serializer, tape)` makes the same calls, except that
+/// `serialize_seq()` and `serialize_map()` are given the number of
+/// elements that were actually serialized, even if it was not known
+/// when they were first called.
+class TapeSerializer : public ser::Serializer
+{
+public:
+    /// @brief TapeSerializer Constructor
+    /// @param tape Tape to record into. Must outlive the serializer.
+    /// @param human_readable Value for `is_human_readable()`
+    explicit TapeSerializer(serde::Tape & tape, bool human_readable = true);
+    bool is_human_readable() const override;
+
+    // Basic Types
+    void serialize_bool(bool value) override;
+    void serialize_i8(std::int8_t value) override;
+    void serialize_i16(std::int16_t value) override;
+    void serialize_i32(std::int32_t value) override;
+    void serialize_i64(std::int64_t value) override;
+    void serialize_u8(std::uint8_t value) override;
+    void serialize_u16(std::uint16_t value) override;
+    void serialize_u32(std::uint32_t value) override;
+    void serialize_u64(std::uint64_t value) override;
+    void serialize_f32(float value) override;
+    void serialize_f64(double value) override;
+    void serialize_char(char value) override;
+    void serialize_string(serde::string_view value) override;
+
+    // Contiguous Sequences of Basic Types
+    void serialize_bool_seq(const bool* values, std::size_t len) override;
+    void serialize_i8_seq(const std::int8_t* values, std::size_t len) override;
+    void serialize_i16_seq(const std::int16_t* values, std::size_t len) override;
+    void serialize_i32_seq(const std::int32_t* values, std::size_t len) override;
+    void serialize_i64_seq(const std::int64_t* values, std::size_t len) override;
+    void serialize_u8_seq(const std::uint8_t* values, std::size_t len) override;
+    void serialize_u16_seq(const std::uint16_t* values, std::size_t len) override;
+    void serialize_u32_seq(const std::uint32_t* values, std::size_t len) override;
+    void serialize_u64_seq(const std::uint64_t* values, std::size_t len) override;
+    void serialize_f32_seq(const float* values, std::size_t len) override;
+    void serialize_f64_seq(const double* values, std::size_t len) override;
+
+    // Byte Blobs
+    void serialize_bytes(const std::uint8_t* data, std::size_t len) override;
+
+    // Unit
+    void serialize_unit() override;
+
+protected:
+    // Lists/Sequences
+    // Use serialize_seq() instead.
+    void seq_begin(std::size_t len) override;
+    void seq_serialize_element(const ser::Serialize & accessor) override;
+    void seq_end() override;
+
+    // Maps
+    // Use serialize_map() instead.
+    void map_begin(std::size_t len) override;
+    void map_serialize_key(const ser::Serialize & key) override;
+    void map_serialize_value(const ser::Serialize & value) override;
+    void map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) override;
+    void map_end() override;
+
+    // Structs
+    // Use serialize_struct() instead.
+    void struct_begin(serde::string_view name, std::size_t len) override;
+    void struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) override;
+    void struct_skip_field(serde::string_view name) override;
+    void struct_end() override;
+
+private:
+    void write_op(serde::Tape::Op op);
+    void write(const void* data, std::size_t len);
+    template <class T>
+    void write_value(serde::Tape::Op op, T value);
+    template <class T>
+    void write_seq(serde::Tape::Op op, const T* values, std::size_t len);
+    void write_string(serde::string_view value);
+    void begin_group(serde::Tape::Op op, std::size_t len);
+    void end_group(serde::Tape::Op op, bool patch_length);
+
+    /// @brief A sequence, map, or struct that has not ended yet
+    struct Group {
+        std::size_t header;  ///< Offset of its end offset and length
+        std::size_t length;  ///< Elements or entries so far
+    };
+
+    serde::Tape & tape;
+    std::vector<Group> groups;
+};
+
+}  // namespace ser
+
+
+namespace de {
+
+/// @brief Reads the first value recorded in a `serde::Tape`
+///
+/// The tape records the type of every value, so like other
+/// self-describing formats, each `deserialize_*()` gives the visitor
+/// whatever was recorded, and the visitor converts it or reports an
+/// error. Strings are borrowed from the tape.
+///
+/// Reading a value that was recorded with the matching
+/// `Serializer::serialize_*_seq()`, such as a `std::vector<int>`,
+/// copies all of its elements at once.
+class TapeDeserializer : public de::Deserializer
+{
+public:
+    /// @brief TapeDeserializer Constructor
+    /// @param tape Tape to read. Must outlive the deserializer.
+    explicit TapeDeserializer(const serde::Tape & tape);
+    bool is_human_readable() const override;
+
+    // Basic Types
+    void deserialize_any(de::Visitor & visitor) override;
+    void deserialize_bool(de::Visitor & visitor) override;
+    void deserialize_i8(de::Visitor & visitor) override;
+    void deserialize_i16(de::Visitor & visitor) override;
+    void deserialize_i32(de::Visitor & visitor) override;
+    void deserialize_i64(de::Visitor & visitor) override;
+    void deserialize_u8(de::Visitor & visitor) override;
+    void deserialize_u16(de::Visitor & visitor) override;
+    void deserialize_u32(de::Visitor & visitor) override;
+    void deserialize_u64(de::Visitor & visitor) override;
+    void deserialize_f32(de::Visitor & visitor) override;
+    void deserialize_f64(de::Visitor & visitor) override;
+    void deserialize_char(de::Visitor & visitor) override;
+    void deserialize_string(de::Visitor & visitor) override;
+    void deserialize_seq(de::Visitor & visitor) override;
+    void deserialize_map(de::Visitor & visitor) override;
+    void deserialize_struct(
+        serde::string_view name,
+        const FieldNames & field_names,
+        de::Visitor & visitor) override;
+    void deserialize_bytes(de::Visitor & visitor) override;
+    void deserialize_ignored_any(de::Visitor & visitor) override;
+
+    class TapeSeqAccess : public de::Deserializer::SeqAccess
+    {
+    public:
+        TapeSeqAccess(const serde::Tape & tape, serde::Tape::Op op, std::size_t position,
+            de::Deserializer & parent);
+        bool has_next() override;
+        std::size_t size_hint() const override;
+        void next_element(de::Deserialize & element) override;
+        std::size_t next_bool_elements(bool* output, std::size_t len) override;
+        std::size_t next_i8_elements(std::int8_t* output, std::size_t len) override;
+        std::size_t next_i16_elements(std::int16_t* output, std::size_t len) override;
+        std::size_t next_i32_elements(std::int32_t* output, std::size_t len) override;
+        std::size_t next_i64_elements(std::int64_t* output, std::size_t len) override;
+        std::size_t next_u8_elements(std::uint8_t* output, std::size_t len) override;
+        std::size_t next_u16_elements(std::uint16_t* output, std::size_t len) override;
+        std::size_t next_u32_elements(std::uint32_t* output, std::size_t len) override;
+        std::size_t next_u64_elements(std::uint64_t* output, std::size_t len) override;
+        std::size_t next_f32_elements(float* output, std::size_t len) override;
+        std::size_t next_f64_elements(double* output, std::size_t len) override;
+    private:
+        template <class T>
+        std::size_t copy_elements(T* output, std::size_t len);
+
+        const serde::Tape & tape;
+        de::Deserializer & parent;
+        serde::Tape::Op element_op;  // For a *Seq, or None if each element has its own
+        std::size_t cursor;
+        std::size_t index = 0;
+        std::size_t remaining;
+    };
+
+    class TapeMapAccess : public de::Deserializer::MapAccess
+    {
+    public:
+        TapeMapAccess(const serde::Tape & tape, serde::Tape::Op op, std::size_t position,
+            de::Deserializer & parent);
+        bool has_next() override;
+        std::size_t size_hint() const override;
+        void next_key(de::Deserialize & key) override;
+        void next_value(de::Deserialize & value) override;
+        void next_entry(de::Deserialize & key, de::Deserialize & value) override;
+    private:
+        void skip_key();
+
+        const serde::Tape & tape;
+        de::Deserializer & parent;
+        bool is_struct;
+        std::size_t cursor;
+        std::size_t index = 0;
+        std::size_t remaining;  // Only for maps
+        bool at_value = false;  // Whether the key has been read
+        serde::string_view key_name;  // Of the current entry, if it is a string
+    };
+
+private:
+    TapeDeserializer(const serde::Tape & tape, serde::Tape::Op op, std::size_t position);
+
+    const serde::Tape & tape;
+    serde::Tape::Op op;  // Of the value being read
+    std::size_t position;  // Of the value, after its op
+};
+
+}  // namespace de
+}  // namespace kingw
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "kingw/ser/templates/stdunorderedmap.hpp"
+#include "kingw/de/templates/stdunorderedmap.hpp"
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "kingw/de/deserializer.hpp"
+#include "kingw/ser/serializer.hpp"
+
+
+namespace kingw {
+namespace serde {
+
+/// @brief Convert data from one format to another, without a C++ type
+///
+/// Reads one value of any type with `Deserializer::deserialize_any()`
+/// and writes it to `serializer` as it is read: each number or string
+/// goes to the matching `serialize_*()`, and each sequence or map is
+/// forwarded element by element through `serialize_seq()` and
+/// `serialize_map()`. Nothing is collected in between, so the memory
+/// used only depends on how deeply the data is nested (plus whatever
+/// the formats themselves hold).
+///
+/// ```
+/// serde_json::JsonDeserializer deserializer(json);
+/// kingw::SPrintfSerializer serializer;
+/// serde::transcode(deserializer, serializer);
+/// ```
+///
+/// The input format must be self-describing, i.e. implement
+/// `deserialize_any()`. Map keys are presented to `serializer` as
+/// strings, since it must know that before the key has been read.
+/// Sequences and maps are started with `Serializer::UNKNOWN_LENGTH`,
+/// since the input's `size_hint()` is not always exact.
+///
+/// Errors are handled as in `de::deserialize()`: thrown, or recorded in
+/// `deserializer` if `throw_on_error()` is off. After an error, the
+/// output of `serializer` is incomplete.
+///
+/// @param deserializer Deserializer to read from
+/// @param serializer Serializer to write to
+void transcode(de::Deserializer & deserializer, ser::Serializer & serializer);
+
+}  // namespace serde
+}  // namespace kingw
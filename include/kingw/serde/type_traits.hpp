@@ -3,10 +3,20 @@
 #include <type_traits>
 #include <string>
 
+#include "kingw/serde/string_view.hpp"
+
 
 namespace kingw {
 namespace serde {
 
+/// @brief Whether `T` is a `std::string` with any allocator,
+/// such as `std::pmr::string`.
+template <class T>
+struct IsStdString : std::false_type {};
+
+template <class A>
+struct IsStdString<std::basic_string<char, std::char_traits<char>, A>> : std::true_type {};
+
 /// @brief Common type information, available dynamically.
 ///
 /// Required by `ser::Serialize` and `de::Deserialize` so `ser::Serializer`
@@ -28,7 +38,8 @@ struct TypeTraits {
         traits.is_integral          = std::is_integral<T>::value;
         traits.is_floating_point    = std::is_floating_point<T>::value;
         traits.is_arithmetic        = std::is_arithmetic<T>::value;
-        traits.is_string            = std::is_same<T, std::string>::value;
+        traits.is_string            = IsStdString<T>::value
+                                    || std::is_same<T, serde::string_view>::value;
         traits.is_class             = std::is_class<T>::value;
         return traits;
     }
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "kingw/serde/string_view.hpp"
+
+
+namespace kingw {
+namespace serde {
+
+struct Member;
+class Document;
+
+/// @brief A value of any type, for data without a fixed schema
+///
+/// Holds whatever `Deserializer::deserialize_any()` finds: null, a bool,
+/// a number, a string, bytes, an array, or an object. A `Value` is only
+/// 16 bytes. Strings of up to 14 bytes are stored inside it, and longer
+/// strings, bytes, and the children of arrays and objects are stored
+/// contiguously in the arena of the `Document` that owns them.
+///
+/// A `Value` does not own anything, so copying one is cheap, and it is
+/// only valid for as long as its `Document` is. Build values that need
+/// memory with the `Document`, e.g. `document.string("text")`.
+class Value {
+public:
+    /// @brief Kind of value
+    enum class Type : std::uint8_t {
+        Null,    ///< No value, such as JSON `null`
+        Bool,    ///< `as_bool()`
+        I64,     ///< `as_i64()`, for negative integers
+        U64,     ///< `as_u64()`, for non-negative integers
+        F64,     ///< `as_f64()`
+        String,  ///< `as_string()`
+        Bytes,   ///< `as_bytes()`
+        Array,   ///< `size()` elements, from `begin()` to `end()`
+        Object,  ///< `size()` members, from `members_begin()` to `members_end()`
+    };
+
+    /// @brief Construct a null value
+    Value() noexcept : storage(), small_length(0), type_(Type::Null) { }
+
+    /// @brief Construct a bool value
+    static Value from_bool(bool value);
+    /// @brief Construct a signed integer value
+    static Value from_i64(std::int64_t value);
+    /// @brief Construct an unsigned integer value
+    static Value from_u64(std::uint64_t value);
+    /// @brief Construct a floating point value
+    static Value from_f64(double value);
+
+    /// @brief Kind of value
+    Type type() const { return type_; }
+
+    bool is_null() const { return type_ == Type::Null; }
+
+    /// @brief Value of a `Type::Bool`
+    bool as_bool() const;
+
+    /// @brief Value of a `Type::I64`, or a `Type::U64` that fits
+    ///
+    /// A `Type::F64` is truncated toward zero. A number that does not fit
+    /// throws `std::out_of_range`. Other types return 0.
+    std::int64_t as_i64() const;
+
+    /// @brief Value of a `Type::U64`, or a non-negative `Type::I64`
+    ///
+    /// A `Type::F64` is truncated toward zero. A number that does not fit
+    /// throws `std::out_of_range`. Other types return 0.
+    std::uint64_t as_u64() const;
+
+    /// @brief Value of any number, converted to double
+    double as_f64() const;
+
+    /// @brief Contents of a `Type::String` or `Type::Bytes`
+    serde::string_view as_string() const;
+
+    /// @brief Contents of a `Type::Bytes` or `Type::String`
+    const std::uint8_t* as_bytes() const;
+
+    /// @brief Number of elements, members, characters, or bytes
+    /// @return 0 for other types
+    std::size_t size() const;
+
+    /// @brief Elements of a `Type::Array`
+    const Value* begin() const;
+    const Value* end() const;
+
+    /// @brief Element of a `Type::Array`
+    /// @param index Must be less than `size()`
+    const Value & operator[](std::size_t index) const { return begin()[index]; }
+
+    /// @brief Members of a `Type::Object`, in their original order
+    const Member* members_begin() const;
+    const Member* members_end() const;
+
+    /// @brief Find the member of a `Type::Object` with a key
+    ///
+    /// Searches linearly, like the small objects this is meant for.
+    ///
+    /// @param key Key to look for
+    /// @return The member's value, or nullptr if there is none
+    const Value* find(serde::string_view key) const;
+
+private:
+    friend class Document;
+
+    /// @brief `small_length` of a string that is in the arena instead
+    constexpr static std::uint8_t NOT_SMALL = 0xFF;
+
+    /// @brief Most characters stored inside the value itself
+    constexpr static std::size_t MAX_SMALL = 14;
+
+    template <class T>
+    static Value number(Type type, T value) {
+        Value result;
+        std::memcpy(result.storage, &value, sizeof(value));
+        result.type_ = type;
+        return result;
+    }
+    template <class T>
+    T number() const {
+        T value;
+        std::memcpy(&value, storage, sizeof(value));
+        return value;
+    }
+    void set_payload(const void* data, std::size_t size) {
+        std::memcpy(storage, &data, sizeof(data));
+        const std::uint32_t length = static_cast<std::uint32_t>(size);
+        std::memcpy(storage + 8, &length, sizeof(length));
+        small_length = NOT_SMALL;
+    }
+    const void* payload_pointer() const {
+        const void* data;
+        std::memcpy(&data, storage, sizeof(data));
+        return data;
+    }
+    std::uint32_t payload_length() const {
+        std::uint32_t length;
+        std::memcpy(&length, storage + 8, sizeof(length));
+        return length;
+    }
+
+    /// @brief A number or pointer in the first 8 bytes, and a length
+    /// in the next 4. Or, a string of up to 14 characters.
+    alignas(8) unsigned char storage[MAX_SMALL];
+
+    /// @brief Length of a string in `storage`, or `NOT_SMALL`
+    std::uint8_t small_length;
+
+    Type type_;
+};
+
+/// @brief A key and value in an object
+struct Member {
+    Value key;
+    Value value;
+};
+
+/// @brief Compares the type and content, recursively
+bool operator==(const Value & lh, const Value & rh);
+
+inline bool operator!=(const Value & lh, const Value & rh) {
+    return !(lh == rh);
+}
+
+/// @brief Owner of a tree of `Value`s
+///
+/// Everything in the tree that doesn't fit inside a `Value` is stored
+/// in this document's arena, which grows in blocks and is freed all at
+/// once. Use `de::deserialize(deserializer, document)` to read any
+/// document, and `ser::serialize(serializer, document)` to write it.
+///
+/// Deserializing into a document replaces its contents, but keeps the
+/// blocks of its arena, so decoding one document after another with
+/// the same `Document` stops allocating once it is big enough.
+class Document {
+public:
+    /// @brief Document Constructor
+    /// @param block_size Size of the first block of the arena, in bytes
+    explicit Document(std::size_t block_size = 4096);
+
+    Document(Document && other) noexcept;
+    Document & operator=(Document && other) noexcept;
+    Document(const Document &) = delete;
+    Document & operator=(const Document &) = delete;
+
+    /// @brief The top-level value, null by default
+    const Value & root() const { return root_; }
+
+    /// @brief Replace the top-level value
+    /// @param value Value that belongs to this document
+    void set_root(const Value & value) { root_ = value; }
+
+    /// @brief Construct a string value, copied into the arena if it is too long
+    Value string(serde::string_view value);
+
+    /// @brief Construct a bytes value, copied into the arena if it is too long
+    Value bytes(const std::uint8_t* data, std::size_t len);
+
+    /// @brief Construct an array value, copying `items` into the arena
+    Value array(const Value* items, std::size_t len);
+
+    /// @brief Construct an object value, copying `members` into the arena
+    Value object(const Member* members, std::size_t len);
+
+    /// @brief Forget every value, but keep the arena's memory for reuse
+    void clear();
+
+    /// @brief Bytes of the arena that are in use
+    std::size_t memory_used() const;
+
+private:
+    friend class DocumentVisitor;
+
+    /// @brief Allocate `size` bytes, aligned for a `Value`
+    void* allocate(std::size_t size);
+
+    /// @brief Construct a string or bytes value
+    Value chars(Value::Type type, const char* data, std::size_t len);
+
+    /// @brief A fixed-size piece of the arena
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    /// @brief Every block allocated so far. Only grows until destruction.
+    std::vector<Block> blocks;
+
+    /// @brief Index of the block being allocated from
+    std::size_t current = 0;
+
+    /// @brief Bytes used in `blocks[current]`
+    std::size_t used = 0;
+
+    /// @brief Size of the next block to allocate
+    std::size_t next_block_size;
+
+    Value root_;
+
+    /// @brief Elements and members of the arrays and objects that are
+    /// still being deserialized. Kept for their capacity.
+    std::vector<Value> value_stack;
+    std::vector<Member> member_stack;
+};
+
+}  // namespace serde
+}  // namespace kingw
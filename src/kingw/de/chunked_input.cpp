@@ -0,0 +1,55 @@
+#include "kingw/de/chunked_input.hpp"
+
+#include <utility>
+
+#include "kingw/serde/exceptions.hpp"
+
+
+namespace kingw {
+namespace de {
+
+ChunkedInput::ChunkedInput(Decode decode, std::size_t stack_size)
+    : fiber([this, decode] { decode(*this); }, stack_size), ended(false) { }
+
+ChunkedInput::~ChunkedInput() {
+    if (fiber.running()) {
+#if KINGW_SERDE_EXCEPTIONS
+        try {
+            finish();
+        } catch (...) {
+            // The decode is abandoned. Nobody is left to report to.
+        }
+#else
+        finish();
+#endif
+    }
+}
+
+bool ChunkedInput::feed(serde::string_view data) {
+    if (data.size() != 0 && !fiber.done()) {
+        chunk = data;
+        fiber.resume();
+    }
+    return fiber.done();
+}
+
+void ChunkedInput::finish() {
+    ended = true;
+    if (!fiber.done()) {
+        fiber.resume();
+    }
+}
+
+bool ChunkedInput::done() const {
+    return fiber.done();
+}
+
+serde::string_view ChunkedInput::next_chunk() {
+    while (chunk.size() == 0 && !ended) {
+        fiber.suspend();
+    }
+    return std::exchange(chunk, serde::string_view());
+}
+
+}  // namespace de
+}  // namespace kingw
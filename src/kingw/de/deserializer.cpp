@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <cstring>
+#include <type_traits>
 
 #include "kingw/de/integral_visitors.hpp"
 
@@ -9,8 +10,63 @@
 namespace kingw {
 namespace de {
 
-DeserializationException::DeserializationException(serde::string_view message)
-    : std::runtime_error(message.data()) { }
+namespace {
+
+// Used when there is no Deserializer to report an error to.
+void raise_unreported(const Error & error) {
+    if (error.code == ErrorCode::NotImplemented) {
+        KINGW_SERDE_THROW(Visitor::NotImplementedException(error.message));
+    } else {
+        KINGW_SERDE_THROW(DeserializationException(error.message, error.code));
+    }
+}
+
+// Whether `value` can be represented as a `To`. Comparing against
+// numeric_limits directly would convert negative values to unsigned.
+template <class To, class From>
+bool in_range(From value) {
+    if (std::is_signed<From>::value && value < From(0)) {
+        return std::is_signed<To>::value
+            && static_cast<std::int64_t>(value) >= static_cast<std::int64_t>(std::numeric_limits<To>::min());
+    }
+    return static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(std::numeric_limits<To>::max());
+}
+
+// Error paths are built back to front, one level at a time.
+void prepend_path(std::string & path, std::size_t index) {
+    if (!path.empty() && path[0] != '[') {
+        path.insert(0, 1, '.');
+    }
+    path.insert(0, "[" + std::to_string(index) + "]");
+}
+void prepend_path(std::string & path, serde::string_view key) {
+    if (!path.empty() && path[0] != '[') {
+        path.insert(0, 1, '.');
+    }
+    path.insert(0, key.data(), key.size());
+}
+
+}  // namespace
+
+DeserializationException::DeserializationException(serde::string_view message, ErrorCode code)
+    : std::runtime_error(message.data()), code_(code) { }
+ErrorCode DeserializationException::code() const {
+    return code_;
+}
+const std::string & DeserializationException::path() const {
+    return path_;
+}
+const char* DeserializationException::what() const noexcept {
+    return what_.empty() ? std::runtime_error::what() : what_.c_str();
+}
+void DeserializationException::add_path(std::size_t index) {
+    prepend_path(path_, index);
+    what_ = path_ + ": " + std::runtime_error::what();
+}
+void DeserializationException::add_path(serde::string_view key) {
+    prepend_path(path_, key);
+    what_ = path_ + ": " + std::runtime_error::what();
+}
 
 Deserializer::FieldNames::FieldNames(std::initializer_list<serde::string_view> init)
     : list(init), begin_(list.begin()), end_(list.end()) {}
@@ -26,26 +82,225 @@ Deserializer::FieldNames::Iterator Deserializer::FieldNames::end() const {
     return end_;
 }
 
+Deserializer::Deserializer()
+    : state(&own_state) { }
+Deserializer::Deserializer(const Deserializer & other)
+    : own_state(*other.state), state(&own_state) { }
+Deserializer & Deserializer::operator=(const Deserializer & other) {
+    own_state = *other.state;
+    state = &own_state;
+    return *this;
+}
+
+void Deserializer::fail(ErrorCode code, const char* message) {
+    if (state->throw_on_error) {
+        raise(Error{ code, message });
+    } else if (!state->error) {
+        state->error = Error{ code, message };  // Keep the first error only
+    }
+}
+bool Deserializer::failed() const {
+    return static_cast<bool>(state->error);
+}
+const Error & Deserializer::error() const {
+    return state->error;
+}
+bool Deserializer::throw_on_error() const {
+    return state->throw_on_error;
+}
+void Deserializer::set_throw_on_error(bool enabled) {
+    state->throw_on_error = enabled;
+}
+bool Deserializer::in_place() const {
+    return state->in_place;
+}
+void Deserializer::set_in_place(bool enabled) {
+    state->in_place = enabled;
+}
+bool Deserializer::trusted() const {
+#if KINGW_SERDE_VALIDATE_TRUSTED
+    return false;
+#else
+    return state->trusted;
+#endif
+}
+void Deserializer::set_trusted(bool enabled) {
+    state->trusted = enabled;
+}
+const FieldMask* Deserializer::field_mask() const {
+    return state->field_mask;
+}
+void Deserializer::set_field_mask(const FieldMask* mask) {
+    state->field_mask = mask;
+}
+void Deserializer::report_to(Deserializer & parent) {
+    state = parent.state;
+}
+void Deserializer::raise(const Error & error) {
+    raise_unreported(error);
+}
+
+void Deserializer::add_error_path(std::size_t index) {
+    if (failed()) {
+        prepend_path(state->error.path, index);
+    }
+}
+void Deserializer::add_error_path(serde::string_view key) {
+    if (failed()) {
+        prepend_path(state->error.path, key);
+    }
+}
+
+// The path is only touched once something fails. If this deserializer
+// had already failed, then the error is not from this element.
+void Deserializer::deserialize_at(std::size_t index, de::Deserialize & output) {
+    const bool failed_before = failed();
+#if KINGW_SERDE_EXCEPTIONS
+    try {
+        output.deserialize(*this);
+    } catch (DeserializationException & e) {
+        e.add_path(index);
+        throw;
+    }
+#else
+    output.deserialize(*this);
+#endif
+    if (!failed_before) {
+        add_error_path(index);
+    }
+}
+void Deserializer::deserialize_at(serde::string_view key, de::Deserialize & output) {
+    const bool failed_before = failed();
+#if KINGW_SERDE_EXCEPTIONS
+    try {
+        output.deserialize(*this);
+    } catch (DeserializationException & e) {
+        e.add_path(key);
+        throw;
+    }
+#else
+    output.deserialize(*this);
+#endif
+    if (!failed_before) {
+        add_error_path(key);
+    }
+}
+
+void Deserializer::deserialize_bytes(de::Visitor & visitor) {
+    deserialize_seq(visitor);
+}
+
+void Deserializer::deserialize_ignored_any(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+
+std::size_t Deserializer::SeqAccess::size_hint() const {
+    return UNKNOWN_LENGTH;
+}
+
+// The default batch implementations use the generic per-element
+// next_elements<T>(). Naming the template argument explicitly keeps
+// overload resolution from picking the non-template overloads below,
+// which would call straight back into these functions.
+std::size_t Deserializer::SeqAccess::next_bool_elements(bool* output, std::size_t len) {
+    return de::next_elements<bool>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_i8_elements(std::int8_t* output, std::size_t len) {
+    return de::next_elements<std::int8_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_i16_elements(std::int16_t* output, std::size_t len) {
+    return de::next_elements<std::int16_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_i32_elements(std::int32_t* output, std::size_t len) {
+    return de::next_elements<std::int32_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_i64_elements(std::int64_t* output, std::size_t len) {
+    return de::next_elements<std::int64_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_u8_elements(std::uint8_t* output, std::size_t len) {
+    return de::next_elements<std::uint8_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_u16_elements(std::uint16_t* output, std::size_t len) {
+    return de::next_elements<std::uint16_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_u32_elements(std::uint32_t* output, std::size_t len) {
+    return de::next_elements<std::uint32_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_u64_elements(std::uint64_t* output, std::size_t len) {
+    return de::next_elements<std::uint64_t>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_f32_elements(float* output, std::size_t len) {
+    return de::next_elements<float>(*this, output, len);
+}
+std::size_t Deserializer::SeqAccess::next_f64_elements(double* output, std::size_t len) {
+    return de::next_elements<double>(*this, output, len);
+}
+
+void Deserializer::SeqAccess::report_to(Deserializer & deserializer) {
+    reporter = &deserializer;
+}
+void Deserializer::SeqAccess::fail(ErrorCode code, const char* message) {
+    if (reporter) {
+        reporter->fail(code, message);
+    } else {
+        raise_unreported(Error{ code, message });
+    }
+}
+bool Deserializer::SeqAccess::failed() const {
+    return reporter && reporter->failed();
+}
+
+std::size_t Deserializer::MapAccess::size_hint() const {
+    return UNKNOWN_LENGTH;
+}
+void Deserializer::MapAccess::report_to(Deserializer & deserializer) {
+    reporter = &deserializer;
+}
+void Deserializer::MapAccess::fail(ErrorCode code, const char* message) {
+    if (reporter) {
+        reporter->fail(code, message);
+    } else {
+        raise_unreported(Error{ code, message });
+    }
+}
+
 Visitor::NotImplementedException::NotImplementedException(serde::string_view message)
-    : DeserializationException(message.data()) { }
+    : DeserializationException(message.data(), ErrorCode::NotImplemented) { }
+
+void Visitor::report_to(Deserializer & deserializer) {
+    reporter = &deserializer;
+}
+void Visitor::fail(ErrorCode code, const char* message) {
+    if (reporter) {
+        reporter->fail(code, message);
+    } else {
+        raise_unreported(Error{ code, message });
+    }
+}
+bool Visitor::trusted() const {
+    return reporter && reporter->trusted();
+}
 
 // Default implementations for unused visitor functions.
-// If they are called when not implemented, throw a runtime exception.
-void Visitor::visit_bool(bool value) { throw NotImplementedException("visitor unexpected type bool"); }
-void Visitor::visit_i8(std::int8_t value) { throw NotImplementedException("visitor unexpected type i8"); }
-void Visitor::visit_i16(std::int16_t value) { throw NotImplementedException("visitor unexpected type i16"); }
-void Visitor::visit_i32(std::int32_t value) { throw NotImplementedException("visitor unexpected type i32"); }
-void Visitor::visit_i64(std::int64_t value) { throw NotImplementedException("visitor unexpected type i64"); }
-void Visitor::visit_u8(std::uint8_t value) { throw NotImplementedException("visitor unexpected type u8"); }
-void Visitor::visit_u16(std::uint16_t value) { throw NotImplementedException("visitor unexpected type u16"); }
-void Visitor::visit_u32(std::uint32_t value) { throw NotImplementedException("visitor unexpected type u32"); }
-void Visitor::visit_u64(std::uint64_t value) { throw NotImplementedException("visitor unexpected type u64"); }
-void Visitor::visit_f32(float value) { throw NotImplementedException("visitor unexpected type f32"); }
-void Visitor::visit_f64(double value) { throw NotImplementedException("visitor unexpected type f64"); }
-void Visitor::visit_char(char value) { throw NotImplementedException("visitor unexpected type char"); }
-void Visitor::visit_string(serde::string_view value) { throw NotImplementedException("visitor unexpected type string"); }
-void Visitor::visit_seq(Deserializer::SeqAccess & value) { throw NotImplementedException("visitor unexpected type seq"); }
-void Visitor::visit_map(Deserializer::MapAccess & value) { throw NotImplementedException("visitor unexpected type map"); }
+// If they are called when not implemented, report ErrorCode::NotImplemented.
+void Visitor::visit_bool(bool) { fail(ErrorCode::NotImplemented, "visitor unexpected type bool"); }
+void Visitor::visit_i8(std::int8_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type i8"); }
+void Visitor::visit_i16(std::int16_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type i16"); }
+void Visitor::visit_i32(std::int32_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type i32"); }
+void Visitor::visit_i64(std::int64_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type i64"); }
+void Visitor::visit_u8(std::uint8_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type u8"); }
+void Visitor::visit_u16(std::uint16_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type u16"); }
+void Visitor::visit_u32(std::uint32_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type u32"); }
+void Visitor::visit_u64(std::uint64_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type u64"); }
+void Visitor::visit_f32(float) { fail(ErrorCode::NotImplemented, "visitor unexpected type f32"); }
+void Visitor::visit_f64(double) { fail(ErrorCode::NotImplemented, "visitor unexpected type f64"); }
+void Visitor::visit_char(char) { fail(ErrorCode::NotImplemented, "visitor unexpected type char"); }
+void Visitor::visit_string(serde::string_view) { fail(ErrorCode::NotImplemented, "visitor unexpected type string"); }
+void Visitor::visit_borrowed_string(serde::string_view value) { visit_string(value); }
+void Visitor::visit_bytes(const std::uint8_t*, std::size_t) { fail(ErrorCode::NotImplemented, "visitor unexpected type bytes"); }
+void Visitor::visit_unit() { fail(ErrorCode::NotImplemented, "visitor unexpected type unit"); }
+void Visitor::visit_seq(Deserializer::SeqAccess &) { fail(ErrorCode::NotImplemented, "visitor unexpected type seq"); }
+void Visitor::visit_map(Deserializer::MapAccess &) { fail(ErrorCode::NotImplemented, "visitor unexpected type map"); }
 
 
 BoolVisitor::BoolVisitor(bool & output) 
@@ -60,7 +315,9 @@ void BoolVisitor::visit_bool(bool value) {
 /// The logic for all number-to-number conversions is similar.
 /// If the value of the OTHER number is within the bounds of SELF,
 /// then it's OK to copy OTHER into SELF.
-/// Otherwise, throw a runtime exception.
+/// Otherwise, report an error, unless the input is trusted, in which
+/// case it is truncated like a static_cast. The range check comes first
+/// since it is cheaper than looking up whether the input is trusted.
 ///
 /// These defines are #undef'd later.
 #define KINGW_NUM_AS_SELF(CLASS, TYPE, FN)                      \
@@ -69,11 +326,10 @@ void BoolVisitor::visit_bool(bool value) {
     }
 #define KINGW_TRY_NUM_INTO_SELF(CLASS, SELF, OTHER, FN)         \
     void CLASS::FN(OTHER value) {                               \
-        if (   value >= std::numeric_limits<SELF>::min()        \
-            && value <= std::numeric_limits<SELF>::max()) {     \
+        if (in_range<SELF>(value) || trusted()) {               \
             output = static_cast<SELF>(value);                  \
         } else {                                                \
-            throw DeserializationException("number outside range"); \
+            fail(ErrorCode::InvalidValue, "number outside range");  \
         }                                                       \
     }
 
@@ -236,7 +492,7 @@ void CharVisitor::visit_string(serde::string_view value) {
     if (value.size() == 1) {
         output = value[0];
     } else {
-        throw DeserializationException("string does not contain exactly one character");
+        fail(ErrorCode::InvalidLength, "string does not contain exactly one character");
     }
 }
 
@@ -246,11 +502,75 @@ const char* StringVisitor::expecting() const {
     return "a string";
 }
 void StringVisitor::visit_string(serde::string_view value) {
-    if (value.size() <= (output_end - output_begin)) {
+    if (value.size() <= static_cast<std::size_t>(output_end - output_begin)) {
         char* copy_end = std::copy(value.begin(), value.end(), output_begin);
         std::fill(copy_end, output_end, '\0');
     } else {
-        throw DeserializationException("deserialized string doesn't fit in fixed-size buffer");
+        fail(ErrorCode::InvalidLength, "deserialized string doesn't fit in fixed-size buffer");
+    }
+}
+
+StringViewVisitor::StringViewVisitor(serde::string_view & output)
+    : output(output) { }
+const char* StringViewVisitor::expecting() const {
+    return "a borrowed string";
+}
+void StringViewVisitor::visit_string(serde::string_view) {
+    fail(ErrorCode::InvalidType, "string is not borrowed from the input and cannot be kept as a string_view");
+}
+void StringViewVisitor::visit_borrowed_string(serde::string_view value) {
+    output = value;
+}
+
+ByteBufVisitor::ByteBufVisitor(serde::ByteBuf & output)
+    : output(output) { }
+const char* ByteBufVisitor::expecting() const {
+    return "a byte array";
+}
+void ByteBufVisitor::visit_bytes(const std::uint8_t* data, std::size_t len) {
+    output.bytes.assign(data, data + len);
+}
+void ByteBufVisitor::visit_seq(Deserializer::SeqAccess & seq) {
+    output.bytes.clear();
+    output.bytes.reserve(de::cautious_size_hint<std::uint8_t>(seq.size_hint()));
+    std::uint8_t batch[256];
+    std::size_t count = 0;
+    do {
+        count = seq.next_u8_elements(batch, sizeof(batch));
+        output.bytes.insert(output.bytes.end(), batch, batch + count);
+    } while (count == sizeof(batch) && seq.has_next());
+}
+
+const char* IgnoredAnyVisitor::expecting() const {
+    return "anything at all";
+}
+void IgnoredAnyVisitor::visit_bool(bool) { }
+void IgnoredAnyVisitor::visit_i8(std::int8_t) { }
+void IgnoredAnyVisitor::visit_i16(std::int16_t) { }
+void IgnoredAnyVisitor::visit_i32(std::int32_t) { }
+void IgnoredAnyVisitor::visit_i64(std::int64_t) { }
+void IgnoredAnyVisitor::visit_u8(std::uint8_t) { }
+void IgnoredAnyVisitor::visit_u16(std::uint16_t) { }
+void IgnoredAnyVisitor::visit_u32(std::uint32_t) { }
+void IgnoredAnyVisitor::visit_u64(std::uint64_t) { }
+void IgnoredAnyVisitor::visit_f32(float) { }
+void IgnoredAnyVisitor::visit_f64(double) { }
+void IgnoredAnyVisitor::visit_char(char) { }
+void IgnoredAnyVisitor::visit_string(serde::string_view) { }
+void IgnoredAnyVisitor::visit_bytes(const std::uint8_t*, std::size_t) { }
+void IgnoredAnyVisitor::visit_unit() { }
+void IgnoredAnyVisitor::visit_seq(Deserializer::SeqAccess & seq) {
+    IgnoredAny ignored;
+    Accessor<IgnoredAny> element(ignored);
+    while (seq.has_next()) {
+        seq.next_element(element);
+    }
+}
+void IgnoredAnyVisitor::visit_map(Deserializer::MapAccess & map) {
+    IgnoredAny ignored;
+    Accessor<IgnoredAny> entry(ignored);
+    while (map.has_next()) {
+        map.next_entry(entry, entry);
     }
 }
 
@@ -260,10 +580,55 @@ const char* StdStringVisitor::expecting() const {
     return "a string";
 }
 void StdStringVisitor::visit_string(serde::string_view value) {
-    output = std::string(value.data(), value.size());
+    output.assign(value.data(), value.size());  // Reuses the existing capacity
+}
+
+#if KINGW_SERDE_PMR
+PmrStringVisitor::PmrStringVisitor(std::pmr::string & output)
+    : output(output) { }
+const char* PmrStringVisitor::expecting() const {
+    return "a string";
 }
+void PmrStringVisitor::visit_string(serde::string_view value) {
+    output.assign(value.data(), value.size());
+}
+#endif
 
 
+std::size_t next_elements(Deserializer::SeqAccess & seq, bool* output, std::size_t len) {
+    return seq.next_bool_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::int8_t* output, std::size_t len) {
+    return seq.next_i8_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::int16_t* output, std::size_t len) {
+    return seq.next_i16_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::int32_t* output, std::size_t len) {
+    return seq.next_i32_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::int64_t* output, std::size_t len) {
+    return seq.next_i64_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::uint8_t* output, std::size_t len) {
+    return seq.next_u8_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::uint16_t* output, std::size_t len) {
+    return seq.next_u16_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::uint32_t* output, std::size_t len) {
+    return seq.next_u32_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, std::uint64_t* output, std::size_t len) {
+    return seq.next_u64_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, float* output, std::size_t len) {
+    return seq.next_f32_elements(output, len);
+}
+std::size_t next_elements(Deserializer::SeqAccess & seq, double* output, std::size_t len) {
+    return seq.next_f64_elements(output, len);
+}
+
 template <>
 void deserialize<Deserialize>(Deserializer & deserializer, Deserialize & accessor) {
     accessor.deserialize(deserializer);
@@ -271,68 +636,107 @@ void deserialize<Deserialize>(Deserializer & deserializer, Deserialize & accesso
 template <>
 void deserialize<bool>(Deserializer & deserializer, bool & data) {
     BoolVisitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_bool(visitor);
 }
 template <>
 void deserialize<std::int8_t>(Deserializer & deserializer, std::int8_t & data) {
     I8Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_i8(visitor);
 }
 template <>
 void deserialize<std::int16_t>(Deserializer & deserializer, std::int16_t & data) {
     I16Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_i16(visitor);
 }
 template <>
 void deserialize<std::int32_t>(Deserializer & deserializer, std::int32_t & data) {
     I32Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_i32(visitor);
 }
 template <>
 void deserialize<std::int64_t>(Deserializer & deserializer, std::int64_t & data) {
     I64Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_i64(visitor);
 }
 template <>
 void deserialize<std::uint8_t>(Deserializer & deserializer, std::uint8_t & data) {
     U8Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_u8(visitor);
 }
 template <>
 void deserialize<std::uint16_t>(Deserializer & deserializer, std::uint16_t & data) {
     U16Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_u16(visitor);
 }
 template <>
 void deserialize<std::uint32_t>(Deserializer & deserializer, std::uint32_t & data) {
     U32Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_u32(visitor);
 }
 template <>
 void deserialize<std::uint64_t>(Deserializer & deserializer, std::uint64_t & data) {
     U64Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_u64(visitor);
 }
 template <>
 void deserialize<float>(Deserializer & deserializer, float & data) {
     F32Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_f32(visitor);
 }
 template <>
 void deserialize<double>(Deserializer & deserializer, double & data) {
     F64Visitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_f64(visitor);
 }
 template <>
 void deserialize<char>(Deserializer & deserializer, char & data) {
     CharVisitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_char(visitor);
 }
 template <>
 void deserialize<std::string>(Deserializer & deserializer, std::string & data) {
     StdStringVisitor visitor(data);
+    visitor.report_to(deserializer);
+    deserializer.deserialize_string(visitor);
+}
+#if KINGW_SERDE_PMR
+template <>
+void deserialize<std::pmr::string>(Deserializer & deserializer, std::pmr::string & data) {
+    PmrStringVisitor visitor(data);
+    visitor.report_to(deserializer);
     deserializer.deserialize_string(visitor);
 }
+#endif
+template <>
+void deserialize<serde::string_view>(Deserializer & deserializer, serde::string_view & data) {
+    StringViewVisitor visitor(data);
+    visitor.report_to(deserializer);
+    deserializer.deserialize_string(visitor);
+}
+template <>
+void deserialize<serde::ByteBuf>(Deserializer & deserializer, serde::ByteBuf & data) {
+    ByteBufVisitor visitor(data);
+    visitor.report_to(deserializer);
+    deserializer.deserialize_bytes(visitor);
+}
+template <>
+void deserialize<IgnoredAny>(Deserializer & deserializer, IgnoredAny &) {
+    IgnoredAnyVisitor visitor;
+    visitor.report_to(deserializer);
+    deserializer.deserialize_ignored_any(visitor);
+}
 
 }  // namespace de
 }  // namespace kingw
@@ -0,0 +1,85 @@
+#include "kingw/de/validate.hpp"
+
+#include "kingw/de/integral_visitors.hpp"
+
+
+namespace kingw {
+namespace de {
+
+namespace {
+
+/// @brief Accepts what `StdStringVisitor` accepts, without copying it
+class ValidateStringVisitor : public de::Visitor {
+public:
+    const char* expecting() const override {
+        return "a string";
+    }
+    void visit_string(serde::string_view) override {
+        // Any string will do.
+    }
+};
+
+/// @brief Accepts what `ByteBufVisitor` accepts, without copying it
+class ValidateBytesVisitor : public de::Visitor {
+public:
+    const char* expecting() const override {
+        return "a byte array";
+    }
+    void visit_bytes(const std::uint8_t*, std::size_t) override {
+        // Any bytes will do.
+    }
+    void visit_seq(de::Deserializer::SeqAccess & seq) override {
+        de::validate_elements<std::uint8_t>(seq);
+    }
+};
+
+}  // namespace
+
+/// Basic types, and types that point into the input instead of
+/// allocating, are validated by deserializing into a local.
+///
+/// This define is #undef'd later.
+#define KINGW_VALIDATE_BY_DESERIALIZING(TYPE)                       \
+    template <>                                                     \
+    void Validator<TYPE>::validate(Deserializer & deserializer) {   \
+        validate_by_deserializing<TYPE>(deserializer);              \
+    }
+
+KINGW_VALIDATE_BY_DESERIALIZING(bool);
+KINGW_VALIDATE_BY_DESERIALIZING(std::int8_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::int16_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::int32_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::int64_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::uint8_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::uint16_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::uint32_t);
+KINGW_VALIDATE_BY_DESERIALIZING(std::uint64_t);
+KINGW_VALIDATE_BY_DESERIALIZING(float);
+KINGW_VALIDATE_BY_DESERIALIZING(double);
+KINGW_VALIDATE_BY_DESERIALIZING(char);
+KINGW_VALIDATE_BY_DESERIALIZING(serde::string_view);
+KINGW_VALIDATE_BY_DESERIALIZING(IgnoredAny);
+
+#undef KINGW_VALIDATE_BY_DESERIALIZING
+
+template <>
+void Validator<std::string>::validate(Deserializer & deserializer) {
+    ValidateStringVisitor visitor;
+    visitor.report_to(deserializer);
+    deserializer.deserialize_string(visitor);
+}
+#if KINGW_SERDE_PMR
+template <>
+void Validator<std::pmr::string>::validate(Deserializer & deserializer) {
+    Validator<std::string>::validate(deserializer);
+}
+#endif
+template <>
+void Validator<serde::ByteBuf>::validate(Deserializer & deserializer) {
+    ValidateBytesVisitor visitor;
+    visitor.report_to(deserializer);
+    deserializer.deserialize_bytes(visitor);
+}
+
+}  // namespace de
+}  // namespace kingw
@@ -1,5 +1,8 @@
 #include "kingw/ser/serializer.hpp"
 
+#include "kingw/serde/bytes.hpp"
+#include "kingw/serde/memory_resource.hpp"
+
 
 namespace kingw {
 namespace ser {
@@ -7,6 +10,52 @@ namespace ser {
 SerializationException::SerializationException(serde::string_view message)
     : std::runtime_error(message.data()) { }
 
+// The default sequence implementations use the generic per-element
+// serialize_array<T>(). Naming the template argument explicitly keeps
+// overload resolution from picking the non-template overloads below,
+// which would call straight back into these functions.
+void Serializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    ser::serialize_array<bool>(*this, values, len);
+}
+void Serializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    ser::serialize_array<std::int8_t>(*this, values, len);
+}
+void Serializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    ser::serialize_array<std::int16_t>(*this, values, len);
+}
+void Serializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    ser::serialize_array<std::int32_t>(*this, values, len);
+}
+void Serializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    ser::serialize_array<std::int64_t>(*this, values, len);
+}
+void Serializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    ser::serialize_array<std::uint8_t>(*this, values, len);
+}
+void Serializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    ser::serialize_array<std::uint16_t>(*this, values, len);
+}
+void Serializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    ser::serialize_array<std::uint32_t>(*this, values, len);
+}
+void Serializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    ser::serialize_array<std::uint64_t>(*this, values, len);
+}
+void Serializer::serialize_f32_seq(const float* values, std::size_t len) {
+    ser::serialize_array<float>(*this, values, len);
+}
+void Serializer::serialize_f64_seq(const double* values, std::size_t len) {
+    ser::serialize_array<double>(*this, values, len);
+}
+
+void Serializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    serialize_u8_seq(data, len);
+}
+
+void Serializer::serialize_unit() {
+    serialize_string(serde::string_view("", 0));
+}
+
 Serializer::SerializeSeq Serializer::serialize_seq(std::size_t len) {
     return SerializeSeq{ *this,  len };
 }
@@ -141,10 +190,54 @@ template <>
 void serialize<std::string>(Serializer & serializer, const std::string & data) {
     serializer.serialize_string(data);
 }
+#if KINGW_SERDE_PMR
+template <>
+void serialize<std::pmr::string>(Serializer & serializer, const std::pmr::string & data) {
+    serializer.serialize_string(serde::string_view(data.data(), data.size()));
+}
+#endif
 template <>
 void serialize<serde::string_view>(Serializer & serializer, const serde::string_view & data) {
     serializer.serialize_string(data);
 }
+template <>
+void serialize<serde::ByteBuf>(Serializer & serializer, const serde::ByteBuf & data) {
+    serializer.serialize_bytes(data.bytes.data(), data.bytes.size());
+}
+
+void serialize_array(Serializer & serializer, const bool* data, std::size_t len) {
+    serializer.serialize_bool_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::int8_t* data, std::size_t len) {
+    serializer.serialize_i8_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::int16_t* data, std::size_t len) {
+    serializer.serialize_i16_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::int32_t* data, std::size_t len) {
+    serializer.serialize_i32_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::int64_t* data, std::size_t len) {
+    serializer.serialize_i64_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::uint8_t* data, std::size_t len) {
+    serializer.serialize_u8_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::uint16_t* data, std::size_t len) {
+    serializer.serialize_u16_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::uint32_t* data, std::size_t len) {
+    serializer.serialize_u32_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const std::uint64_t* data, std::size_t len) {
+    serializer.serialize_u64_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const float* data, std::size_t len) {
+    serializer.serialize_f32_seq(data, len);
+}
+void serialize_array(Serializer & serializer, const double* data, std::size_t len) {
+    serializer.serialize_f64_seq(data, len);
+}
 
 }
 }
@@ -0,0 +1,68 @@
+#include "kingw/ser/size_serializer.hpp"
+
+
+namespace kingw {
+namespace ser {
+
+namespace {
+
+constexpr std::uint64_t POWERS_OF_10[] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+std::size_t bit_length(std::uint64_t value) {
+#if defined(__GNUC__)
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#else
+    std::size_t bits = 0;
+    while (value != 0) {
+        ++bits;
+        value >>= 1;
+    }
+    return bits;
+#endif
+}
+
+}  // namespace
+
+
+std::size_t decimal_length(std::uint64_t value) {
+    if (value == 0) {
+        return 1;
+    }
+    // 1233 / 4096 is just over log10(2). A value with this many bits
+    // has either `digits` or `digits + 1` digits, depending on whether
+    // it reaches the next power of 10.
+    const std::size_t digits = bit_length(value) * 1233 >> 12;
+    return digits + (value < POWERS_OF_10[digits] ? 0 : 1);
+}
+
+std::size_t decimal_length(std::int64_t value) {
+    if (value < 0) {
+        // Negate as unsigned, so that INT64_MIN doesn't overflow.
+        return 1 + decimal_length(0 - static_cast<std::uint64_t>(value));
+    }
+    return decimal_length(static_cast<std::uint64_t>(value));
+}
+
+}  // namespace ser
+}  // namespace kingw
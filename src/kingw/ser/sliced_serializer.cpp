@@ -0,0 +1,238 @@
+#include "kingw/ser/sliced_serializer.hpp"
+
+#include "kingw/serde/exceptions.hpp"
+
+
+namespace kingw {
+namespace ser {
+
+class SlicedSerializer::Forward : public ser::Serialize {
+public:
+    Forward(const ser::Serialize & value, SlicedSerializer & sliced)
+        : value(value), sliced(sliced) { }
+
+    void serialize(ser::Serializer &) const override {
+        // `serializer` is the output. Go through the SlicedSerializer
+        // instead, so that nested values count against the budget too.
+        value.serialize(sliced);
+    }
+
+    serde::TypeTraits traits() const override {
+        return value.traits();
+    }
+
+private:
+    const ser::Serialize & value;
+    SlicedSerializer & sliced;
+};
+
+SlicedSerializer::SlicedSerializer(ser::Serializer & output, Encode encode, SliceBudget budget, std::size_t stack_size)
+    : output(output), budget(budget), fiber([this, encode] { encode(*this); }, stack_size) { }
+
+SlicedSerializer::~SlicedSerializer() {
+    if (fiber.running()) {
+#if KINGW_SERDE_EXCEPTIONS
+        cancelled = true;
+        try {
+            fiber.resume();
+        } catch (...) {
+            // The serialization is abandoned. Nobody is left to report to.
+        }
+#else
+        budget = SliceBudget();
+        fiber.resume();
+#endif
+    }
+}
+
+bool SlicedSerializer::step() {
+    spent = 0;
+    values = 0;
+    const auto now = std::chrono::steady_clock::now();
+    if (budget.time < std::chrono::steady_clock::time_point::max() - now) {
+        deadline = now + budget.time;
+    } else {
+        deadline = std::chrono::steady_clock::time_point::max();
+    }
+    fiber.resume();
+    return fiber.done();
+}
+
+bool SlicedSerializer::done() const {
+    return fiber.done();
+}
+
+void SlicedSerializer::spend(std::size_t bytes) {
+    spent += bytes;
+    if (spent >= budget.bytes
+        || (++values % SliceBudget::TIME_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline))
+    {
+        fiber.suspend();
+        if (cancelled) {
+            KINGW_SERDE_THROW(SerializationException("serialization was abandoned"));
+        }
+    }
+}
+
+bool SlicedSerializer::is_human_readable() const {
+    return output.is_human_readable();
+}
+
+// Basic Types
+void SlicedSerializer::serialize_bool(bool value) {
+    output.serialize_bool(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_i8(std::int8_t value) {
+    output.serialize_i8(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_i16(std::int16_t value) {
+    output.serialize_i16(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_i32(std::int32_t value) {
+    output.serialize_i32(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_i64(std::int64_t value) {
+    output.serialize_i64(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_u8(std::uint8_t value) {
+    output.serialize_u8(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_u16(std::uint16_t value) {
+    output.serialize_u16(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_u32(std::uint32_t value) {
+    output.serialize_u32(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_u64(std::uint64_t value) {
+    output.serialize_u64(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_f32(float value) {
+    output.serialize_f32(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_f64(double value) {
+    output.serialize_f64(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_char(char value) {
+    output.serialize_char(value);
+    spend(sizeof(value));
+}
+void SlicedSerializer::serialize_string(serde::string_view value) {
+    output.serialize_string(value);
+    spend(value.size());
+}
+
+// Contiguous Sequences of Basic Types
+// Forwarded whole, so that `output` keeps its fast path for them.
+void SlicedSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    output.serialize_bool_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    output.serialize_i8_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    output.serialize_i16_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    output.serialize_i32_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    output.serialize_i64_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    output.serialize_u8_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    output.serialize_u16_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    output.serialize_u32_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    output.serialize_u64_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    output.serialize_f32_seq(values, len);
+    spend(len * sizeof(*values));
+}
+void SlicedSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    output.serialize_f64_seq(values, len);
+    spend(len * sizeof(*values));
+}
+
+// Byte Blobs, Unit
+void SlicedSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    output.serialize_bytes(data, len);
+    spend(len);
+}
+void SlicedSerializer::serialize_unit() {
+    output.serialize_unit();
+    spend(0);
+}
+
+// Lists/Sequences
+void SlicedSerializer::seq_begin(std::size_t len) {
+    seqs.emplace_back(output, len);
+}
+void SlicedSerializer::seq_serialize_element(const ser::Serialize & accessor) {
+    seqs.back().serialize_element(Forward(accessor, *this));
+}
+void SlicedSerializer::seq_end() {
+    seqs.back().end();
+    seqs.pop_back();
+}
+
+// Maps
+void SlicedSerializer::map_begin(std::size_t len) {
+    maps.emplace_back(output, len);
+}
+void SlicedSerializer::map_serialize_key(const ser::Serialize & accessor) {
+    maps.back().serialize_key(Forward(accessor, *this));
+}
+void SlicedSerializer::map_serialize_value(const ser::Serialize & accessor) {
+    maps.back().serialize_value(Forward(accessor, *this));
+}
+void SlicedSerializer::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    maps.back().serialize_entry(Forward(key, *this), Forward(value, *this));
+}
+void SlicedSerializer::map_end() {
+    maps.back().end();
+    maps.pop_back();
+}
+
+// Structs
+void SlicedSerializer::struct_begin(serde::string_view name, std::size_t len) {
+    structs.emplace_back(output, name, len);
+}
+void SlicedSerializer::struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) {
+    structs.back().serialize_field(name, Forward(accessor, *this));
+}
+void SlicedSerializer::struct_skip_field(serde::string_view name) {
+    structs.back().skip_field(name);
+}
+void SlicedSerializer::struct_end() {
+    structs.back().end();
+    structs.pop_back();
+}
+
+}  // namespace ser
+}  // namespace kingw
@@ -0,0 +1,328 @@
+#include "kingw/serde/base64.hpp"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KINGW_SERDE_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+
+namespace kingw {
+namespace serde {
+
+namespace {
+
+const char ENCODE_TABLE[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// Maps a character to its 6-bit value, or 0xFF if it isn't in the alphabet.
+struct DecodeTable {
+    DecodeTable() {
+        std::memset(values, 0xFF, sizeof(values));
+        for (std::uint8_t i = 0; i < 64; ++i) {
+            values[static_cast<unsigned char>(ENCODE_TABLE[i])] = i;
+        }
+    }
+    std::uint8_t values[256];
+};
+
+const DecodeTable DECODE_TABLE;
+
+char* encode_scalar(const std::uint8_t* input, std::size_t len, char* output) {
+    std::size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        const std::uint32_t value = (std::uint32_t(input[i]) << 16)
+            | (std::uint32_t(input[i + 1]) << 8) | input[i + 2];
+        *output++ = ENCODE_TABLE[(value >> 18) & 0x3F];
+        *output++ = ENCODE_TABLE[(value >> 12) & 0x3F];
+        *output++ = ENCODE_TABLE[(value >> 6) & 0x3F];
+        *output++ = ENCODE_TABLE[value & 0x3F];
+    }
+    if (len - i == 1) {
+        const std::uint32_t value = std::uint32_t(input[i]) << 16;
+        *output++ = ENCODE_TABLE[(value >> 18) & 0x3F];
+        *output++ = ENCODE_TABLE[(value >> 12) & 0x3F];
+        *output++ = '=';
+        *output++ = '=';
+    } else if (len - i == 2) {
+        const std::uint32_t value = (std::uint32_t(input[i]) << 16)
+            | (std::uint32_t(input[i + 1]) << 8);
+        *output++ = ENCODE_TABLE[(value >> 18) & 0x3F];
+        *output++ = ENCODE_TABLE[(value >> 12) & 0x3F];
+        *output++ = ENCODE_TABLE[(value >> 6) & 0x3F];
+        *output++ = '=';
+    }
+    return output;
+}
+
+bool decode_scalar(const char* input, std::size_t len, std::uint8_t* output, std::size_t & output_len) {
+    // Padding is only allowed to complete the final quantum.
+    if (len % 4 == 0 && len > 0 && input[len - 1] == '=') {
+        --len;
+        if (input[len - 1] == '=') {
+            --len;
+        }
+    }
+    if (len % 4 == 1) {
+        return false;
+    }
+
+    std::uint8_t* const begin = output;
+    const std::uint8_t* table = DECODE_TABLE.values;
+    std::size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        const std::uint8_t a = table[static_cast<unsigned char>(input[i])];
+        const std::uint8_t b = table[static_cast<unsigned char>(input[i + 1])];
+        const std::uint8_t c = table[static_cast<unsigned char>(input[i + 2])];
+        const std::uint8_t d = table[static_cast<unsigned char>(input[i + 3])];
+        if ((a | b | c | d) & 0x80) {
+            return false;
+        }
+        const std::uint32_t value = (std::uint32_t(a) << 18) | (std::uint32_t(b) << 12)
+            | (std::uint32_t(c) << 6) | d;
+        *output++ = static_cast<std::uint8_t>(value >> 16);
+        *output++ = static_cast<std::uint8_t>(value >> 8);
+        *output++ = static_cast<std::uint8_t>(value);
+    }
+    if (len - i >= 2) {
+        const std::uint8_t a = table[static_cast<unsigned char>(input[i])];
+        const std::uint8_t b = table[static_cast<unsigned char>(input[i + 1])];
+        const std::uint8_t c = len - i == 3 ? table[static_cast<unsigned char>(input[i + 2])] : 0;
+        if ((a | b | c) & 0x80) {
+            return false;
+        }
+        const std::uint32_t value = (std::uint32_t(a) << 18) | (std::uint32_t(b) << 12)
+            | (std::uint32_t(c) << 6);
+        // The bits that don't make up a whole byte must be zero,
+        // so that every blob has exactly one encoding.
+        if (value & (len - i == 3 ? 0xFF : 0xFFFF)) {
+            return false;
+        }
+        *output++ = static_cast<std::uint8_t>(value >> 16);
+        if (len - i == 3) {
+            *output++ = static_cast<std::uint8_t>(value >> 8);
+        }
+    }
+    output_len = output - begin;
+    return true;
+}
+
+// The vectorized kernels only handle whole blocks in the middle of the
+// input, and return how much of it they consumed. The scalar functions
+// above finish the rest, including the padding and error reporting.
+using EncodeBlocks = std::size_t (*)(const std::uint8_t* input, std::size_t len, char* output);
+using DecodeBlocks = std::size_t (*)(const char* input, std::size_t len, std::uint8_t* output);
+
+std::size_t encode_blocks_none(const std::uint8_t*, std::size_t, char*) { return 0; }
+std::size_t decode_blocks_none(const char*, std::size_t, std::uint8_t*) { return 0; }
+
+#ifdef KINGW_SERDE_BASE64_X86
+
+// Encoding and decoding follow Wojciech Muła's and Alfred Klomp's
+// SSSE3 algorithms. Each 16-byte lane turns 12 bytes into 16
+// characters, or 16 characters into 12 bytes.
+
+__attribute__((target("ssse3")))
+inline __m128i encode_lookup_ssse3(__m128i indices) {
+    // Reduce each 6-bit index to a small range identifier,
+    // then look up the offset that turns it into ASCII.
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+__attribute__((target("ssse3")))
+std::size_t encode_blocks_ssse3(const std::uint8_t* input, std::size_t len, char* output) {
+    std::size_t consumed = 0;
+    // Each block reads 16 bytes but only consumes 12.
+    for (; consumed + 16 <= len; consumed += 12, output += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + consumed));
+        in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        const __m128i ac = _mm_mulhi_epu16(
+            _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        const __m128i bd = _mm_mullo_epi16(
+            _mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        const __m128i out = encode_lookup_ssse3(_mm_or_si128(ac, bd));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), out);
+    }
+    return consumed;
+}
+
+__attribute__((target("ssse3")))
+std::size_t decode_blocks_ssse3(const char* input, std::size_t len, std::uint8_t* output) {
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+
+    std::size_t consumed = 0;
+    for (; consumed + 16 <= len; consumed += 16, output += 12) {
+        __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + consumed));
+        const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        const __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        // Any character outside the alphabet (including '=') stops the
+        // fast path, and the scalar code decides whether it's an error.
+        const __m128i valid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            break;
+        }
+        const __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+
+        // Pack four 6-bit values into three bytes.
+        const __m128i merged = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        __m128i out = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        out = _mm_shuffle_epi8(out, _mm_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // Only 12 of the 16 bytes are valid, so don't write past the output.
+        alignas(16) std::uint8_t block[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(block), out);
+        std::memcpy(output, block, 12);
+    }
+    return consumed;
+}
+
+__attribute__((target("avx2")))
+std::size_t encode_blocks_avx2(const std::uint8_t* input, std::size_t len, char* output) {
+    std::size_t consumed = 0;
+    // Each block reads bytes [0, 16) and [12, 28) into the two lanes,
+    // but only consumes 24.
+    for (; consumed + 28 <= len; consumed += 24, output += 32) {
+        const std::uint8_t* src = input + consumed;
+        __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12)), 1);
+        in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        const __m256i ac = _mm256_mulhi_epu16(
+            _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+        const __m256i bd = _mm256_mullo_epi16(
+            _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(ac, bd);
+
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        const __m256i offsets = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        const __m256i out = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), out);
+    }
+    return consumed + encode_blocks_ssse3(input + consumed, len - consumed, output);
+}
+
+__attribute__((target("avx2")))
+std::size_t decode_blocks_avx2(const char* input, std::size_t len, std::uint8_t* output) {
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+
+    std::size_t consumed = 0;
+    for (; consumed + 32 <= len; consumed += 32, output += 24) {
+        __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + consumed));
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        const __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+        const __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        const __m256i merged = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        __m256i out = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        out = _mm256_shuffle_epi8(out, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // Move the 12 bytes from each lane next to each other.
+        out = _mm256_permutevar8x32_epi32(out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        alignas(32) std::uint8_t block[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block), out);
+        std::memcpy(output, block, 24);
+    }
+    return consumed + decode_blocks_ssse3(input + consumed, len - consumed, output);
+}
+
+#endif  // KINGW_SERDE_BASE64_X86
+
+/// The fastest kernels this CPU supports.
+struct Kernels {
+    Kernels() : encode(encode_blocks_none), decode(decode_blocks_none) {
+#ifdef KINGW_SERDE_BASE64_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            encode = encode_blocks_avx2;
+            decode = decode_blocks_avx2;
+        } else if (__builtin_cpu_supports("ssse3")) {
+            encode = encode_blocks_ssse3;
+            decode = decode_blocks_ssse3;
+        }
+#endif
+    }
+    EncodeBlocks encode;
+    DecodeBlocks decode;
+};
+
+const Kernels & kernels() {
+    static const Kernels instance;
+    return instance;
+}
+
+}  // namespace
+
+
+std::size_t base64_encoded_size(std::size_t len) {
+    return (len + 2) / 3 * 4;
+}
+
+std::size_t base64_decoded_size(std::size_t len) {
+    return (len + 3) / 4 * 3;
+}
+
+char* base64_encode(const std::uint8_t* input, std::size_t len, char* output) {
+    const std::size_t consumed = kernels().encode(input, len, output);
+    return encode_scalar(input + consumed, len - consumed, output + consumed / 3 * 4);
+}
+
+bool base64_decode(const char* input, std::size_t len, std::uint8_t* output, std::size_t & output_len) {
+    const std::size_t consumed = kernels().decode(input, len, output);
+    std::size_t remaining_len = 0;
+    if (!decode_scalar(input + consumed, len - consumed, output + consumed / 4 * 3, remaining_len)) {
+        return false;
+    }
+    output_len = consumed / 4 * 3 + remaining_len;
+    return true;
+}
+
+}  // namespace serde
+}  // namespace kingw
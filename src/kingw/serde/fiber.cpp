@@ -0,0 +1,200 @@
+#include "kingw/serde/fiber.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "kingw/serde/exceptions.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+// AddressSanitizer has to be told about stack switches, or it reports
+// false errors when an exception unwinds the fiber's stack.
+#if !defined(_WIN32) && defined(__SANITIZE_ADDRESS__)
+#define KINGW_SERDE_ASAN_FIBERS 1
+#elif !defined(_WIN32) && defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define KINGW_SERDE_ASAN_FIBERS 1
+#endif
+#endif
+#if defined(KINGW_SERDE_ASAN_FIBERS)
+#include <sanitizer/common_interface_defs.h>
+#else
+#define KINGW_SERDE_ASAN_FIBERS 0
+#endif
+
+
+namespace kingw {
+namespace serde {
+
+class Fiber::Context {
+public:
+    Context(std::function<void()> body, std::size_t stack_size)
+        : body(std::move(body)), stack_size(stack_size)
+    {
+#if defined(_WIN32)
+        fiber = CreateFiber(stack_size, &Context::entry, this);
+#else
+        allocate_stack();
+        getcontext(&fiber);
+        fiber.uc_stack.ss_sp = stack;
+        fiber.uc_stack.ss_size = this->stack_size;
+        fiber.uc_link = &caller;
+        // makecontext() only passes int arguments, so split the pointer.
+        const std::uint64_t self = reinterpret_cast<std::uintptr_t>(this);
+        makecontext(&fiber, reinterpret_cast<void (*)()>(&Context::entry), 2,
+            static_cast<unsigned>(self >> 32), static_cast<unsigned>(self));
+#endif
+    }
+
+    ~Context() {
+#if defined(_WIN32)
+        DeleteFiber(fiber);
+#else
+        munmap(mapping, mapping_size);
+#endif
+    }
+
+    void resume() {
+        if (finished) {
+            return;
+        }
+        started = true;
+#if defined(_WIN32)
+        caller = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(nullptr);
+        SwitchToFiber(fiber);
+#elif KINGW_SERDE_ASAN_FIBERS
+        void* fake_stack = nullptr;
+        __sanitizer_start_switch_fiber(&fake_stack, stack, stack_size);
+        swapcontext(&caller, &fiber);
+        __sanitizer_finish_switch_fiber(fake_stack, nullptr, nullptr);
+#else
+        swapcontext(&caller, &fiber);
+#endif
+#if KINGW_SERDE_EXCEPTIONS
+        if (exception) {
+            std::rethrow_exception(std::exchange(exception, nullptr));
+        }
+#endif
+    }
+
+    void suspend() {
+#if defined(_WIN32)
+        SwitchToFiber(caller);
+#elif KINGW_SERDE_ASAN_FIBERS
+        void* fake_stack = nullptr;
+        __sanitizer_start_switch_fiber(&fake_stack, caller_stack, caller_stack_size);
+        swapcontext(&fiber, &caller);
+        __sanitizer_finish_switch_fiber(fake_stack, &caller_stack, &caller_stack_size);
+#else
+        swapcontext(&fiber, &caller);
+#endif
+    }
+
+    bool started = false;
+    bool finished = false;
+
+private:
+#if defined(_WIN32)
+    static void CALLBACK entry(void* self) {
+        static_cast<Context*>(self)->run();
+        // A Windows fiber must never return.
+        static_cast<Context*>(self)->suspend();
+    }
+#else
+    // The stack is mapped below an inaccessible guard page, so that
+    // overflowing it faults instead of writing over other memory.
+    // Windows fibers get a guard page from CreateFiber().
+    void allocate_stack() {
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        stack_size = (stack_size + page - 1) / page * page;
+        mapping_size = stack_size + page;
+        void* memory = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            KINGW_SERDE_THROW(std::bad_alloc());
+        }
+        mapping = static_cast<char*>(memory);
+        // Stacks grow down, so the guard page goes first.
+        mprotect(mapping, page, PROT_NONE);
+        stack = mapping + page;
+    }
+
+    static void entry(unsigned high, unsigned low) {
+        const std::uint64_t bits = (static_cast<std::uint64_t>(high) << 32) | low;
+        Context* self = reinterpret_cast<Context*>(static_cast<std::uintptr_t>(bits));
+#if KINGW_SERDE_ASAN_FIBERS
+        __sanitizer_finish_switch_fiber(nullptr, &self->caller_stack, &self->caller_stack_size);
+#endif
+        self->run();
+        // Returning switches to uc_link, the caller of resume().
+#if KINGW_SERDE_ASAN_FIBERS
+        __sanitizer_start_switch_fiber(nullptr, self->caller_stack, self->caller_stack_size);
+#endif
+    }
+#endif
+
+    void run() {
+#if KINGW_SERDE_EXCEPTIONS
+        try {
+            body();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+#else
+        body();
+#endif
+        finished = true;
+    }
+
+    std::function<void()> body;
+    std::size_t stack_size;
+#if KINGW_SERDE_EXCEPTIONS
+    std::exception_ptr exception;
+#endif
+#if defined(_WIN32)
+    void* fiber;
+    void* caller = nullptr;
+#else
+    char* mapping = nullptr;
+    std::size_t mapping_size = 0;
+    char* stack = nullptr;
+    ucontext_t fiber;
+    ucontext_t caller;
+#endif
+#if KINGW_SERDE_ASAN_FIBERS
+    const void* caller_stack = nullptr;
+    std::size_t caller_stack_size = 0;
+#endif
+};
+
+Fiber::Fiber(std::function<void()> body, std::size_t stack_size)
+    : context(new Context(std::move(body), stack_size)) { }
+
+Fiber::~Fiber() = default;
+
+void Fiber::resume() {
+    context->resume();
+}
+
+void Fiber::suspend() {
+    context->suspend();
+}
+
+bool Fiber::running() const {
+    return context->started && !context->finished;
+}
+
+bool Fiber::done() const {
+    return context->finished;
+}
+
+}  // namespace serde
+}  // namespace kingw
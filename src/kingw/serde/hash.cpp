@@ -0,0 +1,527 @@
+#include "kingw/serde/hash.hpp"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KINGW_SERDE_HASH_X86 1
+#include <immintrin.h>
+#endif
+
+
+namespace kingw {
+namespace serde {
+
+namespace {
+
+constexpr std::uint64_t PRIME32_1 = 0x9E3779B1U;
+constexpr std::uint64_t PRIME32_2 = 0x85EBCA77U;
+constexpr std::uint64_t PRIME32_3 = 0xC2B2AE3DU;
+constexpr std::uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+/// Keys for a seed of 0. Other seeds are added to or subtracted from them.
+constexpr std::uint64_t SECRET[16] = {
+    0xCA47D49221EF89DBULL, 0xBDACAB3506EC4890ULL, 0xDF0FE75A61889321ULL, 0xA9522667DBF6426CULL,
+    0x36F87DA8BAFF35E8ULL, 0x9C2A60122C9AA798ULL, 0x122700C30289A5D0ULL, 0x3EE4BCF2D907B91AULL,
+    0x67575A1BE5599B50ULL, 0xC3140086840E66D2ULL, 0x4440C676A7D9CEC7ULL, 0x4871EAC09FFD49A0ULL,
+    0x4F7D68710927288EULL, 0x3668CCD161BC60EAULL, 0xEC642D51A60ADC8FULL, 0x904604AA6C601944ULL,
+};
+
+/// Stripes between scrambles. Each stripe uses the keys one further along.
+constexpr std::size_t STRIPES_PER_BLOCK = 8;
+
+inline std::uint64_t read_le64(const std::uint8_t* input) {
+    std::uint64_t value;
+    std::memcpy(&value, input, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+inline std::uint64_t mul128_fold64(std::uint64_t lhs, std::uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 product = static_cast<uint128>(lhs) * rhs;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+    const std::uint64_t lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+    const std::uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+    const std::uint64_t lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+    const std::uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+    const std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    const std::uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    const std::uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+inline std::uint64_t avalanche(std::uint64_t hash) {
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9ULL;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/// Keeps the accumulators from growing only in their high bits.
+inline void scramble(std::uint64_t* acc, const std::uint64_t* secret) {
+    for (std::size_t i = 0; i < 8; ++i) {
+        std::uint64_t value = acc[i];
+        value ^= value >> 47;
+        value ^= secret[8 + i];
+        value *= PRIME32_1;
+        acc[i] = value;
+    }
+}
+
+inline void accumulate_stripe_scalar(std::uint64_t* acc, const std::uint8_t* input, const std::uint64_t* key) {
+    for (std::size_t i = 0; i < 8; ++i) {
+        const std::uint64_t data = read_le64(input + 8 * i);
+        const std::uint64_t keyed = data ^ key[i];
+        acc[i ^ 1] += data;
+        acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+}
+
+/// Mix `stripes` whole stripes into the accumulators.
+/// `stripe` counts the stripes since the last scramble.
+void accumulate_scalar(std::uint64_t* acc, const std::uint8_t* input,
+    std::size_t stripes, const std::uint64_t* secret, std::size_t & stripe)
+{
+    for (std::size_t n = 0; n < stripes; ++n) {
+        accumulate_stripe_scalar(acc, input + n * Hasher::STRIPE_SIZE, secret + stripe);
+        if (++stripe == STRIPES_PER_BLOCK) {
+            scramble(acc, secret);
+            stripe = 0;
+        }
+    }
+}
+
+#ifdef KINGW_SERDE_HASH_X86
+
+__attribute__((target("sse2")))
+void accumulate_sse2(std::uint64_t* acc, const std::uint8_t* input,
+    std::size_t stripes, const std::uint64_t* secret, std::size_t & stripe)
+{
+    // The accumulators may be any output buffer, so they are not assumed aligned.
+    __m128i* lanes = reinterpret_cast<__m128i*>(acc);
+    for (std::size_t n = 0; n < stripes; ++n) {
+        const std::uint8_t* stripe_input = input + n * Hasher::STRIPE_SIZE;
+        const std::uint64_t* key = secret + stripe;
+        for (std::size_t i = 0; i < 4; ++i) {
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe_input) + i);
+            const __m128i keyed = _mm_xor_si128(data,
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + i));
+            // Low 32 bits of each lane times its high 32 bits.
+            const __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, 0x31));
+            // Each lane also gets the data of its neighbour.
+            const __m128i swapped = _mm_shuffle_epi32(data, 0x4E);
+            _mm_storeu_si128(lanes + i,
+                _mm_add_epi64(_mm_loadu_si128(lanes + i), _mm_add_epi64(product, swapped)));
+        }
+        if (++stripe == STRIPES_PER_BLOCK) {
+            scramble(acc, secret);
+            stripe = 0;
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void accumulate_avx2(std::uint64_t* acc, const std::uint8_t* input,
+    std::size_t stripes, const std::uint64_t* secret, std::size_t & stripe)
+{
+    // The accumulators may be any output buffer, so they are not assumed aligned.
+    __m256i* lanes = reinterpret_cast<__m256i*>(acc);
+    for (std::size_t n = 0; n < stripes; ++n) {
+        const std::uint8_t* stripe_input = input + n * Hasher::STRIPE_SIZE;
+        const std::uint64_t* key = secret + stripe;
+        for (std::size_t i = 0; i < 2; ++i) {
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe_input) + i);
+            const __m256i keyed = _mm256_xor_si256(data,
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + i));
+            const __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, 0x31));
+            const __m256i swapped = _mm256_shuffle_epi32(data, 0x4E);
+            _mm256_storeu_si256(lanes + i,
+                _mm256_add_epi64(_mm256_loadu_si256(lanes + i), _mm256_add_epi64(product, swapped)));
+        }
+        if (++stripe == STRIPES_PER_BLOCK) {
+            scramble(acc, secret);
+            stripe = 0;
+        }
+    }
+}
+
+#endif  // KINGW_SERDE_HASH_X86
+
+/// Which kernels this CPU supports.
+struct Kernels {
+    Kernels() : sse2(false), avx2(false) {
+#ifdef KINGW_SERDE_HASH_X86
+        __builtin_cpu_init();
+        sse2 = __builtin_cpu_supports("sse2");
+        avx2 = __builtin_cpu_supports("avx2");
+#endif
+    }
+    bool sse2;
+    bool avx2;
+};
+
+const Kernels & kernels() {
+    static const Kernels instance;
+    return instance;
+}
+
+}  // namespace
+
+
+Hasher::Hasher(std::uint64_t seed)
+    : Hasher(seed, supported(HashKernel::AVX2) ? HashKernel::AVX2 : HashKernel::SSE2) { }
+
+Hasher::Hasher(std::uint64_t seed, HashKernel kernel) : accumulate(accumulate_scalar) {
+    if (supported(kernel)) {
+        switch (kernel) {
+        case HashKernel::Scalar:
+            break;
+#ifdef KINGW_SERDE_HASH_X86
+        case HashKernel::SSE2:
+            accumulate = accumulate_sse2;
+            break;
+        case HashKernel::AVX2:
+            accumulate = accumulate_avx2;
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+    reset(seed);
+}
+
+bool Hasher::supported(HashKernel kernel) {
+    switch (kernel) {
+    case HashKernel::Scalar:
+        return true;
+    case HashKernel::SSE2:
+        return kernels().sse2;
+    case HashKernel::AVX2:
+        return kernels().avx2;
+    }
+    return false;
+}
+
+void Hasher::reset(std::uint64_t seed) {
+    acc[0] = PRIME32_3;
+    acc[1] = PRIME64_1;
+    acc[2] = PRIME64_2;
+    acc[3] = PRIME64_3;
+    acc[4] = PRIME64_4;
+    acc[5] = PRIME32_2;
+    acc[6] = PRIME64_5;
+    acc[7] = PRIME32_1;
+    for (std::size_t i = 0; i < 16; i += 2) {
+        secret[i] = SECRET[i] + seed;
+        secret[i + 1] = SECRET[i + 1] - seed;
+    }
+    buffered = 0;
+    stripe = 0;
+    total = 0;
+}
+
+void Hasher::update_stripes(const std::uint8_t* data, std::size_t len) {
+    total += len;
+
+    // Complete the buffered stripe first.
+    if (buffered > 0) {
+        const std::size_t fill = STRIPE_SIZE - buffered;
+        std::memcpy(buffer + buffered, data, fill);
+        accumulate(acc, buffer, 1, secret, stripe);
+        data += fill;
+        len -= fill;
+        buffered = 0;
+    }
+
+    // Then hash whole stripes straight from the input,
+    // and buffer whatever is left.
+    const std::size_t stripes = len / STRIPE_SIZE;
+    accumulate(acc, data, stripes, secret, stripe);
+    data += stripes * STRIPE_SIZE;
+    len -= stripes * STRIPE_SIZE;
+    std::memcpy(buffer, data, len);
+    buffered = len;
+}
+
+void Hasher::finish(std::uint64_t (&output)[8]) const {
+    std::memcpy(output, acc, sizeof(output));
+    if (buffered > 0) {
+        // The zero padding is told apart by the total length.
+        std::uint8_t last[STRIPE_SIZE] = {};
+        std::memcpy(last, buffer, buffered);
+        std::size_t last_stripe = stripe;
+        accumulate(output, last, 1, secret, last_stripe);
+    }
+}
+
+std::uint64_t Hasher::digest() const {
+    alignas(32) std::uint64_t merged[8];
+    finish(merged);
+    std::uint64_t result = total * PRIME64_1;
+    for (std::size_t i = 0; i < 4; ++i) {
+        result += mul128_fold64(merged[2 * i] ^ secret[2 * i + 3], merged[2 * i + 1] ^ secret[2 * i + 4]);
+    }
+    return avalanche(result);
+}
+
+Hash128 Hasher::digest128() const {
+    alignas(32) std::uint64_t merged[8];
+    finish(merged);
+    std::uint64_t low = total * PRIME64_1;
+    std::uint64_t high = ~(total * PRIME64_2);
+    for (std::size_t i = 0; i < 4; ++i) {
+        low += mul128_fold64(merged[2 * i] ^ secret[2 * i + 3], merged[2 * i + 1] ^ secret[2 * i + 4]);
+        high += mul128_fold64(merged[2 * i] ^ secret[(2 * i + 11) % 16], merged[2 * i + 1] ^ secret[(2 * i + 12) % 16]);
+    }
+    return Hash128{ avalanche(low), avalanche(high) };
+}
+
+}  // namespace serde
+
+
+namespace ser {
+
+namespace {
+
+/// Added before each value, so that values of different types,
+/// and the boundaries of sequences, maps and structs, never look alike.
+enum Tag : std::uint8_t {
+    Bool = 1, I8, I16, I32, I64, U8, U16, U32, U64, F32, F64, Char,
+    String, Bytes, Unit,
+    SeqBegin, SeqEnd,
+    MapBegin, MapEnd,
+    StructBegin, StructField, StructEnd,
+};
+
+/// Write a tag, then an integer of sizeof(T) bytes in little-endian order.
+template <class T>
+std::size_t encode(std::uint8_t* output, std::uint8_t tag, T value) {
+    output[0] = tag;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        output[1 + i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8 * i));
+    }
+    return 1 + sizeof(T);
+}
+
+std::uint32_t bits_of(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+std::uint64_t bits_of(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/// Integers are written as their unsigned bits.
+template <class T> T bits_of(T value) { return value; }
+
+}  // namespace
+
+
+HashSerializer::HashSerializer(serde::Hasher & hasher, bool human_readable)
+    : hasher(hasher), human_readable(human_readable) { }
+
+bool HashSerializer::is_human_readable() const {
+    return human_readable;
+}
+
+template <class T>
+void HashSerializer::write_value(std::uint8_t tag, T value) {
+    std::uint8_t encoded[1 + sizeof(T)];
+    hasher.update(encoded, encode(encoded, tag, value));
+}
+
+template <class T>
+void HashSerializer::write_seq(std::uint8_t tag, const T* values, std::size_t len) {
+    // Same bytes as serializing each element on its own,
+    // but encoded a batch at a time, with one update() per batch.
+    constexpr std::size_t BATCH = 64;
+    std::uint8_t encoded[BATCH * (1 + sizeof(T))];
+    const std::uint8_t seq_begin_tag = Tag::SeqBegin;
+    hasher.update(&seq_begin_tag, 1);
+    for (std::size_t i = 0; i < len; i += BATCH) {
+        const std::size_t count = len - i < BATCH ? len - i : BATCH;
+        std::size_t size = 0;
+        for (std::size_t j = 0; j < count; ++j) {
+            size += encode(encoded + size, tag, bits_of(values[i + j]));
+        }
+        hasher.update(encoded, size);
+    }
+    const std::uint8_t seq_end_tag = Tag::SeqEnd;
+    hasher.update(&seq_end_tag, 1);
+}
+
+void HashSerializer::write_string(std::uint8_t tag, serde::string_view value) {
+    write_value(tag, static_cast<std::uint64_t>(value.size()));
+    hasher.update(value.data(), value.size());
+}
+
+void HashSerializer::serialize_bool(bool value) {
+    write_value(Tag::Bool, static_cast<std::uint8_t>(value));
+}
+void HashSerializer::serialize_i8(std::int8_t value) {
+    write_value(Tag::I8, static_cast<std::uint8_t>(value));
+}
+void HashSerializer::serialize_i16(std::int16_t value) {
+    write_value(Tag::I16, static_cast<std::uint16_t>(value));
+}
+void HashSerializer::serialize_i32(std::int32_t value) {
+    write_value(Tag::I32, static_cast<std::uint32_t>(value));
+}
+void HashSerializer::serialize_i64(std::int64_t value) {
+    write_value(Tag::I64, static_cast<std::uint64_t>(value));
+}
+void HashSerializer::serialize_u8(std::uint8_t value) {
+    write_value(Tag::U8, value);
+}
+void HashSerializer::serialize_u16(std::uint16_t value) {
+    write_value(Tag::U16, value);
+}
+void HashSerializer::serialize_u32(std::uint32_t value) {
+    write_value(Tag::U32, value);
+}
+void HashSerializer::serialize_u64(std::uint64_t value) {
+    write_value(Tag::U64, value);
+}
+void HashSerializer::serialize_f32(float value) {
+    write_value(Tag::F32, bits_of(value));
+}
+void HashSerializer::serialize_f64(double value) {
+    write_value(Tag::F64, bits_of(value));
+}
+void HashSerializer::serialize_char(char value) {
+    write_value(Tag::Char, static_cast<std::uint8_t>(value));
+}
+void HashSerializer::serialize_string(serde::string_view value) {
+    write_string(Tag::String, value);
+}
+
+void HashSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    write_seq(Tag::Bool, reinterpret_cast<const std::uint8_t*>(values), len);
+}
+void HashSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    write_seq(Tag::I8, reinterpret_cast<const std::uint8_t*>(values), len);
+}
+void HashSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    write_seq(Tag::I16, reinterpret_cast<const std::uint16_t*>(values), len);
+}
+void HashSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    write_seq(Tag::I32, reinterpret_cast<const std::uint32_t*>(values), len);
+}
+void HashSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    write_seq(Tag::I64, reinterpret_cast<const std::uint64_t*>(values), len);
+}
+void HashSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    write_seq(Tag::U8, values, len);
+}
+void HashSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    write_seq(Tag::U16, values, len);
+}
+void HashSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    write_seq(Tag::U32, values, len);
+}
+void HashSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    write_seq(Tag::U64, values, len);
+}
+void HashSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    write_seq(Tag::F32, values, len);
+}
+void HashSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    write_seq(Tag::F64, values, len);
+}
+
+void HashSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    write_string(Tag::Bytes, serde::string_view(reinterpret_cast<const char*>(data), len));
+}
+
+void HashSerializer::serialize_unit() {
+    const std::uint8_t tag = Tag::Unit;
+    hasher.update(&tag, 1);
+}
+
+
+///
+/// Sequences
+///
+
+void HashSerializer::seq_begin(std::size_t) {
+    const std::uint8_t tag = Tag::SeqBegin;
+    hasher.update(&tag, 1);
+}
+
+void HashSerializer::seq_serialize_element(const ser::Serialize & accessor) {
+    accessor.serialize(*this);
+}
+
+void HashSerializer::seq_end() {
+    const std::uint8_t tag = Tag::SeqEnd;
+    hasher.update(&tag, 1);
+}
+
+
+///
+/// Maps
+///
+
+void HashSerializer::map_begin(std::size_t) {
+    const std::uint8_t tag = Tag::MapBegin;
+    hasher.update(&tag, 1);
+}
+
+void HashSerializer::map_serialize_key(const ser::Serialize & key) {
+    key.serialize(*this);
+}
+
+void HashSerializer::map_serialize_value(const ser::Serialize & value) {
+    value.serialize(*this);
+}
+
+void HashSerializer::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    key.serialize(*this);
+    value.serialize(*this);
+}
+
+void HashSerializer::map_end() {
+    const std::uint8_t tag = Tag::MapEnd;
+    hasher.update(&tag, 1);
+}
+
+
+///
+/// Structs
+///
+
+void HashSerializer::struct_begin(serde::string_view, std::size_t) {
+    const std::uint8_t tag = Tag::StructBegin;
+    hasher.update(&tag, 1);
+}
+
+void HashSerializer::struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) {
+    write_string(Tag::StructField, name);
+    accessor.serialize(*this);
+}
+
+void HashSerializer::struct_skip_field(serde::string_view) {
+    // Skipped fields are left out, like in most formats.
+}
+
+void HashSerializer::struct_end() {
+    const std::uint8_t tag = Tag::StructEnd;
+    hasher.update(&tag, 1);
+}
+
+}  // namespace ser
+}  // namespace kingw
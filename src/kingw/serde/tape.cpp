@@ -0,0 +1,748 @@
+#include "kingw/serde/tape.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "kingw/de/validate.hpp"
+#include "kingw/serde/exceptions.hpp"
+#include "kingw/serde/transcode.hpp"
+
+
+namespace kingw {
+
+namespace {
+
+using Op = serde::Tape::Op;
+
+/// @brief Alignment of the elements of a `*Seq`, enough for any basic type
+constexpr std::size_t SEQ_ALIGNMENT = 8;
+
+template <class T>
+T read(const unsigned char* data, std::size_t position) {
+    T value;
+    std::memcpy(&value, data + position, sizeof(value));
+    return value;
+}
+
+serde::string_view read_string(const unsigned char* data, std::size_t position) {
+    const std::size_t len = read<std::size_t>(data, position);
+    return serde::string_view(reinterpret_cast<const char*>(data) + position + sizeof(std::size_t), len);
+}
+
+std::size_t string_end(const unsigned char* data, std::size_t position) {
+    return position + sizeof(std::size_t) + read<std::size_t>(data, position);
+}
+
+/// @brief Offset of the first element of a `*Seq`
+std::size_t seq_elements(std::size_t position) {
+    const std::size_t start = position + sizeof(std::size_t);
+    return (start + SEQ_ALIGNMENT - 1) / SEQ_ALIGNMENT * SEQ_ALIGNMENT;
+}
+
+/// @brief Op of the elements of a `*Seq`
+Op seq_element_op(Op seq) {
+    return static_cast<Op>(static_cast<int>(seq) - static_cast<int>(Op::BoolSeq) + static_cast<int>(Op::Bool));
+}
+
+bool is_basic_seq(Op op) {
+    return op >= Op::BoolSeq && op <= Op::F64Seq;
+}
+
+std::size_t basic_size(Op op) {
+    switch (op) {
+    case Op::Bool: return sizeof(bool);
+    case Op::I8: return sizeof(std::int8_t);
+    case Op::I16: return sizeof(std::int16_t);
+    case Op::I32: return sizeof(std::int32_t);
+    case Op::I64: return sizeof(std::int64_t);
+    case Op::U8: return sizeof(std::uint8_t);
+    case Op::U16: return sizeof(std::uint16_t);
+    case Op::U32: return sizeof(std::uint32_t);
+    case Op::U64: return sizeof(std::uint64_t);
+    case Op::F32: return sizeof(float);
+    case Op::F64: return sizeof(double);
+    case Op::Char: return sizeof(char);
+    default: return 0;
+    }
+}
+
+/// @brief Offset past the value at `position`, whose op is `op`
+///
+/// Sequences, maps, and structs store where they end, so this never
+/// has to look at what is inside them.
+std::size_t skip(const unsigned char* data, Op op, std::size_t position) {
+    switch (op) {
+    case Op::String:
+    case Op::Bytes:
+        return string_end(data, position);
+    case Op::SeqBegin:
+    case Op::MapBegin:
+    case Op::StructBegin:
+        return read<std::size_t>(data, position);
+    default:
+        if (is_basic_seq(op)) {
+            return seq_elements(position) + read<std::size_t>(data, position) * basic_size(seq_element_op(op));
+        }
+        return position + basic_size(op);
+    }
+}
+
+template <class T>
+const T* seq_data(const unsigned char* data, std::size_t position) {
+    return reinterpret_cast<const T*>(data + seq_elements(position));
+}
+
+void replay(const unsigned char* data, Op op, std::size_t position, ser::Serializer & serializer);
+
+/// @brief One recorded value, replayed when it is serialized
+class TapeValue : public ser::Serialize {
+public:
+    TapeValue(const unsigned char* data, Op op, std::size_t position)
+        : data(data), op(op), position(position) { }
+    void serialize(ser::Serializer & serializer) const override {
+        replay(data, op, position, serializer);
+    }
+    serde::TypeTraits traits() const override {
+        switch (op) {
+        case Op::Bool: return serde::TypeTraits::of<bool>();
+        case Op::I8: return serde::TypeTraits::of<std::int8_t>();
+        case Op::I16: return serde::TypeTraits::of<std::int16_t>();
+        case Op::I32: return serde::TypeTraits::of<std::int32_t>();
+        case Op::I64: return serde::TypeTraits::of<std::int64_t>();
+        case Op::U8: return serde::TypeTraits::of<std::uint8_t>();
+        case Op::U16: return serde::TypeTraits::of<std::uint16_t>();
+        case Op::U32: return serde::TypeTraits::of<std::uint32_t>();
+        case Op::U64: return serde::TypeTraits::of<std::uint64_t>();
+        case Op::F32: return serde::TypeTraits::of<float>();
+        case Op::F64: return serde::TypeTraits::of<double>();
+        case Op::Char: return serde::TypeTraits::of<char>();
+        case Op::String: return serde::TypeTraits::of<serde::string_view>();
+        case Op::Unit: return serde::TypeTraits();
+        default: return serde::TypeTraits::of<serde::Tape>();
+        }
+    }
+private:
+    const unsigned char* data;
+    Op op;
+    std::size_t position;
+};
+
+void replay(const unsigned char* data, Op op, std::size_t position, ser::Serializer & serializer) {
+    switch (op) {
+    case Op::Bool: serializer.serialize_bool(read<bool>(data, position)); break;
+    case Op::I8: serializer.serialize_i8(read<std::int8_t>(data, position)); break;
+    case Op::I16: serializer.serialize_i16(read<std::int16_t>(data, position)); break;
+    case Op::I32: serializer.serialize_i32(read<std::int32_t>(data, position)); break;
+    case Op::I64: serializer.serialize_i64(read<std::int64_t>(data, position)); break;
+    case Op::U8: serializer.serialize_u8(read<std::uint8_t>(data, position)); break;
+    case Op::U16: serializer.serialize_u16(read<std::uint16_t>(data, position)); break;
+    case Op::U32: serializer.serialize_u32(read<std::uint32_t>(data, position)); break;
+    case Op::U64: serializer.serialize_u64(read<std::uint64_t>(data, position)); break;
+    case Op::F32: serializer.serialize_f32(read<float>(data, position)); break;
+    case Op::F64: serializer.serialize_f64(read<double>(data, position)); break;
+    case Op::Char: serializer.serialize_char(read<char>(data, position)); break;
+    case Op::String: serializer.serialize_string(read_string(data, position)); break;
+    case Op::Bytes: {
+        const serde::string_view bytes = read_string(data, position);
+        serializer.serialize_bytes(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+        break;
+    }
+    case Op::Unit: serializer.serialize_unit(); break;
+
+    case Op::BoolSeq: serializer.serialize_bool_seq(seq_data<bool>(data, position), read<std::size_t>(data, position)); break;
+    case Op::I8Seq: serializer.serialize_i8_seq(seq_data<std::int8_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::I16Seq: serializer.serialize_i16_seq(seq_data<std::int16_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::I32Seq: serializer.serialize_i32_seq(seq_data<std::int32_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::I64Seq: serializer.serialize_i64_seq(seq_data<std::int64_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::U8Seq: serializer.serialize_u8_seq(seq_data<std::uint8_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::U16Seq: serializer.serialize_u16_seq(seq_data<std::uint16_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::U32Seq: serializer.serialize_u32_seq(seq_data<std::uint32_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::U64Seq: serializer.serialize_u64_seq(seq_data<std::uint64_t>(data, position), read<std::size_t>(data, position)); break;
+    case Op::F32Seq: serializer.serialize_f32_seq(seq_data<float>(data, position), read<std::size_t>(data, position)); break;
+    case Op::F64Seq: serializer.serialize_f64_seq(seq_data<double>(data, position), read<std::size_t>(data, position)); break;
+
+    case Op::SeqBegin: {
+        auto seq = serializer.serialize_seq(read<std::size_t>(data, position + sizeof(std::size_t)));
+        std::size_t cursor = position + 2 * sizeof(std::size_t);
+        while (static_cast<Op>(data[cursor]) != Op::SeqEnd) {
+            const Op element = static_cast<Op>(data[cursor]);
+            seq.serialize_element(TapeValue(data, element, cursor + 1));
+            cursor = skip(data, element, cursor + 1);
+        }
+        seq.end();
+        break;
+    }
+    case Op::MapBegin: {
+        auto map = serializer.serialize_map(read<std::size_t>(data, position + sizeof(std::size_t)));
+        std::size_t cursor = position + 2 * sizeof(std::size_t);
+        while (static_cast<Op>(data[cursor]) != Op::MapEnd) {
+            const Op key = static_cast<Op>(data[cursor]);
+            map.serialize_key(TapeValue(data, key, cursor + 1));
+            cursor = skip(data, key, cursor + 1);
+            const Op value = static_cast<Op>(data[cursor]);
+            map.serialize_value(TapeValue(data, value, cursor + 1));
+            cursor = skip(data, value, cursor + 1);
+        }
+        map.end();
+        break;
+    }
+    case Op::StructBegin: {
+        const std::size_t name_position = position + 2 * sizeof(std::size_t);
+        auto state = serializer.serialize_struct(read_string(data, name_position),
+            read<std::size_t>(data, position + sizeof(std::size_t)));
+        std::size_t cursor = string_end(data, name_position);
+        while (static_cast<Op>(data[cursor]) != Op::StructEnd) {
+            const serde::string_view name = read_string(data, cursor + 1);
+            const bool skipped = static_cast<Op>(data[cursor]) == Op::StructSkipField;
+            cursor = string_end(data, cursor + 1);
+            if (skipped) {
+                state.skip_field(name);
+            } else {
+                const Op value = static_cast<Op>(data[cursor]);
+                state.serialize_field(name, TapeValue(data, value, cursor + 1));
+                cursor = skip(data, value, cursor + 1);
+            }
+        }
+        state.end();
+        break;
+    }
+
+    default:
+        // Only a tape that was modified after recording gets here.
+        KINGW_SERDE_THROW(ser::SerializationException("tape is corrupt"));
+    }
+}
+
+}  // namespace
+
+
+namespace ser {
+
+TapeSerializer::TapeSerializer(serde::Tape & tape, bool human_readable)
+    : tape(tape)
+{
+    tape.human_readable = human_readable;
+}
+
+bool TapeSerializer::is_human_readable() const {
+    return tape.human_readable;
+}
+
+void TapeSerializer::write_op(Op op) {
+    tape.bytes.push_back(static_cast<unsigned char>(op));
+}
+
+void TapeSerializer::write(const void* data, std::size_t len) {
+    const std::size_t position = tape.bytes.size();
+    tape.bytes.resize(position + len);
+    if (len > 0) {
+        std::memcpy(tape.bytes.data() + position, data, len);
+    }
+}
+
+template <class T>
+void TapeSerializer::write_value(Op op, T value) {
+    write_op(op);
+    write(&value, sizeof(value));
+}
+
+// The elements are aligned so that replaying can hand them straight
+// to serialize_*_seq(), and deserializing can copy them all at once.
+template <class T>
+void TapeSerializer::write_seq(Op op, const T* values, std::size_t len) {
+    write_op(op);
+    const std::size_t position = tape.bytes.size();
+    write(&len, sizeof(len));
+    tape.bytes.resize(seq_elements(position));
+    write(values, len * sizeof(T));
+}
+
+void TapeSerializer::write_string(serde::string_view value) {
+    const std::size_t len = value.size();
+    write(&len, sizeof(len));
+    write(value.data(), len);
+}
+
+// The end offset and length are filled in by end_group().
+void TapeSerializer::begin_group(Op op, std::size_t len) {
+    write_op(op);
+    groups.push_back(Group{ tape.bytes.size(), 0 });
+    const std::size_t end = 0;
+    write(&end, sizeof(end));
+    write(&len, sizeof(len));
+}
+
+void TapeSerializer::end_group(Op op, bool patch_length) {
+    write_op(op);
+    if (groups.empty()) {
+        // Logic error - this shouldn't occur if the user is using
+        // serialize_seq(), _map(), _struct(), etc.
+        KINGW_SERDE_THROW(SerializationException("TapeSerializer end without begin"));
+    }
+    const Group group = groups.back();
+    groups.pop_back();
+    const std::size_t end = tape.bytes.size();
+    std::memcpy(tape.bytes.data() + group.header, &end, sizeof(end));
+    if (patch_length) {
+        std::memcpy(tape.bytes.data() + group.header + sizeof(end), &group.length, sizeof(group.length));
+    }
+}
+
+// Basic Types
+void TapeSerializer::serialize_bool(bool value) {
+    write_value(Op::Bool, value);
+}
+void TapeSerializer::serialize_i8(std::int8_t value) {
+    write_value(Op::I8, value);
+}
+void TapeSerializer::serialize_i16(std::int16_t value) {
+    write_value(Op::I16, value);
+}
+void TapeSerializer::serialize_i32(std::int32_t value) {
+    write_value(Op::I32, value);
+}
+void TapeSerializer::serialize_i64(std::int64_t value) {
+    write_value(Op::I64, value);
+}
+void TapeSerializer::serialize_u8(std::uint8_t value) {
+    write_value(Op::U8, value);
+}
+void TapeSerializer::serialize_u16(std::uint16_t value) {
+    write_value(Op::U16, value);
+}
+void TapeSerializer::serialize_u32(std::uint32_t value) {
+    write_value(Op::U32, value);
+}
+void TapeSerializer::serialize_u64(std::uint64_t value) {
+    write_value(Op::U64, value);
+}
+void TapeSerializer::serialize_f32(float value) {
+    write_value(Op::F32, value);
+}
+void TapeSerializer::serialize_f64(double value) {
+    write_value(Op::F64, value);
+}
+void TapeSerializer::serialize_char(char value) {
+    write_value(Op::Char, value);
+}
+void TapeSerializer::serialize_string(serde::string_view value) {
+    write_op(Op::String);
+    write_string(value);
+}
+
+// Contiguous Sequences of Basic Types
+void TapeSerializer::serialize_bool_seq(const bool* values, std::size_t len) {
+    write_seq(Op::BoolSeq, values, len);
+}
+void TapeSerializer::serialize_i8_seq(const std::int8_t* values, std::size_t len) {
+    write_seq(Op::I8Seq, values, len);
+}
+void TapeSerializer::serialize_i16_seq(const std::int16_t* values, std::size_t len) {
+    write_seq(Op::I16Seq, values, len);
+}
+void TapeSerializer::serialize_i32_seq(const std::int32_t* values, std::size_t len) {
+    write_seq(Op::I32Seq, values, len);
+}
+void TapeSerializer::serialize_i64_seq(const std::int64_t* values, std::size_t len) {
+    write_seq(Op::I64Seq, values, len);
+}
+void TapeSerializer::serialize_u8_seq(const std::uint8_t* values, std::size_t len) {
+    write_seq(Op::U8Seq, values, len);
+}
+void TapeSerializer::serialize_u16_seq(const std::uint16_t* values, std::size_t len) {
+    write_seq(Op::U16Seq, values, len);
+}
+void TapeSerializer::serialize_u32_seq(const std::uint32_t* values, std::size_t len) {
+    write_seq(Op::U32Seq, values, len);
+}
+void TapeSerializer::serialize_u64_seq(const std::uint64_t* values, std::size_t len) {
+    write_seq(Op::U64Seq, values, len);
+}
+void TapeSerializer::serialize_f32_seq(const float* values, std::size_t len) {
+    write_seq(Op::F32Seq, values, len);
+}
+void TapeSerializer::serialize_f64_seq(const double* values, std::size_t len) {
+    write_seq(Op::F64Seq, values, len);
+}
+
+// Byte Blobs
+void TapeSerializer::serialize_bytes(const std::uint8_t* data, std::size_t len) {
+    write_op(Op::Bytes);
+    write_string(serde::string_view(reinterpret_cast<const char*>(data), len));
+}
+
+// Unit
+void TapeSerializer::serialize_unit() {
+    write_op(Op::Unit);
+}
+
+// Lists/Sequences
+void TapeSerializer::seq_begin(std::size_t len) {
+    begin_group(Op::SeqBegin, len);
+}
+void TapeSerializer::seq_serialize_element(const ser::Serialize & accessor) {
+    ++groups.back().length;
+    accessor.serialize(*this);
+}
+void TapeSerializer::seq_end() {
+    end_group(Op::SeqEnd, true);
+}
+
+// Maps
+void TapeSerializer::map_begin(std::size_t len) {
+    begin_group(Op::MapBegin, len);
+}
+void TapeSerializer::map_serialize_key(const ser::Serialize & key) {
+    ++groups.back().length;
+    key.serialize(*this);
+}
+void TapeSerializer::map_serialize_value(const ser::Serialize & value) {
+    value.serialize(*this);
+}
+void TapeSerializer::map_serialize_entry(const ser::Serialize & key, const ser::Serialize & value) {
+    map_serialize_key(key);
+    map_serialize_value(value);
+}
+void TapeSerializer::map_end() {
+    end_group(Op::MapEnd, true);
+}
+
+// Structs
+// The length is kept as given, since it is up to the format
+// whether skipped fields count.
+void TapeSerializer::struct_begin(serde::string_view name, std::size_t len) {
+    begin_group(Op::StructBegin, len);
+    write_string(name);
+}
+void TapeSerializer::struct_serialize_field(serde::string_view name, const ser::Serialize & accessor) {
+    write_op(Op::StructField);
+    write_string(name);
+    accessor.serialize(*this);
+}
+void TapeSerializer::struct_skip_field(serde::string_view name) {
+    write_op(Op::StructSkipField);
+    write_string(name);
+}
+void TapeSerializer::struct_end() {
+    end_group(Op::StructEnd, false);
+}
+
+template <>
+void serialize<serde::Tape>(Serializer & serializer, const serde::Tape & data) {
+    std::size_t cursor = 0;
+    while (cursor < data.size()) {
+        const Op op = static_cast<Op>(data.data()[cursor]);
+        replay(data.data(), op, cursor + 1, serializer);
+        cursor = skip(data.data(), op, cursor + 1);
+    }
+}
+
+}  // namespace ser
+
+
+namespace de {
+
+TapeDeserializer::TapeDeserializer(const serde::Tape & tape)
+    : tape(tape),
+      op(tape.empty() ? Op::None : static_cast<Op>(tape.data()[0])),
+      position(1) { }
+
+TapeDeserializer::TapeDeserializer(const serde::Tape & tape, Op op, std::size_t position)
+    : tape(tape), op(op), position(position) { }
+
+bool TapeDeserializer::is_human_readable() const {
+    return tape.is_human_readable();
+}
+
+// Basic Types
+void TapeDeserializer::deserialize_any(de::Visitor & visitor) {
+    const unsigned char* data = tape.data();
+    switch (op) {
+    case Op::Bool: visitor.visit_bool(read<bool>(data, position)); break;
+    case Op::I8: visitor.visit_i8(read<std::int8_t>(data, position)); break;
+    case Op::I16: visitor.visit_i16(read<std::int16_t>(data, position)); break;
+    case Op::I32: visitor.visit_i32(read<std::int32_t>(data, position)); break;
+    case Op::I64: visitor.visit_i64(read<std::int64_t>(data, position)); break;
+    case Op::U8: visitor.visit_u8(read<std::uint8_t>(data, position)); break;
+    case Op::U16: visitor.visit_u16(read<std::uint16_t>(data, position)); break;
+    case Op::U32: visitor.visit_u32(read<std::uint32_t>(data, position)); break;
+    case Op::U64: visitor.visit_u64(read<std::uint64_t>(data, position)); break;
+    case Op::F32: visitor.visit_f32(read<float>(data, position)); break;
+    case Op::F64: visitor.visit_f64(read<double>(data, position)); break;
+    case Op::Char: visitor.visit_char(read<char>(data, position)); break;
+    case Op::String: visitor.visit_borrowed_string(read_string(data, position)); break;
+    case Op::Bytes: {
+        const serde::string_view bytes = read_string(data, position);
+        visitor.visit_bytes(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+        break;
+    }
+    case Op::Unit: visitor.visit_unit(); break;
+    case Op::SeqBegin: {
+        TapeSeqAccess seq(tape, op, position, *this);
+        visitor.visit_seq(seq);
+        break;
+    }
+    case Op::MapBegin:
+    case Op::StructBegin: {
+        TapeMapAccess map(tape, op, position, *this);
+        visitor.visit_map(map);
+        break;
+    }
+    default:
+        if (is_basic_seq(op)) {
+            TapeSeqAccess seq(tape, op, position, *this);
+            visitor.visit_seq(seq);
+        } else {
+            fail(de::ErrorCode::EndOfInput, "tape has no value");
+        }
+        break;
+    }
+}
+void TapeDeserializer::deserialize_bool(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_i8(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_i16(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_i32(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_i64(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_u8(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_u16(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_u32(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_u64(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_f32(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_f64(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_char(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_string(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_seq(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_map(de::Visitor & visitor) {
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_struct(
+    serde::string_view,
+    const FieldNames &,
+    de::Visitor & visitor)
+{
+    deserialize_any(visitor);
+}
+void TapeDeserializer::deserialize_bytes(de::Visitor & visitor) {
+    if (op == Op::U8Seq) {
+        // Recorded by the default Serializer::serialize_bytes() of a
+        // serializer that forwarded to this one.
+        visitor.visit_bytes(seq_data<std::uint8_t>(tape.data(), position), read<std::size_t>(tape.data(), position));
+    } else {
+        deserialize_any(visitor);
+    }
+}
+void TapeDeserializer::deserialize_ignored_any(de::Visitor &) {
+    // Every value knows where it ends, so there is nothing to skip over.
+}
+
+TapeDeserializer::TapeSeqAccess::TapeSeqAccess(const serde::Tape & tape, Op op, std::size_t position,
+    de::Deserializer & parent)
+    : tape(tape), parent(parent)
+{
+    report_to(parent);
+    if (op == Op::SeqBegin) {
+        element_op = Op::None;
+        cursor = position + 2 * sizeof(std::size_t);
+        remaining = read<std::size_t>(tape.data(), position + sizeof(std::size_t));
+    } else {
+        element_op = seq_element_op(op);
+        cursor = seq_elements(position);
+        remaining = read<std::size_t>(tape.data(), position);
+    }
+}
+bool TapeDeserializer::TapeSeqAccess::has_next() {
+    return remaining > 0 && !parent.failed();
+}
+std::size_t TapeDeserializer::TapeSeqAccess::size_hint() const {
+    return remaining;
+}
+void TapeDeserializer::TapeSeqAccess::next_element(de::Deserialize & element) {
+    if (has_next()) {
+        // The elements of a *Seq are stored without their op.
+        const Op op = element_op == Op::None ? static_cast<Op>(tape.data()[cursor]) : element_op;
+        const std::size_t position = element_op == Op::None ? cursor + 1 : cursor;
+        TapeDeserializer deserializer(tape, op, position);
+        deserializer.report_to(parent);
+        deserializer.deserialize_at(index, element);
+        cursor = skip(tape.data(), op, position);
+        ++index;
+        --remaining;
+    } else {
+        fail(de::ErrorCode::EndOfInput, "tape end of sequence reached");
+    }
+}
+
+// Basic elements that were recorded with the same type are copied all
+// at once. Anything else, such as ints recorded as a *Seq of another
+// type, goes through the visitor one element at a time.
+template <class T>
+std::size_t TapeDeserializer::TapeSeqAccess::copy_elements(T* output, std::size_t len) {
+    const std::size_t count = std::min(len, remaining);
+    std::memcpy(output, tape.data() + cursor, count * sizeof(T));
+    cursor += count * sizeof(T);
+    index += count;
+    remaining -= count;
+    return count;
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_bool_elements(bool* output, std::size_t len) {
+    return element_op == Op::Bool ? copy_elements(output, len) : SeqAccess::next_bool_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_i8_elements(std::int8_t* output, std::size_t len) {
+    return element_op == Op::I8 ? copy_elements(output, len) : SeqAccess::next_i8_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_i16_elements(std::int16_t* output, std::size_t len) {
+    return element_op == Op::I16 ? copy_elements(output, len) : SeqAccess::next_i16_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_i32_elements(std::int32_t* output, std::size_t len) {
+    return element_op == Op::I32 ? copy_elements(output, len) : SeqAccess::next_i32_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_i64_elements(std::int64_t* output, std::size_t len) {
+    return element_op == Op::I64 ? copy_elements(output, len) : SeqAccess::next_i64_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_u8_elements(std::uint8_t* output, std::size_t len) {
+    return element_op == Op::U8 ? copy_elements(output, len) : SeqAccess::next_u8_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_u16_elements(std::uint16_t* output, std::size_t len) {
+    return element_op == Op::U16 ? copy_elements(output, len) : SeqAccess::next_u16_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_u32_elements(std::uint32_t* output, std::size_t len) {
+    return element_op == Op::U32 ? copy_elements(output, len) : SeqAccess::next_u32_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_u64_elements(std::uint64_t* output, std::size_t len) {
+    return element_op == Op::U64 ? copy_elements(output, len) : SeqAccess::next_u64_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_f32_elements(float* output, std::size_t len) {
+    return element_op == Op::F32 ? copy_elements(output, len) : SeqAccess::next_f32_elements(output, len);
+}
+std::size_t TapeDeserializer::TapeSeqAccess::next_f64_elements(double* output, std::size_t len) {
+    return element_op == Op::F64 ? copy_elements(output, len) : SeqAccess::next_f64_elements(output, len);
+}
+
+// Struct fields are read like a map with string keys. Skipped fields
+// were not serialized, so they are left out.
+TapeDeserializer::TapeMapAccess::TapeMapAccess(const serde::Tape & tape, Op op, std::size_t position,
+    de::Deserializer & parent)
+    : tape(tape), parent(parent), is_struct(op == Op::StructBegin)
+{
+    report_to(parent);
+    if (is_struct) {
+        cursor = string_end(tape.data(), position + 2 * sizeof(std::size_t));
+        remaining = UNKNOWN_LENGTH;
+    } else {
+        cursor = position + 2 * sizeof(std::size_t);
+        remaining = read<std::size_t>(tape.data(), position + sizeof(std::size_t));
+    }
+}
+bool TapeDeserializer::TapeMapAccess::has_next() {
+    if (parent.failed()) {
+        return false;
+    } else if (is_struct) {
+        if (!at_value) {
+            while (static_cast<Op>(tape.data()[cursor]) == Op::StructSkipField) {
+                cursor = string_end(tape.data(), cursor + 1);
+            }
+        }
+        return static_cast<Op>(tape.data()[cursor]) != Op::StructEnd;
+    } else {
+        return remaining > 0;
+    }
+}
+std::size_t TapeDeserializer::TapeMapAccess::size_hint() const {
+    return remaining;
+}
+void TapeDeserializer::TapeMapAccess::next_key(de::Deserialize & key) {
+    if (has_next()) {
+        if (at_value) {
+            fail(de::ErrorCode::Custom, "tape map key was already read");
+            return;
+        }
+        // A field name is stored like a string, just without the op.
+        const Op op = is_struct ? Op::String : static_cast<Op>(tape.data()[cursor]);
+        const std::size_t position = cursor + 1;
+        key_name = op == Op::String ? read_string(tape.data(), position) : serde::string_view();
+        TapeDeserializer deserializer(tape, op, position);
+        deserializer.report_to(parent);
+        key.deserialize(deserializer);
+        cursor = skip(tape.data(), op, position);
+        at_value = true;
+    } else {
+        fail(de::ErrorCode::EndOfInput, "tape end of map reached");
+    }
+}
+void TapeDeserializer::TapeMapAccess::next_value(de::Deserialize & value) {
+    if (has_next()) {
+        if (!at_value) {
+            skip_key();
+        }
+        const Op op = static_cast<Op>(tape.data()[cursor]);
+        TapeDeserializer deserializer(tape, op, cursor + 1);
+        deserializer.report_to(parent);
+        if (key_name.data() != nullptr) {
+            deserializer.deserialize_at(key_name, value);
+        } else {
+            deserializer.deserialize_at(index, value);
+        }
+        cursor = skip(tape.data(), op, cursor + 1);
+        at_value = false;
+        ++index;
+        if (!is_struct) {
+            --remaining;
+        }
+    } else {
+        fail(de::ErrorCode::EndOfInput, "tape end of map reached");
+    }
+}
+void TapeDeserializer::TapeMapAccess::next_entry(de::Deserialize & key, de::Deserialize & value) {
+    next_key(key);
+    next_value(value);
+}
+void TapeDeserializer::TapeMapAccess::skip_key() {
+    const Op op = is_struct ? Op::String : static_cast<Op>(tape.data()[cursor]);
+    key_name = op == Op::String ? read_string(tape.data(), cursor + 1) : serde::string_view();
+    cursor = skip(tape.data(), op, cursor + 1);
+}
+
+/// Records any self-describing input, through serde::transcode().
+template <>
+void deserialize<serde::Tape>(Deserializer & deserializer, serde::Tape & data) {
+    data.clear();
+    ser::TapeSerializer serializer(data, deserializer.is_human_readable());
+    serde::transcode(deserializer, serializer);
+}
+
+/// Same as for serde::Document.
+template <>
+void Validator<serde::Tape>::validate(Deserializer & deserializer) {
+    validate_by_deserializing<serde::Tape>(deserializer);
+}
+
+}  // namespace de
+}  // namespace kingw
@@ -0,0 +1,132 @@
+#include "kingw/serde/transcode.hpp"
+
+
+namespace kingw {
+namespace serde {
+
+namespace {
+
+/// @brief Writes everything it visits to a `Serializer`
+class TranscodeVisitor : public de::Visitor {
+public:
+    explicit TranscodeVisitor(ser::Serializer & serializer)
+        : serializer(serializer) { }
+
+    const char* expecting() const override { return "any value"; }
+
+    void visit_bool(bool value) override { serializer.serialize_bool(value); }
+    void visit_i8(std::int8_t value) override { serializer.serialize_i8(value); }
+    void visit_i16(std::int16_t value) override { serializer.serialize_i16(value); }
+    void visit_i32(std::int32_t value) override { serializer.serialize_i32(value); }
+    void visit_i64(std::int64_t value) override { serializer.serialize_i64(value); }
+    void visit_u8(std::uint8_t value) override { serializer.serialize_u8(value); }
+    void visit_u16(std::uint16_t value) override { serializer.serialize_u16(value); }
+    void visit_u32(std::uint32_t value) override { serializer.serialize_u32(value); }
+    void visit_u64(std::uint64_t value) override { serializer.serialize_u64(value); }
+    void visit_f32(float value) override { serializer.serialize_f32(value); }
+    void visit_f64(double value) override { serializer.serialize_f64(value); }
+    void visit_char(char value) override { serializer.serialize_char(value); }
+    void visit_string(serde::string_view value) override { serializer.serialize_string(value); }
+    void visit_bytes(const std::uint8_t* data, std::size_t len) override { serializer.serialize_bytes(data, len); }
+    void visit_unit() override { serializer.serialize_unit(); }
+
+    // size_hint() is only a hint, but serialize_seq() and serialize_map()
+    // take it as the exact length, so the length is passed on as unknown.
+    void visit_seq(de::Deserializer::SeqAccess & seq) override {
+        auto output = serializer.serialize_seq(ser::Serializer::UNKNOWN_LENGTH);
+        while (seq.has_next()) {
+            output.serialize_element(Element(seq));
+        }
+        output.end();
+    }
+
+    void visit_map(de::Deserializer::MapAccess & map) override {
+        auto output = serializer.serialize_map(ser::Serializer::UNKNOWN_LENGTH);
+        while (map.has_next()) {
+            output.serialize_key(MapKey(map));
+            output.serialize_value(MapValue(map));
+        }
+        output.end();
+    }
+
+private:
+    /// @brief Transcodes one nested value, when `deserialize()` is called
+    class Seed : public de::Deserialize {
+    public:
+        explicit Seed(ser::Serializer & serializer)
+            : serializer(serializer) { }
+        void deserialize(de::Deserializer & deserializer) override {
+            TranscodeVisitor visitor(serializer);
+            visitor.report_to(deserializer);
+            deserializer.deserialize_any(visitor);
+        }
+        serde::TypeTraits traits() const override {
+            return serde::TypeTraits();
+        }
+    private:
+        ser::Serializer & serializer;
+    };
+
+    // The serializer asks for each element by calling serialize(),
+    // which reads it from the access into whichever serializer the
+    // element is being written to (not always the outer one).
+
+    /// @brief Next element of a sequence
+    class Element : public ser::Serialize {
+    public:
+        explicit Element(de::Deserializer::SeqAccess & seq) : seq(seq) { }
+        void serialize(ser::Serializer & serializer) const override {
+            Seed seed(serializer);
+            seq.next_element(seed);
+        }
+        serde::TypeTraits traits() const override {
+            return serde::TypeTraits();
+        }
+    private:
+        de::Deserializer::SeqAccess & seq;
+    };
+
+    /// @brief Key of the next map entry
+    class MapKey : public ser::Serialize {
+    public:
+        explicit MapKey(de::Deserializer::MapAccess & map) : map(map) { }
+        void serialize(ser::Serializer & serializer) const override {
+            Seed seed(serializer);
+            map.next_key(seed);
+        }
+        serde::TypeTraits traits() const override {
+            return serde::TypeTraits::of<serde::string_view>();
+        }
+    private:
+        de::Deserializer::MapAccess & map;
+    };
+
+    /// @brief Value of the current map entry
+    class MapValue : public ser::Serialize {
+    public:
+        explicit MapValue(de::Deserializer::MapAccess & map) : map(map) { }
+        void serialize(ser::Serializer & serializer) const override {
+            Seed seed(serializer);
+            map.next_value(seed);
+        }
+        serde::TypeTraits traits() const override {
+            return serde::TypeTraits();
+        }
+    private:
+        de::Deserializer::MapAccess & map;
+    };
+
+    ser::Serializer & serializer;
+};
+
+}  // namespace
+
+
+void transcode(de::Deserializer & deserializer, ser::Serializer & serializer) {
+    TranscodeVisitor visitor(serializer);
+    visitor.report_to(deserializer);
+    deserializer.deserialize_any(visitor);
+}
+
+}  // namespace serde
+}  // namespace kingw
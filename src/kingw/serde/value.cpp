@@ -0,0 +1,417 @@
+#include "kingw/serde/value.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "kingw/de/deserializer.hpp"
+#include "kingw/de/validate.hpp"
+#include "kingw/ser/serializer.hpp"
+#include "kingw/serde/exceptions.hpp"
+
+
+namespace kingw {
+namespace serde {
+
+static_assert(sizeof(Value) == 16, "Value should fit in 16 bytes");
+static_assert(std::is_trivially_copyable<Value>::value, "Values are copied with memcpy");
+static_assert(std::is_trivially_copyable<Member>::value, "Members are copied with memcpy");
+
+Value Value::from_bool(bool value) {
+    return number<std::uint64_t>(Type::Bool, value ? 1 : 0);
+}
+Value Value::from_i64(std::int64_t value) {
+    return number(Type::I64, value);
+}
+Value Value::from_u64(std::uint64_t value) {
+    return number(Type::U64, value);
+}
+Value Value::from_f64(double value) {
+    return number(Type::F64, value);
+}
+
+bool Value::as_bool() const {
+    return type_ == Type::Bool && number<std::uint64_t>() != 0;
+}
+// Doubles are truncated toward zero. 2^63 and 2^64 are exact doubles,
+// and NaN fails every comparison.
+std::int64_t Value::as_i64() const {
+    switch (type_) {
+    case Type::I64:
+        return number<std::int64_t>();
+    case Type::U64:
+        if (number<std::uint64_t>() > static_cast<std::uint64_t>(INT64_MAX)) {
+            KINGW_SERDE_THROW(std::out_of_range("serde::Value does not fit in std::int64_t"));
+        }
+        return static_cast<std::int64_t>(number<std::uint64_t>());
+    case Type::F64:
+        if (!(number<double>() >= -9223372036854775808.0 && number<double>() < 9223372036854775808.0)) {
+            KINGW_SERDE_THROW(std::out_of_range("serde::Value does not fit in std::int64_t"));
+        }
+        return static_cast<std::int64_t>(number<double>());
+    default:
+        return 0;
+    }
+}
+std::uint64_t Value::as_u64() const {
+    switch (type_) {
+    case Type::I64:
+        if (number<std::int64_t>() < 0) {
+            KINGW_SERDE_THROW(std::out_of_range("serde::Value does not fit in std::uint64_t"));
+        }
+        return static_cast<std::uint64_t>(number<std::int64_t>());
+    case Type::U64:
+        return number<std::uint64_t>();
+    case Type::F64:
+        if (!(number<double>() > -1.0 && number<double>() < 18446744073709551616.0)) {
+            KINGW_SERDE_THROW(std::out_of_range("serde::Value does not fit in std::uint64_t"));
+        }
+        return static_cast<std::uint64_t>(number<double>());
+    default:
+        return 0;
+    }
+}
+double Value::as_f64() const {
+    switch (type_) {
+    case Type::I64: return static_cast<double>(number<std::int64_t>());
+    case Type::U64: return static_cast<double>(number<std::uint64_t>());
+    case Type::F64: return number<double>();
+    default: return 0;
+    }
+}
+serde::string_view Value::as_string() const {
+    if (type_ != Type::String && type_ != Type::Bytes) {
+        return serde::string_view("", 0);
+    } else if (small_length != NOT_SMALL) {
+        return serde::string_view(reinterpret_cast<const char*>(storage), small_length);
+    } else {
+        return serde::string_view(static_cast<const char*>(payload_pointer()), payload_length());
+    }
+}
+const std::uint8_t* Value::as_bytes() const {
+    return reinterpret_cast<const std::uint8_t*>(as_string().data());
+}
+std::size_t Value::size() const {
+    switch (type_) {
+    case Type::String:
+    case Type::Bytes:
+        return small_length != NOT_SMALL ? small_length : payload_length();
+    case Type::Array:
+    case Type::Object:
+        return payload_length();
+    default:
+        return 0;
+    }
+}
+const Value* Value::begin() const {
+    return type_ == Type::Array ? static_cast<const Value*>(payload_pointer()) : nullptr;
+}
+const Value* Value::end() const {
+    return type_ == Type::Array ? begin() + payload_length() : nullptr;
+}
+const Member* Value::members_begin() const {
+    return type_ == Type::Object ? static_cast<const Member*>(payload_pointer()) : nullptr;
+}
+const Member* Value::members_end() const {
+    return type_ == Type::Object ? members_begin() + payload_length() : nullptr;
+}
+const Value* Value::find(serde::string_view key) const {
+    for (const Member* member = members_begin(); member != members_end(); ++member) {
+        if (member->key.type() == Type::String && member->key.as_string() == key) {
+            return &member->value;
+        }
+    }
+    return nullptr;
+}
+
+bool operator==(const Value & lh, const Value & rh) {
+    if (lh.type() != rh.type()) {
+        return false;
+    }
+    switch (lh.type()) {
+    case Value::Type::Null:
+        return true;
+    case Value::Type::Bool:
+        return lh.as_bool() == rh.as_bool();
+    case Value::Type::I64:
+        return lh.as_i64() == rh.as_i64();
+    case Value::Type::U64:
+        return lh.as_u64() == rh.as_u64();
+    case Value::Type::F64:
+        return lh.as_f64() == rh.as_f64();
+    case Value::Type::String:
+    case Value::Type::Bytes:
+        return lh.as_string() == rh.as_string();
+    case Value::Type::Array:
+        if (lh.size() != rh.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lh.size(); ++i) {
+            if (lh[i] != rh[i]) {
+                return false;
+            }
+        }
+        return true;
+    case Value::Type::Object:
+        if (lh.size() != rh.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lh.size(); ++i) {
+            const Member & l = lh.members_begin()[i];
+            const Member & r = rh.members_begin()[i];
+            if (l.key != r.key || l.value != r.value) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+Document::Document(std::size_t block_size)
+    : next_block_size(block_size > 0 ? block_size : 1) { }
+
+Document::Document(Document && other) noexcept = default;
+Document & Document::operator=(Document && other) noexcept = default;
+
+Value Document::string(serde::string_view value) {
+    return chars(Value::Type::String, value.data(), value.size());
+}
+Value Document::bytes(const std::uint8_t* data, std::size_t len) {
+    return chars(Value::Type::Bytes, reinterpret_cast<const char*>(data), len);
+}
+Value Document::chars(Value::Type type, const char* data, std::size_t len) {
+    Value result;
+    result.type_ = type;
+    if (len <= Value::MAX_SMALL) {
+        std::memcpy(result.storage, data, len);
+        result.small_length = static_cast<std::uint8_t>(len);
+    } else if (len > UINT32_MAX) {
+        KINGW_SERDE_THROW(std::length_error("serde::Value strings are limited to 4 GiB"));
+    } else {
+        void* copy = allocate(len);
+        std::memcpy(copy, data, len);
+        result.set_payload(copy, len);
+    }
+    return result;
+}
+Value Document::array(const Value* items, std::size_t len) {
+    Value result;
+    result.type_ = Value::Type::Array;
+    void* copy = len > 0 ? allocate(len * sizeof(Value)) : nullptr;
+    if (len > 0) {
+        std::memcpy(copy, items, len * sizeof(Value));
+    }
+    result.set_payload(copy, len);
+    return result;
+}
+Value Document::object(const Member* members, std::size_t len) {
+    Value result;
+    result.type_ = Value::Type::Object;
+    void* copy = len > 0 ? allocate(len * sizeof(Member)) : nullptr;
+    if (len > 0) {
+        std::memcpy(copy, members, len * sizeof(Member));
+    }
+    result.set_payload(copy, len);
+    return result;
+}
+
+void Document::clear() {
+    root_ = Value();
+    current = 0;
+    used = 0;
+}
+
+std::size_t Document::memory_used() const {
+    std::size_t total = used;
+    for (std::size_t i = 0; i < current && i < blocks.size(); ++i) {
+        total += blocks[i].size;
+    }
+    return total;
+}
+
+void* Document::allocate(std::size_t size) {
+    size = (size + alignof(Value) - 1) & ~(alignof(Value) - 1);
+    while (current < blocks.size()) {
+        if (blocks[current].size - used >= size) {
+            void* result = blocks[current].data.get() + used;
+            used += size;
+            return result;
+        }
+        // Skip the rest of this block. Reused blocks are tried in order.
+        ++current;
+        used = 0;
+    }
+
+    // Each new block is twice as big, so there are few of them.
+    const std::size_t block_size = size > next_block_size ? size : next_block_size;
+    next_block_size *= 2;
+    blocks.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[block_size]), block_size });
+    current = blocks.size() - 1;
+    used = size;
+    return blocks[current].data.get();
+}
+
+
+/// @brief Builds the `Value` for anything a `Deserializer` finds
+///
+/// The elements of an array (or members of an object) are pushed onto
+/// the document's stack while they are deserialized, then copied into
+/// the arena all at once, so that they are contiguous. Nested arrays
+/// use the same stack above them, and are done before they return.
+class DocumentVisitor : public de::Visitor {
+public:
+    DocumentVisitor(Document & document, Value & output)
+        : document(document), output(output) { }
+
+    const char* expecting() const override { return "any value"; }
+
+    void visit_bool(bool value) override { output = Value::from_bool(value); }
+    void visit_i8(std::int8_t value) override { visit_i64(value); }
+    void visit_i16(std::int16_t value) override { visit_i64(value); }
+    void visit_i32(std::int32_t value) override { visit_i64(value); }
+    void visit_i64(std::int64_t value) override {
+        // Same as JSON: only negative numbers are signed.
+        output = value < 0 ? Value::from_i64(value) : Value::from_u64(value);
+    }
+    void visit_u8(std::uint8_t value) override { visit_u64(value); }
+    void visit_u16(std::uint16_t value) override { visit_u64(value); }
+    void visit_u32(std::uint32_t value) override { visit_u64(value); }
+    void visit_u64(std::uint64_t value) override { output = Value::from_u64(value); }
+    void visit_f32(float value) override { visit_f64(value); }
+    void visit_f64(double value) override { output = Value::from_f64(value); }
+    void visit_char(char value) override { output = document.string(serde::string_view(&value, 1)); }
+    void visit_string(serde::string_view value) override { output = document.string(value); }
+    void visit_bytes(const std::uint8_t* data, std::size_t len) override { output = document.bytes(data, len); }
+    void visit_unit() override { output = Value(); }
+
+    void visit_seq(de::Deserializer::SeqAccess & seq) override {
+        const std::size_t mark = document.value_stack.size();
+        while (seq.has_next()) {
+            Value element;
+            Seed seed(document, element);
+            seq.next_element(seed);
+            document.value_stack.push_back(element);
+        }
+        output = document.array(document.value_stack.data() + mark, document.value_stack.size() - mark);
+        document.value_stack.resize(mark);
+    }
+
+    void visit_map(de::Deserializer::MapAccess & map) override {
+        const std::size_t mark = document.member_stack.size();
+        while (map.has_next()) {
+            Member member;
+            Seed key(document, member.key);
+            Seed value(document, member.value);
+            map.next_entry(key, value);
+            document.member_stack.push_back(member);
+        }
+        output = document.object(document.member_stack.data() + mark, document.member_stack.size() - mark);
+        document.member_stack.resize(mark);
+    }
+
+    /// @brief Deserializes one nested value of any type
+    class Seed : public de::Deserialize {
+    public:
+        Seed(Document & document, Value & output)
+            : document(document), output(output) { }
+        void deserialize(de::Deserializer & deserializer) override {
+            DocumentVisitor visitor(document, output);
+            visitor.report_to(deserializer);
+            deserializer.deserialize_any(visitor);
+        }
+        serde::TypeTraits traits() const override {
+            return serde::TypeTraits::of<Value>();
+        }
+    private:
+        Document & document;
+        Value & output;
+    };
+
+private:
+    Document & document;
+    Value & output;
+};
+
+}  // namespace serde
+
+
+namespace de {
+
+template <>
+void deserialize<serde::Document>(Deserializer & deserializer, serde::Document & data) {
+    data.clear();
+    serde::Value root;
+    serde::DocumentVisitor::Seed seed(data, root);
+    seed.deserialize(deserializer);
+    data.set_root(root);
+}
+
+/// Any self-describing value is a valid Document, but only the
+/// format can tell whether it is self-describing.
+template <>
+void Validator<serde::Document>::validate(Deserializer & deserializer) {
+    validate_by_deserializing<serde::Document>(deserializer);
+}
+
+}  // namespace de
+
+
+namespace ser {
+
+template <>
+void serialize<serde::Value>(Serializer & serializer, const serde::Value & data) {
+    switch (data.type()) {
+    case serde::Value::Type::Null:
+        serializer.serialize_unit();
+        break;
+    case serde::Value::Type::Bool:
+        serializer.serialize_bool(data.as_bool());
+        break;
+    case serde::Value::Type::I64:
+        serializer.serialize_i64(data.as_i64());
+        break;
+    case serde::Value::Type::U64:
+        serializer.serialize_u64(data.as_u64());
+        break;
+    case serde::Value::Type::F64:
+        serializer.serialize_f64(data.as_f64());
+        break;
+    case serde::Value::Type::String:
+        serializer.serialize_string(data.as_string());
+        break;
+    case serde::Value::Type::Bytes:
+        serializer.serialize_bytes(data.as_bytes(), data.size());
+        break;
+    case serde::Value::Type::Array: {
+        auto seq = serializer.serialize_seq(data.size());
+        for (const serde::Value & element : data) {
+            seq.serialize_element(ser::accessor(element));
+        }
+        seq.end();
+        break;
+    }
+    case serde::Value::Type::Object: {
+        auto map = serializer.serialize_map(data.size());
+        for (const serde::Member* member = data.members_begin(); member != data.members_end(); ++member) {
+            if (member->key.type() == serde::Value::Type::String) {
+                // Formats like JSON only accept keys that are strings.
+                const serde::string_view key = member->key.as_string();
+                map.serialize_entry(ser::accessor(key), ser::accessor(member->value));
+            } else {
+                map.serialize_entry(ser::accessor(member->key), ser::accessor(member->value));
+            }
+        }
+        map.end();
+        break;
+    }
+    }
+}
+
+template <>
+void serialize<serde::Document>(Serializer & serializer, const serde::Document & data) {
+    ser::serialize(serializer, data.root());
+}
+
+}  // namespace ser
+}  // namespace kingw
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <kingw/serde/declare.hpp>
+
+
+namespace kingw {
+namespace fixtures {
+
+/// A struct with a bit of everything, serialized with `DERIVE_SERDE()`.
+struct Reading {
+    std::string name;
+    std::vector<double> samples;
+    std::map<std::string, std::int32_t> counts;
+    std::vector<std::uint8_t> raw;
+    bool valid;
+};
+
+/// Counts how many times it is serialized, in `counted_serializations`.
+struct Counted {
+    int value;
+};
+extern int counted_serializations;
+
+/// A sequence of `count` integers, without a length up front.
+struct Generated {
+    int count;
+};
+
+}  // namespace fixtures
+}  // namespace kingw
+
+// Defined in fixtures.cpp.
+DECLARE_SERDE(kingw::fixtures::Reading);
+DECLARE_SERIALIZE(kingw::fixtures::Counted);
+DECLARE_SERIALIZE(kingw::fixtures::Generated);
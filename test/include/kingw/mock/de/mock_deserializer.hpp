@@ -28,17 +28,32 @@ public:
     MOCK_METHOD(void, deserialize_seq, (Visitor &), (override));
     MOCK_METHOD(void, deserialize_map, (Visitor &), (override));
     MOCK_METHOD(void, deserialize_struct, (serde::string_view, const FieldNames &, Visitor &), (override));
+    MOCK_METHOD(void, deserialize_bytes, (Visitor &), (override));
+    MOCK_METHOD(void, deserialize_ignored_any, (Visitor &), (override));
 };
 
 class MockSeqAccess : public Deserializer::SeqAccess {
 public:
     MOCK_METHOD(bool, has_next, (), (override));
+    MOCK_METHOD(std::size_t, size_hint, (), (const override));
     MOCK_METHOD(void, next_element, (Deserialize &), (override));
+    MOCK_METHOD(std::size_t, next_bool_elements, (bool*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_i8_elements, (std::int8_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_i16_elements, (std::int16_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_i32_elements, (std::int32_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_i64_elements, (std::int64_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_u8_elements, (std::uint8_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_u16_elements, (std::uint16_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_u32_elements, (std::uint32_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_u64_elements, (std::uint64_t*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_f32_elements, (float*, std::size_t), (override));
+    MOCK_METHOD(std::size_t, next_f64_elements, (double*, std::size_t), (override));
 };
 
 class MockMapAccess : public Deserializer::MapAccess {
 public:
     MOCK_METHOD(bool, has_next, (), (override));
+    MOCK_METHOD(std::size_t, size_hint, (), (const override));
     MOCK_METHOD(void, next_key, (Deserialize &), (override));
     MOCK_METHOD(void, next_value, (Deserialize &), (override));
     MOCK_METHOD(void, next_entry, (Deserialize &, Deserialize &), (override));
@@ -46,6 +61,7 @@ public:
 
 class MockVisitor : public Visitor {
 public:
+    MOCK_METHOD(const char*, expecting, (), (const override));
     MOCK_METHOD(void, visit_bool, (bool), (override));
     MOCK_METHOD(void, visit_i8, (std::int8_t), (override));
     MOCK_METHOD(void, visit_i16, (std::int16_t), (override));
@@ -59,6 +75,9 @@ public:
     MOCK_METHOD(void, visit_f64, (double), (override));
     MOCK_METHOD(void, visit_char, (char), (override));
     MOCK_METHOD(void, visit_string, (serde::string_view), (override));
+    MOCK_METHOD(void, visit_borrowed_string, (serde::string_view), (override));
+    MOCK_METHOD(void, visit_bytes, (const std::uint8_t*, std::size_t), (override));
+    MOCK_METHOD(void, visit_unit, (), (override));
     MOCK_METHOD(void, visit_seq, (Deserializer::SeqAccess &), (override));
     MOCK_METHOD(void, visit_map, (Deserializer::MapAccess &), (override));
 };
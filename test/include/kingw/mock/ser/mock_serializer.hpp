@@ -24,6 +24,18 @@ public:
     MOCK_METHOD(void, serialize_f64, (double), (override));
     MOCK_METHOD(void, serialize_char, (char), (override));
     MOCK_METHOD(void, serialize_string, (serde::string_view), (override));
+    MOCK_METHOD(void, serialize_bool_seq, (const bool*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_i8_seq, (const std::int8_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_i16_seq, (const std::int16_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_i32_seq, (const std::int32_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_i64_seq, (const std::int64_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_u8_seq, (const std::uint8_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_u16_seq, (const std::uint16_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_u32_seq, (const std::uint32_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_u64_seq, (const std::uint64_t*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_f32_seq, (const float*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_f64_seq, (const double*, std::size_t), (override));
+    MOCK_METHOD(void, serialize_bytes, (const std::uint8_t*, std::size_t), (override));
     MOCK_METHOD(void, seq_begin, (std::size_t), (override));
     MOCK_METHOD(void, seq_serialize_element, (const Serialize &), (override));
     MOCK_METHOD(void, seq_end, (), (override));
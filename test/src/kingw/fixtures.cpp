@@ -0,0 +1,35 @@
+#include "kingw/fixtures.hpp"
+
+#include "kingw/de/templates/stdmap.hpp"
+#include "kingw/de/templates/stdvector.hpp"
+#include "kingw/ser/templates/stdmap.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/serde/derive.hpp"
+
+using namespace kingw;
+using namespace kingw::fixtures;
+
+
+DERIVE_SERDE(Reading,
+    ("name", &Self::name)
+    ("samples", &Self::samples)
+    ("counts", &Self::counts)
+    ("raw", &Self::raw)
+    ("valid", &Self::valid));
+
+int kingw::fixtures::counted_serializations = 0;
+
+template <>
+void ser::serialize<Counted>(ser::Serializer & serializer, const Counted & counted) {
+    ++counted_serializations;
+    serializer.serialize_i32(counted.value);
+}
+
+template <>
+void ser::serialize<Generated>(ser::Serializer & serializer, const Generated & generated) {
+    int next = 0;
+    ser::serialize_generator<int>(serializer, [&](int & element) {
+        element = next;
+        return next++ < generated.count;
+    });
+}
@@ -0,0 +1,91 @@
+#include <string>
+
+#include <gmock/gmock.h>
+
+#include "kingw/de/chunked_input.hpp"
+#include "kingw/de/deserializer.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// Reads chunks until `size` bytes or the end of the input.
+de::ChunkedInput::Decode read_bytes(std::string & output, std::size_t size) {
+    return [&output, size](de::ChunkedInput & input) {
+        while (output.size() < size) {
+            serde::string_view chunk = input.next_chunk();
+            if (chunk.size() == 0) {
+                return;
+            }
+            output.append(chunk.begin(), chunk.size());
+        }
+    };
+}
+
+/// The decode runs until it asks for a chunk that hasn't arrived,
+/// and picks up where it left off on the next feed().
+TEST(KingwSerde, ChunkedInputResumes) {
+    std::string output;
+    de::ChunkedInput input(read_bytes(output, 6));
+    EXPECT_FALSE(input.done());
+
+    EXPECT_FALSE(input.feed("ab"));
+    EXPECT_EQ(output, "ab");
+    EXPECT_FALSE(input.feed(""));  // Ignored, not the end of the input
+    EXPECT_FALSE(input.feed("cd"));
+    EXPECT_EQ(output, "abcd");
+    EXPECT_TRUE(input.feed("ef"));
+    EXPECT_EQ(output, "abcdef");
+    EXPECT_TRUE(input.done());
+
+    // Chunks after the decode finished are ignored.
+    EXPECT_TRUE(input.feed("gh"));
+    EXPECT_EQ(output, "abcdef");
+}
+
+/// finish() gives the decode an empty chunk, and runs it to completion.
+TEST(KingwSerde, ChunkedInputFinish) {
+    std::string output;
+    de::ChunkedInput input(read_bytes(output, 100));
+    EXPECT_FALSE(input.feed("abc"));
+    input.finish();
+    EXPECT_TRUE(input.done());
+    EXPECT_EQ(output, "abc");
+    EXPECT_EQ(input.next_chunk().size(), 0u);
+}
+
+/// Errors thrown by the decode are thrown from feed().
+TEST(KingwSerde, ChunkedInputThrows) {
+    de::ChunkedInput input([](de::ChunkedInput & input) {
+        input.next_chunk();
+        input.next_chunk();
+        KINGW_SERDE_THROW(de::DeserializationException("bad chunk", de::ErrorCode::Syntax));
+    });
+    EXPECT_FALSE(input.feed("a"));
+    EXPECT_THROW(input.feed("b"), de::DeserializationException);
+    EXPECT_TRUE(input.done());
+}
+
+/// A decode that is still waiting for input gets to clean up
+/// when the ChunkedInput is destroyed.
+TEST(KingwSerde, ChunkedInputAbandoned) {
+    bool cleaned_up = false;
+    {
+        struct CleanUp {
+            bool & cleaned_up;
+            ~CleanUp() { cleaned_up = true; }
+        };
+        de::ChunkedInput input([&cleaned_up](de::ChunkedInput & input) {
+            CleanUp clean_up{ cleaned_up };
+            while (input.next_chunk().size() != 0) { }
+            KINGW_SERDE_THROW(de::DeserializationException("end of input", de::ErrorCode::EndOfInput));
+        });
+        input.feed("a");
+        EXPECT_FALSE(cleaned_up);
+    }
+    EXPECT_TRUE(cleaned_up);
+}
+
+}  // namespace
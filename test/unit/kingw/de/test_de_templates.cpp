@@ -2,7 +2,10 @@
 
 #include "kingw/mock/de/mock_deserializer.hpp"
 #include "kingw/de/templates/stdmap.hpp"
+#include "kingw/de/templates/stdunorderedmap.hpp"
 #include "kingw/de/templates/stdvector.hpp"
+#include "kingw/de/deserialize_in_place.hpp"
+#include "kingw/de/arena.hpp"
 
 using namespace kingw;
 using namespace testing;
@@ -100,6 +103,103 @@ TEST(KingwSerde, StdMapDeAccessorTraits) {
     EXPECT_EQ(accessor.traits(), traits);
 }
 
+/// StdMapVisitor<K, V>::visit_map() in place will deserialize into the
+/// nodes of existing keys, add new keys, and remove missing keys.
+TEST(KingwSerde, StdMapVisitorVisitInPlace) {
+    // Define a deserializer that has a map of 2 items:
+    //  1: "one"
+    //  3: "three"
+    de::MockDeserializer deserializer;
+    de::MockMapAccess map_access;
+    EXPECT_CALL(map_access, has_next())
+        .Times(3)
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(map_access, next_key(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & key) { key.deserialize(deserializer); });
+    EXPECT_CALL(map_access, next_value(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & value) { value.deserialize(deserializer); });
+    EXPECT_CALL(deserializer, deserialize_i32(_))
+        .Times(2)
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(1); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(3); });
+    EXPECT_CALL(deserializer, deserialize_string(_))
+        .Times(2)
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_string("one"); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_string("three"); });
+
+    std::map<int, std::string> map;
+    map[1] = std::string(64, 'x');
+    map[2] = "two";
+    const std::string* existing = &map[1];
+    const char* existing_data = map[1].data();
+
+    de::StdMapVisitor<int, std::string> visitor(map, true);
+    visitor.visit_map(map_access);  // Extract the contents from Deserializer
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.count(2), 0);
+    EXPECT_EQ(map[1], "one");
+    EXPECT_EQ(map[3], "three");
+    EXPECT_EQ(&map[1], existing);  // Same node
+    EXPECT_EQ(map[1].data(), existing_data);  // Same string storage
+}
+
+/// StdUnorderedMapVisitor<K, V>::visit_map() will reserve buckets
+/// for every entry and extract them from the MapAccess.
+TEST(KingwSerde, StdUnorderedMapVisitorVisit) {
+    de::MockDeserializer deserializer;
+    de::MockMapAccess map_access;
+    EXPECT_CALL(map_access, size_hint())
+        .WillRepeatedly(Return(3));
+    EXPECT_CALL(map_access, has_next())
+        .Times(4)
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(map_access, next_entry(_, _))
+        .Times(3)
+        .WillRepeatedly([&](de::Deserialize & key, de::Deserialize & value) {
+            key.deserialize(deserializer);
+            value.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_i32(_))
+        .Times(6)
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(1); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(2); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(3); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(4); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(5); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_i32(6); });
+
+    std::unordered_map<int, int> map;
+    de::StdUnorderedMapVisitor<int, int> visitor(map);
+    visitor.visit_map(map_access);  // Extract the contents from Deserializer
+    EXPECT_GE(map.bucket_count() * map.max_load_factor(), 3);
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map[1], 2);
+    EXPECT_EQ(map[3], 4);
+    EXPECT_EQ(map[5], 6);
+}
+
+/// deserialize<std::unordered_map<K, V>>(deserializer, std::unordered_map<K, V>)
+/// will invoke deserializer.deserialize_map(StdUnorderedMapVisitor<K, V>)
+TEST(KingwSerde, StdUnorderedMapDeserialize) {
+    de::MockDeserializer deserializer;
+    EXPECT_CALL(deserializer, deserialize_map(WhenDynamicCastTo<de::StdUnorderedMapVisitor<int, int> &>(_)))
+        .Times(1);
+
+    std::unordered_map<int, int> map;
+    de::Accessor<std::unordered_map<int, int>> accessor = de::accessor(map);
+    accessor.deserialize(deserializer);
+
+    auto traits = serde::TypeTraits::of<std::unordered_map<int, int>>();
+    EXPECT_EQ(accessor.traits(), traits);
+}
+
 
 /// StdVectorVisitor<T>::expecting() returns "a sequence of items"
 ///
@@ -115,12 +215,18 @@ TEST(KingwSerde, StdVectorVisitorVisit) {
     // Define a deserializer that has a sequence of 3 items:
     //  1, 2, 3
     //
-    // The StdVectorVisitor should call has_next() 4 times.
+    // The StdVectorVisitor should request a batch of elements once.
+    // The default SeqAccess implementation of the batch should call has_next() 4 times.
     // The first 3 calls will return true and invoke next_element().
     // Each call to next_element() will enter a new value in the vector.
     // The final call will return false and exit.
     de::MockDeserializer deserializer;
     de::MockSeqAccess seq_access;
+    EXPECT_CALL(seq_access, next_i32_elements(_, _))
+        .Times(1)
+        .WillOnce([&](std::int32_t* output, std::size_t len) {
+            return seq_access.SeqAccess::next_i32_elements(output, len);
+        });
     EXPECT_CALL(seq_access, has_next())
         .Times(4)
         .WillOnce(Return(true))
@@ -150,6 +256,154 @@ TEST(KingwSerde, StdVectorVisitorVisit) {
     EXPECT_EQ(vec[2], 3);
 }
 
+/// StdVectorVisitor<T>::visit_seq() will fill a vector of basic types
+/// in batches until the SeqAccess returns a partial batch.
+TEST(KingwSerde, StdVectorVisitorVisitBatches) {
+    // Define a sequence of 100 items: 0, 1, 2, ... 99
+    // The length is unknown, so the StdVectorVisitor should keep
+    // requesting batches until one comes back with fewer elements
+    // than it asked for.
+    de::MockSeqAccess seq_access;
+    std::int32_t next_value = 0;
+    EXPECT_CALL(seq_access, size_hint())
+        .WillRepeatedly(Return(de::Deserializer::UNKNOWN_LENGTH));
+    EXPECT_CALL(seq_access, next_i32_elements(_, _))
+        .Times(AtLeast(2))
+        .WillRepeatedly([&](std::int32_t* output, std::size_t len) {
+            std::size_t count = 0;
+            for (; count < len && next_value < 100; ++count) {
+                output[count] = next_value++;
+            }
+            return count;
+        });
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return next_value < 100; });
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(0);
+
+    std::vector<int> vec;
+    de::StdVectorVisitor<int> visitor(vec);
+    visitor.visit_seq(seq_access);  // Extract the contents from Deserializer
+    ASSERT_EQ(vec.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(vec[i], i);
+    }
+}
+
+/// StdVectorVisitor<T>::visit_seq() will reserve space for the whole
+/// sequence and read it in one batch when the SeqAccess knows its size.
+TEST(KingwSerde, StdVectorVisitorVisitSizeHint) {
+    de::MockSeqAccess seq_access;
+    EXPECT_CALL(seq_access, size_hint())
+        .WillRepeatedly(Return(100));
+    EXPECT_CALL(seq_access, next_i32_elements(_, 100))
+        .Times(1)
+        .WillOnce([&](std::int32_t* output, std::size_t len) {
+            for (std::size_t i = 0; i < len; ++i) {
+                output[i] = static_cast<std::int32_t>(i);
+            }
+            return len;
+        });
+    EXPECT_CALL(seq_access, has_next())
+        .Times(1)
+        .WillOnce(Return(false));
+
+    std::vector<int> vec;
+    de::StdVectorVisitor<int> visitor(vec);
+    visitor.visit_seq(seq_access);  // Extract the contents from Deserializer
+    ASSERT_EQ(vec.size(), 100);
+    EXPECT_EQ(vec.capacity(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(vec[i], i);
+    }
+}
+
+/// StdVectorVisitor<T>::visit_seq() will not trust a huge size hint.
+///
+TEST(KingwSerde, StdVectorVisitorVisitHugeSizeHint) {
+    de::MockSeqAccess seq_access;
+    EXPECT_CALL(seq_access, size_hint())
+        .WillRepeatedly(Return(std::size_t(1) << 40));
+    EXPECT_CALL(seq_access, next_i32_elements(_, Le(1024 * 1024 / sizeof(std::int32_t))))
+        .Times(1)
+        .WillOnce(Return(0));
+
+    std::vector<int> vec;
+    de::StdVectorVisitor<int> visitor(vec);
+    visitor.visit_seq(seq_access);  // Extract the contents from Deserializer
+    EXPECT_EQ(vec.size(), 0);
+    EXPECT_LE(vec.capacity(), 1024 * 1024 / sizeof(std::int32_t));
+}
+
+/// StdVectorVisitor<T>::visit_seq() in place will overwrite the existing
+/// elements and remove the extra ones, without reallocating.
+TEST(KingwSerde, StdVectorVisitorVisitInPlace) {
+    de::MockSeqAccess seq_access;
+    EXPECT_CALL(seq_access, size_hint())
+        .WillRepeatedly(Return(3));
+    EXPECT_CALL(seq_access, next_i32_elements(_, 3))
+        .Times(1)
+        .WillOnce([&](std::int32_t* output, std::size_t len) {
+            for (std::size_t i = 0; i < len; ++i) {
+                output[i] = static_cast<std::int32_t>(i);
+            }
+            return len;
+        });
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly(Return(false));
+
+    std::vector<int> vec(5, 9);
+    const int* existing_data = vec.data();
+    de::StdVectorVisitor<int> visitor(vec, true);
+    visitor.visit_seq(seq_access);  // Extract the contents from Deserializer
+    EXPECT_THAT(vec, ElementsAre(0, 1, 2));
+    EXPECT_EQ(vec.data(), existing_data);
+}
+
+/// StdVectorVisitor<T>::visit_seq() in place will deserialize over the
+/// existing elements, so that they can reuse their own storage, and
+/// grow the vector for the rest.
+TEST(KingwSerde, StdVectorVisitorVisitInPlaceGrow) {
+    de::MockDeserializer deserializer;
+    de::MockSeqAccess seq_access;
+    EXPECT_CALL(seq_access, size_hint())
+        .WillRepeatedly(Return(de::Deserializer::UNKNOWN_LENGTH));
+    int remaining = 2;
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return remaining > 0; });
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            --remaining;
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_string(_))
+        .Times(2)
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_string("a"); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_string("b"); });
+
+    std::vector<std::string> vec{ std::string(64, 'x') };
+    const char* existing_data = vec[0].data();
+    de::StdVectorVisitor<std::string> visitor(vec, true);
+    visitor.visit_seq(seq_access);  // Extract the contents from Deserializer
+    EXPECT_THAT(vec, ElementsAre("a", "b"));
+    EXPECT_EQ(vec[0].data(), existing_data);
+}
+
+/// de::deserialize_in_place<T>(deserializer, value) turns on
+/// deserializer.in_place() for the call, and restores it afterwards.
+TEST(KingwSerde, DeserializeInPlace) {
+    de::MockDeserializer deserializer;
+    EXPECT_FALSE(deserializer.in_place());
+    EXPECT_CALL(deserializer, deserialize_seq(_))
+        .Times(1)
+        .WillOnce([&](de::Visitor &) { EXPECT_TRUE(deserializer.in_place()); });
+
+    std::vector<int> vec;
+    de::deserialize_in_place(deserializer, vec);
+    EXPECT_FALSE(deserializer.in_place());
+}
+
 /// deserialize<std::vector<T>>(deserializer, std::vector<T>) will invoke
 /// deserializer.deserialize_vector(StdVectorVisitor<T>)
 TEST(KingwSerde, StdVectorDeserialize) {
@@ -182,4 +436,81 @@ TEST(KingwSerde, StdVectorDeAccessorTraits) {
     EXPECT_EQ(accessor.traits(), traits);
 }
 
+#if KINGW_SERDE_PMR
+/// Sets the default memory resource for the life of a test,
+/// so that allocations outside of an arena fail.
+struct DefaultResourceScope {
+    std::pmr::memory_resource* previous;
+    explicit DefaultResourceScope(std::pmr::memory_resource* resource)
+        : previous(std::pmr::set_default_resource(resource)) { }
+    ~DefaultResourceScope() { std::pmr::set_default_resource(previous); }
+};
+
+/// de::deserialize<std::pmr::vector<std::pmr::string>>() allocates
+/// the vector and every string from the vector's memory resource.
+TEST(KingwSerde, PmrVectorDeserializeArena) {
+    de::MockDeserializer deserializer;
+    de::MockSeqAccess seq_access;
+    int remaining = 2;
+    EXPECT_CALL(deserializer, deserialize_seq(_))
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_seq(seq_access); });
+    EXPECT_CALL(seq_access, size_hint())
+        .WillRepeatedly(Return(2));
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return remaining > 0; });
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            --remaining;
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_string(_))
+        .Times(2)
+        .WillRepeatedly([](de::Visitor & visitor){ visitor.visit_string(std::string(64, 'x')); });
+
+    de::ArenaScope arena;
+    std::pmr::vector<std::pmr::string> vec(arena.resource());
+    {
+        DefaultResourceScope no_default(std::pmr::null_memory_resource());
+        de::deserialize(deserializer, vec);
+    }
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec[1], std::string(64, 'x').c_str());
+    EXPECT_EQ(vec[1].get_allocator().resource(), arena.resource());
+}
+
+/// de::deserialize<std::pmr::map<std::pmr::string, std::pmr::string>>()
+/// builds its keys and values in the map's memory resource.
+TEST(KingwSerde, PmrMapDeserializeArena) {
+    de::MockDeserializer deserializer;
+    de::MockMapAccess map_access;
+    EXPECT_CALL(deserializer, deserialize_map(_))
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_map(map_access); });
+    EXPECT_CALL(map_access, has_next())
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(map_access, next_entry(_, _))
+        .WillOnce([&](de::Deserialize & key, de::Deserialize & value) {
+            key.deserialize(deserializer);
+            value.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_string(_))
+        .Times(2)
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_string(std::string(64, 'k')); })
+        .WillOnce([](de::Visitor & visitor){ visitor.visit_string(std::string(64, 'v')); });
+
+    de::ArenaScope arena;
+    std::pmr::map<std::pmr::string, std::pmr::string> map(arena.resource());
+    {
+        DefaultResourceScope no_default(std::pmr::null_memory_resource());
+        de::deserialize(deserializer, map);
+    }
+    ASSERT_EQ(map.size(), 1);
+    EXPECT_EQ(map.begin()->first, std::string(64, 'k').c_str());
+    EXPECT_EQ(map.begin()->second, std::string(64, 'v').c_str());
+    EXPECT_EQ(map.begin()->second.get_allocator().resource(), arena.resource());
+    EXPECT_TRUE(de::Accessor<std::pmr::string>(map.begin()->second).traits().is_string);
+}
+#endif
+
 }  // namespace
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <limits>
 
 #include <gmock/gmock.h>
@@ -5,6 +6,7 @@
 #include "kingw/mock/de/mock_deserializer.hpp"
 #include "kingw/mock/de/mock_deserialize.hpp"
 #include "kingw/de/integral_visitors.hpp"
+#include "kingw/de/try_deserialize.hpp"
 
 using namespace kingw::de;
 using namespace testing;
@@ -36,6 +38,8 @@ TEST(KingwSerde, VisitorNotImplemented) {
     EXPECT_THROW(visitor.visit_f64(0.0), Visitor::NotImplementedException);
     EXPECT_THROW(visitor.visit_char('\0'), Visitor::NotImplementedException);
     EXPECT_THROW(visitor.visit_string(""), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_borrowed_string(""), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_bytes(nullptr, 0), Visitor::NotImplementedException);
     EXPECT_THROW(visitor.visit_seq(mock_seq_access), Visitor::NotImplementedException);
     EXPECT_THROW(visitor.visit_map(mock_map_access), Visitor::NotImplementedException);
 }
@@ -183,6 +187,285 @@ TEST(KingwSerde, DeserializeChar) {
     deserialize<char>(mock_deserializer, data);
 }
 
+/// Visitor::visit_borrowed_string() will invoke visit_string() by default.
+///
+TEST(KingwSerde, VisitorBorrowedStringDefault) {
+    MockVisitor mock_visitor;
+    EXPECT_CALL(mock_visitor, visit_string(kingw::serde::string_view("hello")))
+        .Times(1);
+
+    mock_visitor.Visitor::visit_borrowed_string("hello");
+}
+
+/// deserialize<serde::string_view>(deserializer, value) will invoke
+/// deserializer.deserialize_string(StringViewVisitor)
+TEST(KingwSerde, DeserializeStringView) {
+    MockDeserializer mock_deserializer;
+    EXPECT_CALL(mock_deserializer, deserialize_string(WhenDynamicCastTo<const StringViewVisitor&>(_)))
+        .Times(1);
+
+    kingw::serde::string_view data;
+    deserialize<kingw::serde::string_view>(mock_deserializer, data);
+}
+
+/// deserialize<serde::ByteBuf>(deserializer, value) will invoke
+/// deserializer.deserialize_bytes(ByteBufVisitor)
+TEST(KingwSerde, DeserializeByteBuf) {
+    MockDeserializer mock_deserializer;
+    EXPECT_CALL(mock_deserializer, deserialize_bytes(WhenDynamicCastTo<const ByteBufVisitor&>(_)))
+        .Times(1);
+
+    kingw::serde::ByteBuf data;
+    deserialize<kingw::serde::ByteBuf>(mock_deserializer, data);
+}
+
+/// ByteBufVisitor::visit_seq() will read batches of u8 elements
+/// for formats without a native byte array.
+TEST(KingwSerde, ByteBufVisitorVisitSeq) {
+    std::size_t next_value = 0;
+    auto fill = [&](std::uint8_t* output, std::size_t len) {
+        len = std::min<std::size_t>(len, 300 - next_value);  // 300 in total
+        for (std::size_t i = 0; i < len; ++i) {
+            output[i] = static_cast<std::uint8_t>(next_value++);
+        }
+        return len;
+    };
+    MockSeqAccess mock_seq_access;
+    EXPECT_CALL(mock_seq_access, size_hint())
+        .WillRepeatedly(Return(300));
+    EXPECT_CALL(mock_seq_access, next_u8_elements(_, _))
+        .Times(2)
+        .WillRepeatedly(fill);
+    EXPECT_CALL(mock_seq_access, has_next())
+        .Times(1)
+        .WillOnce(Return(true));
+
+    kingw::serde::ByteBuf data;
+    ByteBufVisitor visitor(data);
+    visitor.visit_seq(mock_seq_access);
+    ASSERT_EQ(data.bytes.size(), 300);
+    for (std::size_t i = 0; i < 300; ++i) {
+        EXPECT_EQ(data.bytes[i], static_cast<std::uint8_t>(i));
+    }
+}
+
+/// Deserializer::deserialize_bytes(visitor) will, unless overridden,
+/// invoke deserializer.deserialize_seq(visitor)
+TEST(KingwSerde, DeserializeBytesDefault) {
+    MockDeserializer mock_deserializer;
+    MockVisitor mock_visitor;
+    EXPECT_CALL(mock_deserializer, deserialize_seq(Ref(mock_visitor)))
+        .Times(1);
+
+    mock_deserializer.Deserializer::deserialize_bytes(mock_visitor);
+}
+
+/// deserialize<IgnoredAny>(deserializer, value) will invoke
+/// deserializer.deserialize_ignored_any(IgnoredAnyVisitor)
+TEST(KingwSerde, DeserializeIgnoredAny) {
+    MockDeserializer mock_deserializer;
+    EXPECT_CALL(mock_deserializer, deserialize_ignored_any(WhenDynamicCastTo<const IgnoredAnyVisitor&>(_)))
+        .Times(1);
+
+    IgnoredAny data;
+    deserialize(mock_deserializer, data);
+}
+
+/// Deserializer::deserialize_ignored_any(visitor) will, unless overridden,
+/// invoke deserializer.deserialize_any(visitor)
+TEST(KingwSerde, DeserializeIgnoredAnyDefault) {
+    MockDeserializer mock_deserializer;
+    MockVisitor mock_visitor;
+    EXPECT_CALL(mock_deserializer, deserialize_any(Ref(mock_visitor)))
+        .Times(1);
+
+    mock_deserializer.Deserializer::deserialize_ignored_any(mock_visitor);
+}
+
+/// IgnoredAnyVisitor ignores every element of a sequence or map.
+TEST(KingwSerde, IgnoredAnyVisitorVisitSeqMap) {
+    IgnoredAnyVisitor visitor;
+
+    MockSeqAccess mock_seq_access;
+    EXPECT_CALL(mock_seq_access, has_next())
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(mock_seq_access, next_element(WhenDynamicCastTo<const Accessor<IgnoredAny>&>(_)))
+        .Times(2);
+    visitor.visit_seq(mock_seq_access);
+
+    MockMapAccess mock_map_access;
+    EXPECT_CALL(mock_map_access, has_next())
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(mock_map_access, next_entry(
+            WhenDynamicCastTo<const Accessor<IgnoredAny>&>(_),
+            WhenDynamicCastTo<const Accessor<IgnoredAny>&>(_)))
+        .Times(1);
+    visitor.visit_map(mock_map_access);
+}
+
+/// Deserializer::fail() throws DeserializationException with the
+/// error code by default.
+TEST(KingwSerde, DeserializerFailThrows) {
+    MockDeserializer mock_deserializer;
+    EXPECT_TRUE(mock_deserializer.throw_on_error());
+    try {
+        mock_deserializer.fail(ErrorCode::InvalidType, "invalid type");
+        FAIL();
+    } catch (const DeserializationException & e) {
+        EXPECT_EQ(e.code(), ErrorCode::InvalidType);
+        EXPECT_STREQ(e.what(), "invalid type");
+    }
+    EXPECT_FALSE(mock_deserializer.failed());
+    EXPECT_THROW(mock_deserializer.fail(ErrorCode::NotImplemented, ""), Visitor::NotImplementedException);
+}
+
+/// Without throw_on_error(), Deserializer::fail() keeps the first error only.
+TEST(KingwSerde, DeserializerFailRecords) {
+    MockDeserializer mock_deserializer;
+    mock_deserializer.set_throw_on_error(false);
+    EXPECT_FALSE(mock_deserializer.failed());
+    EXPECT_FALSE(mock_deserializer.error());
+
+    mock_deserializer.fail(ErrorCode::EndOfInput, "first");
+    mock_deserializer.fail(ErrorCode::Syntax, "second");
+    EXPECT_TRUE(mock_deserializer.failed());
+    EXPECT_EQ(mock_deserializer.error().code, ErrorCode::EndOfInput);
+    EXPECT_STREQ(mock_deserializer.error().message, "first");
+}
+
+/// Deserializer::report_to() shares the error state of the parent.
+TEST(KingwSerde, DeserializerReportTo) {
+    MockDeserializer parent;
+    MockDeserializer child;
+    child.report_to(parent);
+    parent.set_throw_on_error(false);
+    EXPECT_FALSE(child.throw_on_error());
+
+    child.fail(ErrorCode::InvalidValue, "child");
+    EXPECT_TRUE(parent.failed());
+    EXPECT_EQ(parent.error().code, ErrorCode::InvalidValue);
+}
+
+/// Deserializer::deserialize_at() adds the index or key to the path
+/// of a thrown exception, outermost first.
+TEST(KingwSerde, DeserializerDeserializeAtThrows) {
+    MockDeserializer mock_deserializer;
+    MockDeserialize inner;
+    MockDeserialize outer;
+    EXPECT_CALL(outer, deserialize(Ref(mock_deserializer)))
+        .WillOnce([&](Deserializer & deserializer) { deserializer.deserialize_at("price", inner); });
+    EXPECT_CALL(inner, deserialize(Ref(mock_deserializer)))
+        .WillOnce([](Deserializer & deserializer) { deserializer.fail(ErrorCode::InvalidType, "not a number"); });
+
+    try {
+        mock_deserializer.deserialize_at(17, outer);
+        FAIL();
+    } catch (const DeserializationException & e) {
+        EXPECT_EQ(e.path(), "[17].price");
+        EXPECT_STREQ(e.what(), "[17].price: not a number");
+    }
+}
+
+/// Deserializer::deserialize_at() adds the index or key to the path
+/// of a recorded error, and leaves successful elements alone.
+TEST(KingwSerde, DeserializerDeserializeAtRecords) {
+    MockDeserializer mock_deserializer;
+    mock_deserializer.set_throw_on_error(false);
+    MockDeserialize ok;
+    MockDeserialize bad;
+    EXPECT_CALL(ok, deserialize(_)).Times(1);
+    EXPECT_CALL(bad, deserialize(_))
+        .WillOnce([](Deserializer & deserializer) { deserializer.fail(ErrorCode::InvalidType, "not a number"); });
+
+    mock_deserializer.deserialize_at("id", ok);
+    EXPECT_EQ(mock_deserializer.error().path, "");
+    mock_deserializer.deserialize_at(3, bad);
+    mock_deserializer.add_error_path("orders");
+    EXPECT_EQ(mock_deserializer.error().path, "orders[3]");
+    EXPECT_EQ(mock_deserializer.error().code, ErrorCode::InvalidType);
+}
+
+/// An exception without a path has the message as its what().
+TEST(KingwSerde, DeserializationExceptionNoPath) {
+    DeserializationException e("message");
+    EXPECT_EQ(e.path(), "");
+    EXPECT_STREQ(e.what(), "message");
+}
+
+/// try_deserialize<T>(deserializer, value) returns the visitor's error
+/// instead of throwing it, and restores throw_on_error() afterwards.
+TEST(KingwSerde, TryDeserializeRecords) {
+    MockDeserializer mock_deserializer;
+    EXPECT_CALL(mock_deserializer, deserialize_i8(_))
+        .Times(1)
+        .WillOnce([](Visitor & visitor) { visitor.visit_i64(1000); });
+
+    std::int8_t data = 5;
+    Error error;
+    EXPECT_NO_THROW(error = try_deserialize(mock_deserializer, data));
+    EXPECT_EQ(error.code, ErrorCode::InvalidValue);
+    EXPECT_EQ(data, 5);
+    EXPECT_TRUE(mock_deserializer.throw_on_error());
+}
+
+/// try_deserialize<T>(deserializer, value) returns no error on success.
+TEST(KingwSerde, TryDeserializeSuccess) {
+    MockDeserializer mock_deserializer;
+    EXPECT_CALL(mock_deserializer, deserialize_u64(_))
+        .Times(1)
+        .WillOnce([](Visitor & visitor) { visitor.visit_u8(7); });
+
+    std::uint64_t data = 0;
+    EXPECT_FALSE(try_deserialize(mock_deserializer, data));
+    EXPECT_EQ(data, 7);
+}
+
+/// The integral visitors reject negative values for unsigned outputs.
+TEST(KingwSerde, DeserializeU64Negative) {
+    MockDeserializer mock_deserializer;
+    EXPECT_CALL(mock_deserializer, deserialize_u64(_))
+        .Times(1)
+        .WillOnce([](Visitor & visitor) { visitor.visit_i64(-1); });
+
+    std::uint64_t data = 0;
+    EXPECT_THROW(deserialize(mock_deserializer, data), DeserializationException);
+}
+
+/// A visitor that does not report_to() a deserializer always throws.
+TEST(KingwSerde, VisitorUnreportedThrows) {
+    std::int8_t data = 0;
+    I8Visitor visitor(data);
+    EXPECT_THROW(visitor.visit_i64(1000), DeserializationException);
+}
+
+/// A trusted deserializer's visitors truncate numbers outside their range
+/// instead of failing, unless trusted input is validated anyway.
+TEST(KingwSerde, DeserializerTrusted) {
+    MockDeserializer parent;
+    MockDeserializer child;
+    child.report_to(parent);
+    EXPECT_FALSE(child.trusted());
+    parent.set_trusted(true);
+    EXPECT_EQ(child.trusted(), !KINGW_SERDE_VALIDATE_TRUSTED);
+
+    EXPECT_CALL(child, deserialize_i8(_))
+        .Times(1)
+        .WillOnce([](Visitor & visitor) { visitor.visit_i64(1000); });
+
+    std::int8_t data = 5;
+    const Error error = try_deserialize(child, data);
+#if KINGW_SERDE_VALIDATE_TRUSTED
+    EXPECT_EQ(error.code, ErrorCode::InvalidValue);
+    EXPECT_EQ(data, 5);
+#else
+    EXPECT_FALSE(error);
+    EXPECT_EQ(data, static_cast<std::int8_t>(1000));
+#endif
+}
+
 /// deserialize<std::string>(deserializer, value) will invoke deserializer.deserialize_string(StringVisitor)
 ///
 /*
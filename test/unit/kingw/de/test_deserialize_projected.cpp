@@ -0,0 +1,120 @@
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/de/templates/stdvector.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/de/deserialize_projected.hpp"
+#include "kingw/serde/derive.hpp"
+#include "kingw/serde/tape.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+// Named, so that DERIVE_SERDE() functions that go unused here don't warn.
+namespace projected_test {
+
+struct Event {
+    std::string name;
+    std::int32_t id = 0;
+    std::vector<std::string> tags;
+};
+
+struct Batch {
+    std::string source;
+    std::vector<Event> events;
+};
+
+/// Serialized as a sequence of fields, like formats without field names.
+struct PositionalEvent {
+    Event event;
+};
+
+}  // namespace projected_test
+
+using namespace projected_test;
+
+DERIVE_SERDE(Event,
+    ("name", &Self::name)
+    ("id", &Self::id)
+    ("tags", &Self::tags));
+
+DERIVE_SERDE(Batch,
+    ("source", &Self::source)
+    ("events", &Self::events));
+
+template <>
+void kingw::ser::serialize<PositionalEvent>(ser::Serializer & serializer, const PositionalEvent & input) {
+    auto seq = serializer.serialize_seq(3);
+    seq.serialize_element(ser::accessor(input.event.name));
+    seq.serialize_element(ser::accessor(input.event.id));
+    seq.serialize_element(ser::accessor(input.event.tags));
+    seq.end();
+}
+
+
+namespace {
+
+template <class T>
+serde::Tape record(const T & input) {
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape);
+    ser::serialize(recorder, input);
+    return tape;
+}
+
+/// Fields that are not selected are skipped, and keep their old values.
+TEST(KingwSerde, DeserializeProjectedMap) {
+    const serde::Tape tape = record(Event{ "first", 7, { "a", "b" } });
+
+    Event output{ "unchanged", 0, { "c" } };
+    de::TapeDeserializer deserializer(tape);
+    de::deserialize_projected(deserializer, output, de::FieldMask("Event").select(2));
+    EXPECT_EQ(output.name, "unchanged");
+    EXPECT_EQ(output.id, 7);
+    EXPECT_THAT(output.tags, ElementsAre("c"));
+    EXPECT_EQ(deserializer.field_mask(), nullptr);
+}
+
+/// Positional fields that are not selected are skipped too.
+TEST(KingwSerde, DeserializeProjectedSeq) {
+    const serde::Tape tape = record(PositionalEvent{ Event{ "first", 7, { "a", "b" } } });
+
+    Event output{ "unchanged", 0, {} };
+    de::TapeDeserializer deserializer(tape);
+    de::deserialize_projected(deserializer, output, de::FieldMask("Event").select(2).select(3));
+    EXPECT_EQ(output.name, "unchanged");
+    EXPECT_EQ(output.id, 7);
+    EXPECT_THAT(output.tags, ElementsAre("a", "b"));
+
+    // The sequence must still have one element per field.
+    const serde::Tape short_tape = record(std::vector<std::string>{ "first" });
+    de::TapeDeserializer short_deserializer(short_tape);
+    EXPECT_THROW(
+        de::deserialize_projected(short_deserializer, output, de::FieldMask("Event").select(1)),
+        de::DeserializationException);
+}
+
+/// The mask applies to every struct with its name, however deep,
+/// and to no other struct.
+TEST(KingwSerde, DeserializeProjectedNested) {
+    const serde::Tape tape = record(Batch{ "source", {
+        Event{ "first", 1, { "a" } },
+        Event{ "second", 2, {} },
+    } });
+
+    Batch output;
+    de::TapeDeserializer deserializer(tape);
+    de::deserialize_projected(deserializer, output, de::FieldMask("Event").select(1));
+    EXPECT_EQ(output.source, "source");
+    ASSERT_EQ(output.events.size(), 2u);
+    EXPECT_EQ(output.events[0].name, "first");
+    EXPECT_EQ(output.events[0].id, 0);
+    EXPECT_THAT(output.events[0].tags, IsEmpty());
+    EXPECT_EQ(output.events[1].name, "second");
+    EXPECT_EQ(output.events[1].id, 0);
+}
+
+}  // namespace
@@ -0,0 +1,160 @@
+#include <deque>
+#include <string>
+
+#include <gmock/gmock.h>
+
+#include "kingw/de/deserializer.hpp"
+#include "kingw/de/feed_async.hpp"
+
+// Built as C++20 by the kingw_dynamic_serde_coroutine_test target only.
+#if !KINGW_SERDE_COROUTINES
+#error "test_feed_async.cpp needs a compiler with C++20 coroutines"
+#endif
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// Non-blocking byte source, like a socket. Readers wait in
+/// next_chunk() until write() or close() is called.
+/// Chunks are string_views into the pipe, or with `Owned`, the strings themselves.
+template <bool Owned = false>
+class BasicPipe {
+public:
+    auto next_chunk() {
+        struct Awaiter {
+            BasicPipe & pipe;
+            bool await_ready() const { return !pipe.chunks.empty(); }
+            void await_suspend(std::coroutine_handle<> reader) { pipe.reader = reader; }
+            auto await_resume() {
+                std::string chunk = std::move(pipe.chunks.front());
+                pipe.chunks.pop_front();
+                if constexpr (Owned) {
+                    return chunk;
+                } else {
+                    pipe.current = std::move(chunk);
+                    return serde::string_view(pipe.current.data(), pipe.current.size());
+                }
+            }
+        };
+        return Awaiter{ *this };
+    }
+
+    void write(std::string chunk) {
+        chunks.push_back(std::move(chunk));
+        if (reader) {
+            std::exchange(reader, nullptr).resume();
+        }
+    }
+
+    void close() {
+        write(std::string());
+    }
+
+private:
+    std::deque<std::string> chunks;
+    std::string current;
+    std::coroutine_handle<> reader;
+};
+
+using Pipe = BasicPipe<>;
+
+/// Starts as soon as it is called, and runs until its first co_await
+/// that has to wait. Like a connection handler in a coroutine-based service.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+template <class Source>
+Detached handle_connection(de::ChunkedInput & input, Source & pipe, bool & finished, bool & failed) {
+    try {
+        co_await de::feed_async(input, pipe);
+    } catch (const de::DeserializationException &) {
+        failed = true;
+    }
+    finished = true;
+}
+
+/// Reads chunks until `size` bytes or the end of the input.
+de::ChunkedInput::Decode read_bytes(std::string & output, std::size_t size) {
+    return [&output, size](de::ChunkedInput & input) {
+        while (output.size() < size) {
+            serde::string_view chunk = input.next_chunk();
+            if (chunk.size() == 0) {
+                KINGW_SERDE_THROW(de::DeserializationException("end of input", de::ErrorCode::EndOfInput));
+            }
+            output.append(chunk.begin(), chunk.size());
+        }
+    };
+}
+
+/// The decode is fed each chunk as the source produces it, and the
+/// awaiting coroutine resumes once the decode has finished.
+TEST(KingwSerde, FeedAsync) {
+    std::string output;
+    de::ChunkedInput input(read_bytes(output, 6));
+    Pipe pipe;
+    bool finished = false;
+    bool failed = false;
+    handle_connection(input, pipe, finished, failed);
+    EXPECT_FALSE(finished);
+
+    pipe.write("ab");
+    EXPECT_EQ(output, "ab");
+    pipe.write("cd");
+    EXPECT_EQ(output, "abcd");
+    EXPECT_FALSE(finished);
+    pipe.write("ef");
+    EXPECT_EQ(output, "abcdef");
+    EXPECT_TRUE(finished);
+    EXPECT_FALSE(failed);
+    EXPECT_TRUE(input.done());
+}
+
+/// Errors from the decode are thrown from the co_await.
+TEST(KingwSerde, FeedAsyncThrows) {
+    std::string output;
+    de::ChunkedInput input(read_bytes(output, 6));
+    Pipe pipe;
+    bool finished = false;
+    bool failed = false;
+    handle_connection(input, pipe, finished, failed);
+
+    pipe.write("abc");
+    EXPECT_FALSE(finished);
+    pipe.close();
+    EXPECT_TRUE(finished);
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(output, "abc");
+}
+
+/// A source may give owning chunks, such as std::string. Each one
+/// is kept alive while it is fed. The chunks are too long for the
+/// small string buffer, so a dangling chunk would point at freed memory.
+TEST(KingwSerde, FeedAsyncOwnedChunks) {
+    const std::string first(20, 'a');
+    const std::string second(20, 'b');
+    std::string output;
+    de::ChunkedInput input(read_bytes(output, 40));
+    BasicPipe<true> pipe;
+    bool finished = false;
+    bool failed = false;
+    handle_connection(input, pipe, finished, failed);
+
+    pipe.write(first);
+    EXPECT_EQ(output, first);
+    pipe.write(second);
+    EXPECT_EQ(output, first + second);
+    EXPECT_TRUE(finished);
+    EXPECT_FALSE(failed);
+}
+
+}  // namespace
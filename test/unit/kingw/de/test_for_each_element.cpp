@@ -0,0 +1,167 @@
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/mock/de/mock_deserializer.hpp"
+#include "kingw/de/templates/stdvector.hpp"
+#include "kingw/de/for_each_element.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// de::for_each_element<T>() deserializes every element in place into
+/// the same T, and calls back with it before reading the next one.
+TEST(KingwSerde, ForEachElement) {
+    de::MockDeserializer deserializer;
+    de::MockSeqAccess seq_access;
+    int remaining = 2;
+    // Each element is a vector of one string.
+    de::MockSeqAccess element_access;
+    int element_remaining = 0;
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return remaining > 0; });
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            --remaining;
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_seq(_))
+        .WillOnce([&](de::Visitor & visitor) {
+            EXPECT_TRUE(deserializer.in_place());
+            visitor.visit_seq(seq_access);
+        })
+        .WillRepeatedly([&](de::Visitor & visitor) {
+            element_remaining = 1;
+            visitor.visit_seq(element_access);
+        });
+    EXPECT_CALL(element_access, size_hint())
+        .WillRepeatedly(Return(1));
+    EXPECT_CALL(element_access, has_next())
+        .WillRepeatedly([&]() { return element_remaining > 0; });
+    EXPECT_CALL(element_access, next_element(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            --element_remaining;
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_string(_))
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("first"); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("second"); });
+
+    std::vector<std::string> seen;
+    const std::vector<std::string>* previous = nullptr;
+    const std::size_t count = de::for_each_element<std::vector<std::string>>(deserializer,
+        [&](std::vector<std::string> & element) {
+            // Not appended to the previous element.
+            ASSERT_EQ(element.size(), 1);
+            seen.push_back(element[0]);
+            if (previous) {
+                EXPECT_EQ(&element, previous);
+            }
+            previous = &element;
+        });
+
+    EXPECT_EQ(count, 2);
+    EXPECT_THAT(seen, ElementsAre("first", "second"));
+    EXPECT_FALSE(deserializer.in_place());
+}
+
+/// de::for_each_element<T>() reads basic types in batches.
+///
+TEST(KingwSerde, ForEachElementBatched) {
+    de::MockDeserializer deserializer;
+    de::MockSeqAccess seq_access;
+    int remaining = 100;
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return remaining > 0; });
+    EXPECT_CALL(seq_access, next_i32_elements(_, 64))
+        .Times(2)
+        .WillRepeatedly([&](std::int32_t* output, std::size_t len) {
+            const std::size_t count = std::min<std::size_t>(len, remaining);
+            for (std::size_t i = 0; i < count; ++i) {
+                output[i] = static_cast<std::int32_t>(100 - remaining--);
+            }
+            return count;
+        });
+    EXPECT_CALL(deserializer, deserialize_seq(_))
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_seq(seq_access); });
+
+    std::int64_t sum = 0;
+    const std::size_t count = de::for_each_element<std::int32_t>(deserializer,
+        [&](std::int32_t value) { sum += value; });
+
+    EXPECT_EQ(count, 100);
+    EXPECT_EQ(sum, 99 * 100 / 2);
+}
+
+/// de::for_each_element<T>() still calls back with the elements of a
+/// batch that were read before a bad element.
+TEST(KingwSerde, ForEachElementBatchedFailure) {
+    de::MockDeserializer deserializer;
+    deserializer.set_throw_on_error(false);
+    de::MockSeqAccess seq_access;
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(seq_access, next_i32_elements(_, 64))
+        .WillOnce([&](std::int32_t* output, std::size_t len) {
+            for (std::size_t i = 0; i < len; ++i) {
+                output[i] = 1;
+            }
+            return len;
+        })
+        .WillOnce([&](std::int32_t* output, std::size_t) {
+            // The fourth element of the second batch is bad.
+            output[0] = output[1] = output[2] = 1;
+            deserializer.fail(de::ErrorCode::InvalidType, "bad element");
+            return std::size_t{3};
+        });
+    EXPECT_CALL(deserializer, deserialize_seq(_))
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_seq(seq_access); });
+
+    std::int64_t sum = 0;
+    const std::size_t count = de::for_each_element<std::int32_t>(deserializer,
+        [&](std::int32_t value) { sum += value; });
+
+    EXPECT_EQ(count, 67);
+    EXPECT_EQ(sum, 67);
+    EXPECT_TRUE(deserializer.failed());
+}
+
+/// The generic de::next_elements<T>() does not count an element that
+/// failed without throwing.
+TEST(KingwSerde, NextElementsStopsAtFailure) {
+    de::MockDeserializer deserializer;
+    deserializer.set_throw_on_error(false);
+    de::MockSeqAccess seq_access;
+    seq_access.report_to(deserializer);
+    std::int32_t next = 0;
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(3)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_i32(_))
+        .Times(3)
+        .WillRepeatedly([&](de::Visitor & visitor) {
+            if (next == 2) {
+                deserializer.fail(de::ErrorCode::InvalidType, "bad element");
+                return;
+            }
+            visitor.visit_i32(next++);
+        });
+
+    std::int32_t output[4] = {};
+    EXPECT_EQ(de::next_elements<std::int32_t>(seq_access, output, 4), 2);
+    EXPECT_EQ(output[0], 0);
+    EXPECT_EQ(output[1], 1);
+    EXPECT_TRUE(deserializer.failed());
+}
+
+}  // namespace
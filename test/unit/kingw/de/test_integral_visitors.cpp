@@ -138,3 +138,79 @@ TEST(KingwSerde, StringVisitorInvalid) {
     EXPECT_THROW(visitor.visit_f64(0), Visitor::NotImplementedException);
     EXPECT_THROW(visitor.visit_char('\0'), Visitor::NotImplementedException);
 }
+
+TEST(KingwSerde, StringViewVisitorExpecting) {
+    kingw::serde::string_view output;
+    StringViewVisitor visitor(output);
+    EXPECT_STREQ(visitor.expecting(), "a borrowed string");
+}
+
+TEST(KingwSerde, StringViewVisitorValid) {
+    const char input[] = "hello";
+    kingw::serde::string_view output;
+    StringViewVisitor visitor(output);
+
+    visitor.visit_borrowed_string(kingw::serde::string_view(input, 5));
+    EXPECT_EQ(output.data(), input);  // Not copied
+    EXPECT_EQ(output.size(), 5);
+}
+
+TEST(KingwSerde, StringViewVisitorInvalid) {
+    kingw::serde::string_view output;
+    StringViewVisitor visitor(output);
+
+    EXPECT_THROW(visitor.visit_bool(false), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_i32(0), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_char('\0'), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_string("hello"), DeserializationException);
+}
+
+TEST(KingwSerde, ByteBufVisitorExpecting) {
+    kingw::serde::ByteBuf output;
+    ByteBufVisitor visitor(output);
+    EXPECT_STREQ(visitor.expecting(), "a byte array");
+}
+
+TEST(KingwSerde, ByteBufVisitorValid) {
+    const std::uint8_t input[] = { 0x00, 0x7F, 0xFF };
+    kingw::serde::ByteBuf output{ { 0x01 } };
+    ByteBufVisitor visitor(output);
+
+    visitor.visit_bytes(input, 3);
+    EXPECT_EQ(output.bytes, std::vector<std::uint8_t>({ 0x00, 0x7F, 0xFF }));  // Replaced
+}
+
+TEST(KingwSerde, ByteBufVisitorInvalid) {
+    kingw::serde::ByteBuf output;
+    ByteBufVisitor visitor(output);
+
+    EXPECT_THROW(visitor.visit_bool(false), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_u8(0), Visitor::NotImplementedException);
+    EXPECT_THROW(visitor.visit_string("aGVsbG8="), Visitor::NotImplementedException);
+}
+
+TEST(KingwSerde, IgnoredAnyVisitorExpecting) {
+    IgnoredAnyVisitor visitor;
+    EXPECT_STREQ(visitor.expecting(), "anything at all");
+}
+
+TEST(KingwSerde, IgnoredAnyVisitorValid) {
+    const std::uint8_t bytes[] = { 0x00, 0xFF };
+    IgnoredAnyVisitor visitor;
+
+    EXPECT_NO_THROW(visitor.visit_bool(true));
+    EXPECT_NO_THROW(visitor.visit_i8(-1));
+    EXPECT_NO_THROW(visitor.visit_i16(-1));
+    EXPECT_NO_THROW(visitor.visit_i32(-1));
+    EXPECT_NO_THROW(visitor.visit_i64(-1));
+    EXPECT_NO_THROW(visitor.visit_u8(1));
+    EXPECT_NO_THROW(visitor.visit_u16(1));
+    EXPECT_NO_THROW(visitor.visit_u32(1));
+    EXPECT_NO_THROW(visitor.visit_u64(1));
+    EXPECT_NO_THROW(visitor.visit_f32(0.5));
+    EXPECT_NO_THROW(visitor.visit_f64(0.5));
+    EXPECT_NO_THROW(visitor.visit_char('a'));
+    EXPECT_NO_THROW(visitor.visit_string("abc"));
+    EXPECT_NO_THROW(visitor.visit_borrowed_string("abc"));
+    EXPECT_NO_THROW(visitor.visit_bytes(bytes, 2));
+}
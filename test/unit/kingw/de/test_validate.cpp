@@ -0,0 +1,139 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/de/templates/stdmap.hpp"
+#include "kingw/de/templates/stdvector.hpp"
+#include "kingw/ser/templates/stdmap.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/de/try_deserialize.hpp"
+#include "kingw/de/validate.hpp"
+#include "kingw/serde/derive.hpp"
+#include "kingw/serde/tape.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+// Named, so that DERIVE_SERDE() functions that go unused here don't warn.
+namespace validate_test {
+
+struct Order {
+    std::string name;
+    std::vector<std::int32_t> quantities;
+    std::map<std::string, double> prices;
+};
+
+/// Same fields as Order, but too narrow for its quantities.
+struct SmallOrder {
+    std::string name;
+    std::vector<std::uint8_t> quantities;
+};
+
+/// Has a hand-written deserialize<T>(), and validates through it.
+struct Stamp {
+    std::int64_t ticks;
+};
+
+struct Stamped {
+    std::string name;
+    Stamp stamp;
+};
+
+}  // namespace validate_test
+
+using namespace validate_test;
+
+template <>
+void kingw::ser::serialize<Stamp>(ser::Serializer & serializer, const Stamp & input) {
+    ser::serialize(serializer, input.ticks);
+}
+
+template <>
+void kingw::de::deserialize<Stamp>(de::Deserializer & deserializer, Stamp & output) {
+    de::deserialize(deserializer, output.ticks);
+}
+
+template <>
+void kingw::de::Validator<Stamp>::validate(de::Deserializer & deserializer) {
+    de::validate_by_deserializing<Stamp>(deserializer);
+}
+
+DERIVE_SERDE(Order,
+    ("name", &Self::name)
+    ("quantities", &Self::quantities)
+    ("prices", &Self::prices));
+
+DERIVE_SERDE(SmallOrder,
+    ("name", &Self::name)
+    ("quantities", &Self::quantities));
+
+DERIVE_SERDE(Stamped,
+    ("name", &Self::name)
+    ("stamp", &Self::stamp));
+
+
+namespace {
+
+template <class T>
+serde::Tape record(const T & input) {
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape);
+    ser::serialize(recorder, input);
+    return tape;
+}
+
+/// de::validate<T>() accepts input that de::deserialize<T>() accepts.
+TEST(KingwSerde, ValidateValid) {
+    const serde::Tape tape = record(Order{ "first", { 1, -2, 3 }, { { "a", 1.5 } } });
+
+    de::TapeDeserializer deserializer(tape);
+    EXPECT_FALSE(de::validate<Order>(deserializer));
+    EXPECT_TRUE(deserializer.throw_on_error());
+
+    // Fields the output does not have are skipped, like when deserializing.
+    const serde::Tape small_tape = record(Order{ "second", { 1, 2 }, {} });
+    de::TapeDeserializer small_deserializer(small_tape);
+    EXPECT_FALSE(de::validate<SmallOrder>(small_deserializer));
+}
+
+/// de::validate<T>() reports the same error, at the same path,
+/// as de::try_deserialize<T>() would.
+TEST(KingwSerde, ValidateInvalid) {
+    const serde::Tape tape = record(Order{ "first", { 1, -2, 3 }, {} });
+
+    de::TapeDeserializer deserializer(tape);
+    const de::Error error = de::validate<SmallOrder>(deserializer);
+    EXPECT_EQ(error.code, de::ErrorCode::InvalidValue);
+    EXPECT_EQ(error.path, "quantities[1]");
+
+    SmallOrder output;
+    de::TapeDeserializer compare(tape);
+    const de::Error expected = de::try_deserialize(compare, output);
+    EXPECT_EQ(error.code, expected.code);
+    EXPECT_EQ(error.path, expected.path);
+
+    // A struct is not a sequence.
+    std::vector<std::string> names;
+    de::TapeDeserializer wrong_type(tape);
+    de::TapeDeserializer compare_wrong_type(tape);
+    const de::Error wrong_type_error = de::validate<std::vector<std::string>>(wrong_type);
+    EXPECT_TRUE(wrong_type_error);
+    EXPECT_EQ(wrong_type_error.code, de::try_deserialize(compare_wrong_type, names).code);
+}
+
+/// A type can be validated by deserializing into a temporary, through
+/// its deserialize<T>(), and derived structs validate it as a field.
+TEST(KingwSerde, ValidateByDeserializing) {
+    const serde::Tape tape = record(Stamped{ "first", Stamp{ 42 } });
+    de::TapeDeserializer deserializer(tape);
+    EXPECT_FALSE(de::validate<Stamped>(deserializer));
+
+    const serde::Tape wrong_type = record(Order{ "first", {}, {} });
+    de::TapeDeserializer wrong_type_deserializer(wrong_type);
+    EXPECT_TRUE(de::validate<Stamp>(wrong_type_deserializer));
+}
+
+}  // namespace
@@ -2,6 +2,7 @@
 
 #include "kingw/mock/ser/mock_serializer.hpp"
 #include "kingw/ser/templates/stdmap.hpp"
+#include "kingw/ser/templates/stdunorderedmap.hpp"
 #include "kingw/ser/templates/stdvector.hpp"
 
 using namespace kingw;
@@ -88,10 +89,53 @@ TEST(KingwSerde, StdMapSerAccessorTraits) {
     EXPECT_EQ(accessor.traits(), traits);
 }
 
+/// ser::accessor(std::unordered_map<K, V>)::serialize() inserts every
+/// entry of the map into the Serializer.
+TEST(KingwSerde, StdUnorderedMapSerAccessor) {
+    ser::MockSerializer serializer;
+    EXPECT_CALL(serializer, map_begin(2))
+        .Times(1);
+    EXPECT_CALL(serializer, map_serialize_entry(_, _))
+        .Times(2)
+        .WillRepeatedly([&](const ser::Serialize & key, const ser::Serialize & value) {
+            key.serialize(serializer);
+            value.serialize(serializer);
+        });
+    EXPECT_CALL(serializer, map_end())
+        .Times(1);
 
-/// ser::serialize<std::vector<T>>(Serializer, std::vector<T>) will correctly
-/// insert contents into Serializer.
+    Sequence kvp1;
+    EXPECT_CALL(serializer, serialize_i32(1)).Times(1).InSequence(kvp1);
+    EXPECT_CALL(serializer, serialize_i32(2)).Times(1).InSequence(kvp1);
+    Sequence kvp2;
+    EXPECT_CALL(serializer, serialize_i32(3)).Times(1).InSequence(kvp2);
+    EXPECT_CALL(serializer, serialize_i32(4)).Times(1).InSequence(kvp2);
+
+    std::unordered_map<int, int> map;
+    map[1] = 2;
+    map[3] = 4;
+    ser::Accessor<std::unordered_map<int, int>> accessor = ser::accessor(map);
+    accessor.serialize(serializer);
+
+    auto traits = serde::TypeTraits::of<std::unordered_map<int, int>>();
+    EXPECT_EQ(accessor.traits(), traits);
+}
+
+
+/// ser::serialize<std::vector<T>>(Serializer, std::vector<T>) will hand a vector
+/// of basic types to the Serializer in one serialize_*_seq() call.
 TEST(KingwSerde, StdVectorSerialize) {
+    ser::MockSerializer serializer;
+    std::vector<int> vec{ 1, 2, 3 };
+    EXPECT_CALL(serializer, serialize_i32_seq(vec.data(), 3))
+        .Times(1);
+
+    ser::serialize(serializer, vec);
+}
+
+/// ser::serialize<std::vector<T>>(Serializer, std::vector<T>) will insert
+/// elements that are not basic types into the Serializer one at a time.
+TEST(KingwSerde, StdVectorSerializeElements) {
     ser::MockSerializer serializer;
     EXPECT_CALL(serializer, seq_begin(3))
         .Times(1);
@@ -104,22 +148,22 @@ TEST(KingwSerde, StdVectorSerialize) {
         .Times(1);
 
     InSequence order;  // Elements must be serialized in this order.
-    EXPECT_CALL(serializer, serialize_i32(1)).Times(1);
-    EXPECT_CALL(serializer, serialize_i32(2)).Times(1);
-    EXPECT_CALL(serializer, serialize_i32(3)).Times(1);
+    EXPECT_CALL(serializer, serialize_string(serde::string_view("a"))).Times(1);
+    EXPECT_CALL(serializer, serialize_string(serde::string_view("b"))).Times(1);
+    EXPECT_CALL(serializer, serialize_string(serde::string_view("c"))).Times(1);
 
-    std::vector<int> vec{ 1, 2, 3 };
+    std::vector<std::string> vec{ "a", "b", "c" };
     ser::serialize(serializer, vec);
 }
 
-/// ser::accessor(std::vector<T>)::serialize() invokes ser::serialize(std::vector<T>)
-///
-TEST(KingwSerde, StdVectorSerAccessor) {
+/// ser::serialize<std::vector<bool>>(Serializer, std::vector<bool>) has no
+/// contiguous storage, so it will insert elements one at a time.
+TEST(KingwSerde, StdVectorBoolSerialize) {
     ser::MockSerializer serializer;
-    EXPECT_CALL(serializer, seq_begin(3))
+    EXPECT_CALL(serializer, seq_begin(2))
         .Times(1);
     EXPECT_CALL(serializer, seq_serialize_element(_))
-        .Times(3)
+        .Times(2)
         .WillRepeatedly([&](const ser::Serialize & element) {
             element.serialize(serializer);
         });
@@ -127,11 +171,21 @@ TEST(KingwSerde, StdVectorSerAccessor) {
         .Times(1);
 
     InSequence order;  // Elements must be serialized in this order.
-    EXPECT_CALL(serializer, serialize_i32(1)).Times(1);
-    EXPECT_CALL(serializer, serialize_i32(2)).Times(1);
-    EXPECT_CALL(serializer, serialize_i32(3)).Times(1);
+    EXPECT_CALL(serializer, serialize_bool(true)).Times(1);
+    EXPECT_CALL(serializer, serialize_bool(false)).Times(1);
+
+    std::vector<bool> vec{ true, false };
+    ser::serialize(serializer, vec);
+}
 
+/// ser::accessor(std::vector<T>)::serialize() invokes ser::serialize(std::vector<T>)
+///
+TEST(KingwSerde, StdVectorSerAccessor) {
+    ser::MockSerializer serializer;
     std::vector<int> vec{ 1, 2, 3 };
+    EXPECT_CALL(serializer, serialize_i32_seq(vec.data(), 3))
+        .Times(1);
+
     ser::Accessor<std::vector<int>> accessor = ser::accessor(vec);
     accessor.serialize(serializer);
 }
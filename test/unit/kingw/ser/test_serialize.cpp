@@ -1,9 +1,12 @@
 #include <limits>
+#include <list>
+#include <vector>
 
 #include <gmock/gmock.h>
 
 #include "kingw/mock/ser/mock_serialize.hpp"
 #include "kingw/mock/ser/mock_serializer.hpp"
+#include "kingw/serde/bytes.hpp"
 
 using namespace kingw;
 using namespace kingw::ser;
@@ -294,4 +297,114 @@ TEST(KingwSerde, SerializeString) {
     serialize<std::string>(mock_serializer, "World");
 }
 
+/// serialize_array(serializer, data, len) of a basic type will invoke
+/// the matching serializer.serialize_*_seq(data, len)
+TEST(KingwSerde, SerializeArray) {
+    const std::int32_t i32s[] = { 1, 2, 3 };
+    const double f64s[] = { 1.0, 2.0 };
+    MockSerializer mock_serializer;
+    EXPECT_CALL(mock_serializer, serialize_i32_seq(i32s, 3))
+        .Times(1);
+    EXPECT_CALL(mock_serializer, serialize_f64_seq(f64s, 2))
+        .Times(1);
+
+    serialize_array(mock_serializer, i32s, 3);
+    serialize_array(mock_serializer, f64s, 2);
+}
+
+/// serialize_range(serializer, begin, end) will serialize a sequence with one
+/// element per iterator, passing the length only for random access iterators.
+TEST(KingwSerde, SerializeRange) {
+    const std::vector<std::int32_t> vector{ 1, 2 };
+    const std::list<std::int32_t> list{ 3, 4 };
+    MockSerializer mock_serializer;
+    EXPECT_CALL(mock_serializer, seq_serialize_element(_))
+        .Times(4)
+        .WillRepeatedly([&](const Serialize & element) {
+            element.serialize(mock_serializer);
+        });
+    EXPECT_CALL(mock_serializer, seq_end())
+        .Times(2);
+
+    InSequence order;
+    EXPECT_CALL(mock_serializer, seq_begin(2)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_i32(1)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_i32(2)).Times(1);
+    EXPECT_CALL(mock_serializer, seq_begin(Serializer::UNKNOWN_LENGTH)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_i32(3)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_i32(4)).Times(1);
+
+    serialize_range(mock_serializer, vector.begin(), vector.end());
+    serialize_range(mock_serializer, list.begin(), list.end());
+}
+
+/// serialize_generator<T>(serializer, next) will serialize a sequence of unknown
+/// length, with one element per call to next() until it returns false.
+TEST(KingwSerde, SerializeGenerator) {
+    MockSerializer mock_serializer;
+    EXPECT_CALL(mock_serializer, seq_serialize_element(_))
+        .Times(3)
+        .WillRepeatedly([&](const Serialize & element) {
+            element.serialize(mock_serializer);
+        });
+
+    InSequence order;
+    EXPECT_CALL(mock_serializer, seq_begin(Serializer::UNKNOWN_LENGTH)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_u64(10)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_u64(20)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_u64(30)).Times(1);
+    EXPECT_CALL(mock_serializer, seq_end()).Times(1);
+
+    std::uint64_t next = 0;
+    serialize_generator<std::uint64_t>(mock_serializer, [&](std::uint64_t & element) {
+        element = (next += 10);
+        return next <= 30;
+    });
+}
+
+/// Serializer::serialize_*_seq(values, len) will, unless overridden, serialize
+/// a sequence with one element per value.
+TEST(KingwSerde, SerializeSeqDefault) {
+    const std::uint16_t values[] = { 4, 5, 6 };
+    MockSerializer mock_serializer;
+    EXPECT_CALL(mock_serializer, seq_begin(3))
+        .Times(1);
+    EXPECT_CALL(mock_serializer, seq_serialize_element(_))
+        .Times(3)
+        .WillRepeatedly([&](const Serialize & element) {
+            element.serialize(mock_serializer);
+        });
+    EXPECT_CALL(mock_serializer, seq_end())
+        .Times(1);
+
+    InSequence order;  // Elements must be serialized in this order.
+    EXPECT_CALL(mock_serializer, serialize_u16(4)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_u16(5)).Times(1);
+    EXPECT_CALL(mock_serializer, serialize_u16(6)).Times(1);
+
+    mock_serializer.Serializer::serialize_u16_seq(values, 3);
+}
+
+/// serialize<serde::ByteBuf>(serializer, value) will invoke serializer.serialize_bytes(data, len)
+///
+TEST(KingwSerde, SerializeByteBuf) {
+    serde::ByteBuf data{ { 0x00, 0xFF, 0x10 } };
+    MockSerializer mock_serializer;
+    EXPECT_CALL(mock_serializer, serialize_bytes(data.bytes.data(), 3))
+        .Times(1);
+
+    serialize<serde::ByteBuf>(mock_serializer, data);
+}
+
+/// Serializer::serialize_bytes(data, len) will, unless overridden,
+/// invoke serializer.serialize_u8_seq(data, len)
+TEST(KingwSerde, SerializeBytesDefault) {
+    const std::uint8_t values[] = { 1, 2, 3 };
+    MockSerializer mock_serializer;
+    EXPECT_CALL(mock_serializer, serialize_u8_seq(values, 3))
+        .Times(1);
+
+    mock_serializer.Serializer::serialize_bytes(values, 3);
+}
+
 }  // namespace
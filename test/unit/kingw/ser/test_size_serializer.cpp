@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/fixtures.hpp"
+#include "kingw/ser/size_serializer.hpp"
+#include "kingw/ser/templates/stdmap.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/json_size_serializer.hpp"
+#include "kingw/serde_json.hpp"
+#include "kingw/serde_sprintf.hpp"
+#include "kingw/sprintf_size_serializer.hpp"
+
+using namespace kingw;
+using namespace kingw::ser;
+using namespace kingw::fixtures;
+
+
+namespace {
+
+const double NAN_DOUBLE = std::numeric_limits<double>::quiet_NaN();
+const double INF_DOUBLE = std::numeric_limits<double>::infinity();
+
+/// Doubles whose printed length changes near them.
+const std::vector<double> EDGE_DOUBLES{
+    0.0, -0.0, 9.9999996, -1e-7, 1e15, 1e16 - 1, 1e16, 0.1, 1.0 / 3.0, 123456.789,
+    9.5, 99.999999, -99.9999995, 1e-300, 1e300,
+    std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+    std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min(),
+    NAN_DOUBLE, -NAN_DOUBLE, INF_DOUBLE, -INF_DOUBLE };
+
+/// serde_sprintf::buffer_size() is exactly the buffer that to_buffer() fills:
+/// a buffer of that size holds the same output as a larger one.
+template <class T>
+void expect_sprintf_size(const T & input) {
+    std::vector<char> large(8192, 'x');
+    char* large_end = serde_sprintf::to_buffer(input, large.data(), large.data() + large.size());
+    const std::string expected(large.data(), large_end);
+    // The last token is followed by '\0' too, when there is room.
+    const std::size_t size = serde_sprintf::buffer_size(input);
+    EXPECT_EQ(size, expected.size() + 1);
+
+    std::vector<char> exact(size);
+    char* exact_end = serde_sprintf::to_buffer(input, exact.data(), exact.data() + exact.size());
+    EXPECT_EQ(std::string(exact.data(), exact_end), expected);
+}
+
+/// serde_json::string_size() is the length of to_string().
+template <class T>
+void expect_json_size(const T & input) {
+    EXPECT_EQ(serde_json::string_size(input), serde_json::to_string(input).size())
+        << serde_json::to_string(input);
+}
+
+/// decimal_length(value) is the length of the value printed in decimal,
+/// including the '-' of negative numbers.
+TEST(KingwSerde, DecimalLength) {
+    EXPECT_EQ(decimal_length(std::uint64_t(0)), 1);
+    EXPECT_EQ(decimal_length(std::int64_t(-1)), 2);
+    EXPECT_EQ(decimal_length(std::numeric_limits<std::uint64_t>::max()), 20);
+    EXPECT_EQ(decimal_length(std::numeric_limits<std::int64_t>::min()), 20);
+
+    // Either side of every power of 10.
+    std::uint64_t power = 1;
+    for (std::size_t digits = 1; digits < 20; ++digits) {
+        EXPECT_EQ(decimal_length(power), digits);
+        EXPECT_EQ(decimal_length(power * 10 - 1), digits);
+        EXPECT_EQ(decimal_length(-static_cast<std::int64_t>(power)), digits + 1);
+        power *= 10;
+    }
+
+    // Either side of every power of 2.
+    auto printed_length = [](std::uint64_t value) {
+        char buffer[32];
+        return static_cast<std::size_t>(std::snprintf(buffer, sizeof(buffer), "%llu",
+            static_cast<unsigned long long>(value)));
+    };
+    for (std::size_t bits = 1; bits < 64; ++bits) {
+        const std::uint64_t value = std::uint64_t(1) << bits;
+        EXPECT_EQ(decimal_length(value), printed_length(value));
+        EXPECT_EQ(decimal_length(value - 1), printed_length(value - 1));
+    }
+}
+
+/// Sizes of basic values, including floats near powers of 10 and non-finite ones.
+TEST(KingwSerde, SizeSerializerBasic) {
+    for (double value : EDGE_DOUBLES) {
+        expect_sprintf_size(value);
+        expect_sprintf_size(static_cast<float>(value));
+        expect_json_size(value);
+        expect_json_size(static_cast<float>(value));
+    }
+    expect_sprintf_size(9.9999996f);
+    expect_json_size(9.9999996f);
+
+    for (std::int64_t value : { std::int64_t(0), std::int64_t(-1), std::int64_t(10),
+            std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max() }) {
+        expect_sprintf_size(value);
+        expect_json_size(value);
+    }
+    expect_sprintf_size(std::numeric_limits<std::uint64_t>::max());
+    expect_json_size(std::numeric_limits<std::uint64_t>::max());
+    expect_sprintf_size(true);
+    expect_json_size(false);
+    expect_sprintf_size('c');
+    expect_json_size('c');
+}
+
+/// Sizes of strings, including the ones JSON escapes.
+TEST(KingwSerde, SizeSerializerStrings) {
+    const std::vector<std::string> strings{
+        "", "plain", "quote \" and backslash \\", "\n\r\t\b\f", std::string("\0\x01\x1f", 3),
+        "\x7f", "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", "/slash/" };
+    for (const std::string & value : strings) {
+        expect_json_size(value);
+        if (value.find('\0') == std::string::npos) {
+            expect_sprintf_size(value);
+        }
+    }
+    expect_json_size(strings);
+}
+
+/// Sizes of containers, including empty ones.
+TEST(KingwSerde, SizeSerializerContainers) {
+    const Reading full{ "probe", EDGE_DOUBLES, { { "a", 1 }, { "b\n", -20 } }, { 0, 255, 7 }, true };
+    const Reading empty{ "x", {}, {}, {}, false };
+
+    expect_sprintf_size(full);
+    expect_sprintf_size(empty);
+    expect_sprintf_size(std::vector<std::int32_t>{});
+    expect_sprintf_size(std::vector<Reading>{ full, empty });
+
+    expect_json_size(full);
+    expect_json_size(empty);
+    expect_json_size(std::vector<std::int32_t>{});
+    expect_json_size(std::map<std::string, double>{});
+    expect_json_size(std::vector<Reading>{ full, empty });
+    expect_json_size(std::vector<std::vector<std::int32_t>>{ {}, { 1 }, {} });
+}
+
+/// Sizes of sequences whose length is not known up front.
+TEST(KingwSerde, SizeSerializerUnknownLength) {
+    for (int count : { 0, 1, 3, 12 }) {
+        expect_sprintf_size(Generated{ count });
+        expect_json_size(Generated{ count });
+    }
+}
+
+}  // namespace
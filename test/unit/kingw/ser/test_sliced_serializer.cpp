@@ -0,0 +1,116 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/fixtures.hpp"
+#include "kingw/ser/templates/stdmap.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/ser/sliced_serializer.hpp"
+#include "kingw/serde/tape.hpp"
+
+using namespace kingw;
+using namespace kingw::fixtures;
+using namespace testing;
+
+
+namespace {
+
+std::vector<Reading> make_readings(std::size_t count) {
+    std::vector<Reading> readings(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        readings[i].name = "sensor-" + std::to_string(i);
+        readings[i].samples = { 0.5 * i, 1.5 * i };
+        readings[i].counts = { { "low", std::int32_t(i) }, { "high", std::int32_t(2 * i) } };
+    }
+    return readings;
+}
+
+/// Each step() stops once the byte budget is used up, and the next one
+/// continues where it stopped. The output is the same as without slices.
+TEST(KingwSerde, SlicedSerializerSteps) {
+    const std::vector<Reading> readings = make_readings(20);
+
+    serde::Tape expected;
+    ser::TapeSerializer expected_recorder(expected);
+    ser::serialize(expected_recorder, readings);
+
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape);
+    ser::SliceBudget budget;
+    budget.bytes = 16;
+    ser::SlicedSerializer sliced(recorder, [&readings](ser::Serializer & serializer) {
+        ser::serialize(serializer, readings);
+    }, budget);
+    EXPECT_FALSE(sliced.done());
+    EXPECT_EQ(tape.size(), 0u);
+
+    std::size_t steps = 0;
+    std::size_t previous_size = 0;
+    while (!sliced.step()) {
+        ++steps;
+        EXPECT_GT(tape.size(), previous_size);
+        previous_size = tape.size();
+    }
+    EXPECT_GT(steps, 20u);
+    EXPECT_TRUE(sliced.done());
+    EXPECT_TRUE(sliced.step());
+
+    ASSERT_EQ(tape.size(), expected.size());
+    EXPECT_EQ(std::memcmp(tape.data(), expected.data(), tape.size()), 0);
+}
+
+/// Without a limit, the first step() writes everything.
+TEST(KingwSerde, SlicedSerializerUnlimited) {
+    const std::vector<Reading> readings = make_readings(5);
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape);
+    ser::SlicedSerializer sliced(recorder, [&readings](ser::Serializer & serializer) {
+        ser::serialize(serializer, readings);
+    }, ser::SliceBudget());
+    EXPECT_TRUE(sliced.step());
+    EXPECT_GT(tape.size(), 0u);
+}
+
+/// Errors from the serialization are thrown from step().
+TEST(KingwSerde, SlicedSerializerThrows) {
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape);
+    ser::SliceBudget budget;
+    budget.bytes = 1;
+    ser::SlicedSerializer sliced(recorder, [](ser::Serializer & serializer) {
+        serializer.serialize_i32(1);
+        KINGW_SERDE_THROW(ser::SerializationException("bad value"));
+    }, budget);
+    EXPECT_FALSE(sliced.step());
+    EXPECT_THROW(sliced.step(), ser::SerializationException);
+    EXPECT_TRUE(sliced.done());
+}
+
+/// A serialization that is not done is unwound when the
+/// SlicedSerializer is destroyed, closing the open containers.
+TEST(KingwSerde, SlicedSerializerAbandoned) {
+    const std::vector<Reading> readings = make_readings(20);
+    serde::Tape tape;
+    bool unwound = false;
+    {
+        ser::TapeSerializer recorder(tape);
+        ser::SliceBudget budget;
+        budget.bytes = 16;
+        ser::SlicedSerializer sliced(recorder, [&readings, &unwound](ser::Serializer & serializer) {
+            struct Unwind {
+                bool & unwound;
+                ~Unwind() { unwound = true; }
+            };
+            Unwind unwind{ unwound };
+            ser::serialize(serializer, readings);
+        }, budget);
+        EXPECT_FALSE(sliced.step());
+        EXPECT_FALSE(sliced.step());
+        EXPECT_FALSE(unwound);
+    }
+    EXPECT_TRUE(unwound);
+}
+
+}  // namespace
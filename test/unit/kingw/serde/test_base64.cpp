@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "kingw/serde/base64.hpp"
+
+using namespace kingw::serde;
+
+
+namespace {
+
+std::string encode(const std::vector<std::uint8_t> & bytes) {
+    std::string output(base64_encoded_size(bytes.size()), '\0');
+    char* end = base64_encode(bytes.data(), bytes.size(), &output[0]);
+    EXPECT_EQ(end, &output[0] + output.size());
+    return output;
+}
+
+bool decode(const std::string & input, std::vector<std::uint8_t> & output) {
+    output.assign(base64_decoded_size(input.size()), 0);
+    std::size_t len = 0;
+    if (!base64_decode(input.data(), input.size(), output.data(), len)) {
+        return false;
+    }
+    output.resize(len);
+    return true;
+}
+
+std::vector<std::uint8_t> bytes_of(const std::string & value) {
+    return std::vector<std::uint8_t>(value.begin(), value.end());
+}
+
+/// Straightforward encoder to compare the vectorized ones against.
+std::string reference_encode(const std::vector<std::uint8_t> & bytes) {
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string output;
+    std::uint32_t bits = 0;
+    int count = 0;
+    for (std::uint8_t byte : bytes) {
+        bits = (bits << 8) | byte;
+        count += 8;
+        while (count >= 6) {
+            count -= 6;
+            output.push_back(alphabet[(bits >> count) & 0x3F]);
+        }
+    }
+    if (count > 0) {
+        output.push_back(alphabet[(bits << (6 - count)) & 0x3F]);
+    }
+    while (output.size() % 4 != 0) {
+        output.push_back('=');
+    }
+    return output;
+}
+
+/// Test vectors from RFC 4648 section 10.
+TEST(KingwSerde, Base64Rfc4648) {
+    EXPECT_EQ(encode(bytes_of("")), "");
+    EXPECT_EQ(encode(bytes_of("f")), "Zg==");
+    EXPECT_EQ(encode(bytes_of("fo")), "Zm8=");
+    EXPECT_EQ(encode(bytes_of("foo")), "Zm9v");
+    EXPECT_EQ(encode(bytes_of("foob")), "Zm9vYg==");
+    EXPECT_EQ(encode(bytes_of("fooba")), "Zm9vYmE=");
+    EXPECT_EQ(encode(bytes_of("foobar")), "Zm9vYmFy");
+
+    std::vector<std::uint8_t> output;
+    ASSERT_TRUE(decode("Zm9vYmE=", output));
+    EXPECT_EQ(output, bytes_of("fooba"));
+    ASSERT_TRUE(decode("Zm9vYmE", output));  // Padding is optional
+    EXPECT_EQ(output, bytes_of("fooba"));
+    ASSERT_TRUE(decode("", output));
+    EXPECT_TRUE(output.empty());
+}
+
+/// Every length from 0 up to several vector blocks must match the
+/// reference encoding and decode back to the input.
+TEST(KingwSerde, Base64RoundTrip) {
+    std::mt19937 random(12345);
+    for (std::size_t len = 0; len < 300; ++len) {
+        std::vector<std::uint8_t> input(len);
+        for (auto & byte : input) {
+            byte = static_cast<std::uint8_t>(random());
+        }
+        const std::string encoded = encode(input);
+        ASSERT_EQ(encoded, reference_encode(input)) << "length " << len;
+
+        std::vector<std::uint8_t> decoded;
+        ASSERT_TRUE(decode(encoded, decoded)) << "length " << len;
+        ASSERT_EQ(decoded, input) << "length " << len;
+    }
+}
+
+/// Every character outside the alphabet is rejected, wherever it is.
+TEST(KingwSerde, Base64Invalid) {
+    std::vector<std::uint8_t> input(96);
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    const std::string encoded = encode(input);
+    const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::vector<std::uint8_t> output;
+    for (int c = 0; c < 256; ++c) {
+        if (alphabet.find(static_cast<char>(c)) != std::string::npos) {
+            continue;
+        }
+        for (std::size_t position : { std::size_t(0), std::size_t(13), std::size_t(40), std::size_t(126) }) {
+            std::string corrupt = encoded;
+            corrupt[position] = static_cast<char>(c);
+            EXPECT_FALSE(decode(corrupt, output)) << "character " << c << " at " << position;
+        }
+    }
+
+    EXPECT_FALSE(decode("Zm9vY", output));  // Not a whole byte
+    EXPECT_FALSE(decode("Zg=a", output));   // Padding in the middle
+    EXPECT_FALSE(decode("Z===", output));   // Too much padding
+    EXPECT_FALSE(decode("Zh==", output));   // Leftover bits
+}
+
+}  // namespace
@@ -2,6 +2,7 @@
 
 #include "kingw/mock/ser/mock_serializer.hpp"
 #include "kingw/mock/de/mock_deserializer.hpp"
+#include "kingw/de/integral_visitors.hpp"
 #include "kingw/serde/derive.hpp"
 
 using namespace kingw;
@@ -187,10 +188,16 @@ TEST(KingwSerde, DeriveStructVisitorEmpty) {
     serde::StructDefinition<ExampleStruct>::EmptyStructVisitor visitor;
     EXPECT_EQ(serde::string_view("empty struct"), visitor.expecting());
 
-    // If Deserializer map contains items, then throw.
+    // If Deserializer map contains items, then skip them.
     de::MockMapAccess map_access;
-    EXPECT_CALL(map_access, has_next()).Times(1).WillOnce(Return(true));
-    EXPECT_THROW(visitor.visit_map(map_access), de::DeserializationException);
+    EXPECT_CALL(map_access, has_next()).Times(2)
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(map_access, next_entry(
+            WhenDynamicCastTo<const de::Accessor<de::IgnoredAny> &>(_),
+            WhenDynamicCastTo<const de::Accessor<de::IgnoredAny> &>(_)))
+        .Times(1);
+    EXPECT_NO_THROW(visitor.visit_map(map_access));
     EXPECT_CALL(map_access, has_next()).Times(1).WillOnce(Return(false));
     EXPECT_NO_THROW(visitor.visit_map(map_access));
 
@@ -310,6 +317,29 @@ TEST(KingwSerde, DeriveStructVisitorSeqTooShort) {
     EXPECT_THROW(visitor.visit_seq(seq_access), de::DeserializationException);
 }
 
+/// StructVisitor::visit_seq() reports the length mismatch to the deserializer
+/// instead of throwing, if the deserializer does not throw on errors.
+TEST(KingwSerde, DeriveStructVisitorSeqTooShortRecorded) {
+    // Define ExampleStruct and related FieldDefinitions
+    auto defn = serde::StructDefinition<ExampleStruct>("ExampleStruct")
+        ("a", &ExampleStruct::a)
+        ("b", &ExampleStruct::b);
+
+    ExampleStruct example{ 0, 0.0 };
+    serde::StructDefinition<ExampleStruct, double, int>::StructVisitor visitor(example, defn);
+
+    de::MockDeserializer deserializer;
+    deserializer.set_throw_on_error(false);
+    de::MockSeqAccess seq_access;
+    seq_access.report_to(deserializer);
+    EXPECT_CALL(seq_access, has_next())
+        .WillOnce(Return(true))
+        .WillRepeatedly(Return(false));  // Error - struct has 2 members, not 1
+    EXPECT_CALL(seq_access, next_element(_)).Times(1);  // Don't bother assigning value for this test
+    EXPECT_NO_THROW(visitor.visit_seq(seq_access));
+    EXPECT_EQ(deserializer.error().code, de::ErrorCode::InvalidLength);
+}
+
 /// StructVisitor::visit_map() deserializes all members of a struct
 /// from a set of key-value pairs of data using de::Deserializer.
 TEST(KingwSerde, DeriveStructVisitorDeserializeMap) {
@@ -382,8 +412,8 @@ TEST(KingwSerde, DeriveStructVisitorDeserializeMap) {
     EXPECT_EQ(example.b, 10.0);
 }
 
-/// StructVisitor::visit_map() must throw an exception if a struct key is not
-/// found in the Deserializer.
+/// StructVisitor::visit_map() must skip the value of a key that is not
+/// a member of the struct.
 TEST(KingwSerde, DeriveStructVisitorMapKeyNotFound) {
     // Define ExampleStruct and related FieldDefinitions
     auto defn = serde::StructDefinition<ExampleStruct>("ExampleStruct")
@@ -396,15 +426,25 @@ TEST(KingwSerde, DeriveStructVisitorMapKeyNotFound) {
     Sequence order;  // The following EXPECT_CALL()s must occur in order
     de::MockDeserializer deserializer;
     de::MockMapAccess map_access;
-    EXPECT_CALL(map_access, has_next()).Times(1).WillOnce(Return(true));
+    EXPECT_CALL(map_access, has_next()).Times(2)
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
     EXPECT_CALL(map_access, next_key(_)).Times(1).WillOnce([&](de::Deserialize & key) {
         // Must call deserializer.deserialize_string()
         key.deserialize(deserializer);
     });
     EXPECT_CALL(deserializer, deserialize_string(_)).Times(1).WillOnce([&](de::Visitor & visitor) {
-        visitor.visit_string("c");  // Error - not a struct member name
+        visitor.visit_string("c");  // Not a struct member name
     });
-    EXPECT_THROW(visitor.visit_map(map_access), de::DeserializationException);
+    EXPECT_CALL(map_access, next_value(_)).Times(1).WillOnce([&](de::Deserialize & value) {
+        // Must call deserializer.deserialize_ignored_any()
+        value.deserialize(deserializer);
+    });
+    EXPECT_CALL(deserializer, deserialize_ignored_any(WhenDynamicCastTo<const de::IgnoredAnyVisitor &>(_)))
+        .Times(1);
+    EXPECT_NO_THROW(visitor.visit_map(map_access));
+    EXPECT_EQ(example.a, 0);
+    EXPECT_EQ(example.b, 0.0);
 }
 
 /// Test misc functionality of FieldNameAccessor that aren't tested in
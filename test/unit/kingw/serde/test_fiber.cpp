@@ -0,0 +1,52 @@
+#include <gmock/gmock.h>
+
+#include "kingw/serde/fiber.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// Recurses `depth` times, with a frame of at least 256 bytes each.
+int recurse(int depth) {
+    volatile char frame[256] = {};
+    frame[0] = static_cast<char>(depth);
+    return depth == 0 ? 0 : recurse(depth - 1) + frame[0];
+}
+
+/// The body runs on the fiber until it suspends, and continues
+/// from there on the next resume().
+TEST(KingwSerde, FiberSuspendResume) {
+    int steps = 0;
+    serde::Fiber* self = nullptr;
+    serde::Fiber fiber([&] {
+        ++steps;
+        self->suspend();
+        ++steps;
+    });
+    self = &fiber;
+    EXPECT_FALSE(fiber.running());
+
+    fiber.resume();
+    EXPECT_EQ(steps, 1);
+    EXPECT_TRUE(fiber.running());
+    fiber.resume();
+    EXPECT_EQ(steps, 2);
+    EXPECT_TRUE(fiber.done());
+}
+
+/// Overflowing the fiber's stack hits its guard page and crashes,
+/// instead of writing over other memory.
+TEST(KingwSerde, FiberStackOverflowFaults) {
+#if defined(_WIN32)
+    GTEST_SKIP() << "Windows fibers have their own guard page";
+#else
+    EXPECT_DEATH({
+        serde::Fiber fiber([] { recurse(1 << 20); }, 16 * 1024);
+        fiber.resume();
+    }, "");
+#endif
+}
+
+}  // namespace
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/serde/hash.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// Digests pinned for the bytes `i * 31 + 7`, so that every kernel,
+/// and every platform, has to agree on them.
+struct Golden {
+    std::size_t len;
+    std::uint64_t digest;       ///< Seed 0
+    std::uint64_t seeded;       ///< Seed 42
+    std::uint64_t high;         ///< High half of digest128(), seed 0
+};
+
+/// Empty, shorter than a lane pair, around the SSE2 and AVX2 register
+/// widths, around one stripe, and past a scramble.
+const Golden GOLDEN[] = {
+    { 0, 0xA33E02C1984293ABULL, 0xF431CB2EC3A61C72ULL, 0x87C2DD3472B429EAULL },
+    { 5, 0xDD14F0B83BEDF07EULL, 0x4BB22DF3A13663F5ULL, 0x3DC1C40C7ABDD7E6ULL },
+    { 16, 0x7AEF7CFEAFF8C76EULL, 0x5C94E4FA0B423D9FULL, 0xEBCFD78F01170B70ULL },
+    { 31, 0x344B17004FF1FDFBULL, 0xF412724640FABB47ULL, 0xBA388CF30DCF24FAULL },
+    { 32, 0xC92C4075BAA31FB4ULL, 0x49D0A3FBE97576B7ULL, 0x8FE94E2E41E32067ULL },
+    { 33, 0x4568A0C1988744DDULL, 0x8359C84E365E03B6ULL, 0x9BBE386711772DAFULL },
+    { 64, 0xB426B464243DF766ULL, 0xDCE2A1BEE74F8799ULL, 0x50FC35A1ECF289A9ULL },
+    { 65, 0xED39BBA45AD49F96ULL, 0x33E0421B55AAF05DULL, 0x8425ABC68CA9E7B5ULL },
+    { 1000, 0x77A071E0D4C073ADULL, 0xA66127B498D7A61BULL, 0x87D00C7E14D42E7BULL },
+};
+
+/// Every kernel this CPU runs gives the pinned digests, whether the
+/// bytes come all at once or a few at a time.
+TEST(KingwSerde, HasherGolden) {
+    std::vector<std::uint8_t> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>(i * 31 + 7);
+    }
+
+    const serde::HashKernel kernels[] = {
+        serde::HashKernel::Scalar, serde::HashKernel::SSE2, serde::HashKernel::AVX2,
+    };
+    EXPECT_TRUE(serde::Hasher::supported(serde::HashKernel::Scalar));
+    for (serde::HashKernel kernel : kernels) {
+        if (!serde::Hasher::supported(kernel)) {
+            continue;
+        }
+        SCOPED_TRACE(static_cast<int>(kernel));
+        for (const Golden & golden : GOLDEN) {
+            SCOPED_TRACE(golden.len);
+            serde::Hasher whole(0, kernel);
+            whole.update(data.data(), golden.len);
+            EXPECT_EQ(golden.digest, whole.digest());
+            EXPECT_EQ(golden.digest, whole.digest128().low);
+            EXPECT_EQ(golden.high, whole.digest128().high);
+
+            serde::Hasher seeded(42, kernel);
+            seeded.update(data.data(), golden.len);
+            EXPECT_EQ(golden.seeded, seeded.digest());
+
+            serde::Hasher chunks(0, kernel);
+            for (std::size_t i = 0; i < golden.len; i += 13) {
+                chunks.update(data.data() + i, std::min<std::size_t>(13, golden.len - i));
+            }
+            EXPECT_EQ(golden.digest, chunks.digest());
+        }
+    }
+
+    // The default constructor picks one of the same kernels.
+    serde::Hasher fastest;
+    fastest.update(data.data(), data.size());
+    EXPECT_EQ(GOLDEN[8].digest, fastest.digest());
+}
+
+/// The hash only depends on the bytes, not on how they were split
+/// between calls to update().
+TEST(KingwSerde, HasherChunks) {
+    std::vector<std::uint8_t> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    serde::Hasher whole;
+    whole.update(data.data(), data.size());
+    serde::Hasher bytes;
+    for (std::uint8_t byte : data) {
+        bytes.update(&byte, 1);
+    }
+    serde::Hasher chunks;
+    for (std::size_t i = 0; i < data.size(); i += 37) {
+        chunks.update(data.data() + i, std::min<std::size_t>(37, data.size() - i));
+    }
+
+    EXPECT_EQ(whole.digest(), bytes.digest());
+    EXPECT_EQ(whole.digest(), chunks.digest());
+    EXPECT_EQ(whole.digest128(), bytes.digest128());
+    EXPECT_EQ(whole.digest128(), chunks.digest128());
+
+    serde::Hasher seeded(1);
+    seeded.update(data.data(), data.size());
+    EXPECT_NE(whole.digest(), seeded.digest());
+
+    // Trailing zeros are not the same as padding.
+    serde::Hasher shorter;
+    shorter.update(data.data(), 999);
+    serde::Hasher zeros;
+    zeros.update(data.data(), 999);
+    zeros.update("\0", 1);
+    EXPECT_NE(shorter.digest(), zeros.digest());
+}
+
+/// A contiguous sequence of basic types hashes the same as one serialized
+/// element by element, with or without its length.
+TEST(KingwSerde, HashSequences) {
+    std::vector<std::int32_t> vector;
+    for (std::int32_t i = 0; i < 200; ++i) {
+        vector.push_back(i * 1000);
+    }
+    const std::list<std::int32_t> list(vector.begin(), vector.end());
+
+    serde::Hasher hasher;
+    ser::HashSerializer serializer(hasher);
+    ser::serialize_range(serializer, list.begin(), list.end());
+    EXPECT_EQ(serde::hash(vector), hasher.digest());
+    EXPECT_EQ(serde::hash128(vector), hasher.digest128());
+}
+
+/// Types, lengths, and field names all change the hash.
+TEST(KingwSerde, HashFraming) {
+    const std::vector<std::string> ab_c = { "ab", "c" };
+    const std::vector<std::string> a_bc = { "a", "bc" };
+    EXPECT_NE(serde::hash(ab_c), serde::hash(a_bc));
+    EXPECT_EQ(serde::hash(ab_c), serde::hash(std::vector<std::string>{ "ab", "c" }));
+    EXPECT_NE(serde::hash(std::int32_t(1)), serde::hash(std::int64_t(1)));
+    EXPECT_NE(serde::hash(std::int32_t(1), 0), serde::hash(std::int32_t(1), 1));
+
+    auto hash_struct = [](serde::string_view field) {
+        serde::Hasher hasher;
+        ser::HashSerializer serializer(hasher);
+        auto state = serializer.serialize_struct("Example", 1);
+        state.serialize_field(field, ser::accessor(true));
+        state.end();
+        return hasher.digest();
+    };
+    EXPECT_NE(hash_struct("foo"), hash_struct("bar"));
+}
+
+}  // namespace
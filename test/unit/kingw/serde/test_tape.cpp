@@ -0,0 +1,115 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/mock/ser/mock_serializer.hpp"
+#include "kingw/de/templates/stdmap.hpp"
+#include "kingw/de/templates/stdvector.hpp"
+#include "kingw/ser/templates/stdmap.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/de/try_deserialize.hpp"
+#include "kingw/serde/tape.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// Replaying a tape makes the same calls that were recorded, with the
+/// lengths that were actually serialized.
+TEST(KingwSerde, TapeReplay) {
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape);
+    const std::vector<std::string> names = { "a", "b" };
+    const std::vector<std::int32_t> values = { 1, 2, 3 };
+    ser::serialize(recorder, names);
+    ser::serialize(recorder, values);
+    {
+        auto state = recorder.serialize_struct("Example", 2);
+        state.serialize_field("foo", ser::accessor(true));
+        state.skip_field("bar");
+        state.end();
+    }
+    {
+        auto seq = recorder.serialize_seq();
+        seq.serialize_element(ser::accessor(std::uint8_t(7)));
+        seq.end();
+    }
+
+    ser::MockSerializer serializer;
+    {
+        InSequence sequence;
+        EXPECT_CALL(serializer, seq_begin(2));
+        EXPECT_CALL(serializer, seq_serialize_element(_))
+            .Times(2)
+            .WillRepeatedly([&](const ser::Serialize & element) {
+                EXPECT_TRUE(element.traits().is_string);
+                element.serialize(serializer);
+            });
+        EXPECT_CALL(serializer, seq_end());
+        EXPECT_CALL(serializer, serialize_i32_seq(_, 3))
+            .WillOnce([&](const std::int32_t* data, std::size_t len) {
+                EXPECT_EQ(std::vector<std::int32_t>(data, data + len), values);
+            });
+        EXPECT_CALL(serializer, struct_begin(serde::string_view("Example"), 2));
+        EXPECT_CALL(serializer, struct_serialize_field(serde::string_view("foo"), _))
+            .WillOnce([&](serde::string_view, const ser::Serialize & field) {
+                field.serialize(serializer);
+            });
+        EXPECT_CALL(serializer, struct_skip_field(serde::string_view("bar")));
+        EXPECT_CALL(serializer, struct_end());
+        EXPECT_CALL(serializer, seq_begin(1));
+        EXPECT_CALL(serializer, seq_serialize_element(_))
+            .WillOnce([&](const ser::Serialize & element) { element.serialize(serializer); });
+        EXPECT_CALL(serializer, seq_end());
+    }
+    EXPECT_CALL(serializer, serialize_string(serde::string_view("a")));
+    EXPECT_CALL(serializer, serialize_string(serde::string_view("b")));
+    EXPECT_CALL(serializer, serialize_bool(true));
+    EXPECT_CALL(serializer, serialize_u8(7));
+
+    ser::serialize(serializer, tape);
+}
+
+/// A TapeDeserializer reads back what was recorded.
+TEST(KingwSerde, TapeDeserialize) {
+    const std::map<std::string, std::vector<std::int32_t>> input = {
+        { "empty", {} },
+        { "values", { 1, -2, 3 } },
+    };
+    serde::Tape tape;
+    ser::TapeSerializer recorder(tape, false);
+    ser::serialize(recorder, input);
+
+    std::map<std::string, std::vector<std::int32_t>> output;
+    de::TapeDeserializer deserializer(tape);
+    EXPECT_FALSE(deserializer.is_human_readable());
+    de::deserialize(deserializer, output);
+    EXPECT_EQ(output, input);
+
+    // The values are converted like any other format.
+    std::map<std::string, std::vector<std::int64_t>> wider;
+    de::TapeDeserializer wider_deserializer(tape);
+    de::deserialize(wider_deserializer, wider);
+    EXPECT_EQ(wider.at("values"), std::vector<std::int64_t>({ 1, -2, 3 }));
+
+    std::map<std::string, std::vector<std::uint8_t>> narrower;
+    de::TapeDeserializer narrower_deserializer(tape);
+    de::Error error = de::try_deserialize(narrower_deserializer, narrower);
+    EXPECT_EQ(error.code, de::ErrorCode::InvalidValue);
+    EXPECT_EQ(error.path, "values[1]");
+}
+
+/// An empty tape has no value to deserialize.
+TEST(KingwSerde, TapeDeserializeEmpty) {
+    serde::Tape tape;
+    de::TapeDeserializer deserializer(tape);
+    std::int32_t output = 0;
+    de::Error error = de::try_deserialize(deserializer, output);
+    EXPECT_EQ(error.code, de::ErrorCode::EndOfInput);
+}
+
+}  // namespace
@@ -0,0 +1,75 @@
+#include <gmock/gmock.h>
+
+#include "kingw/mock/de/mock_deserializer.hpp"
+#include "kingw/mock/ser/mock_serializer.hpp"
+#include "kingw/serde/transcode.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// serde::transcode() forwards each value to the serializer as the
+/// serializer asks for it.
+TEST(KingwSerde, Transcode) {
+    // Define a deserializer that has a map with 1 entry:
+    //  "key": [7, "x"]
+    de::MockDeserializer deserializer;
+    de::MockMapAccess map_access;
+    de::MockSeqAccess seq_access;
+    int map_remaining = 1;
+    int seq_remaining = 2;
+    EXPECT_CALL(map_access, has_next())
+        .WillRepeatedly([&]() { return map_remaining > 0; });
+    EXPECT_CALL(map_access, next_key(_))
+        .WillOnce([&](de::Deserialize & key) { key.deserialize(deserializer); });
+    EXPECT_CALL(map_access, next_value(_))
+        .WillOnce([&](de::Deserialize & value) {
+            --map_remaining;
+            value.deserialize(deserializer);
+        });
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return seq_remaining > 0; });
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            --seq_remaining;
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_any(_))
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_map(map_access); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("key"); })
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_seq(seq_access); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_i32(7); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("x"); });
+
+    // Expect the same structure from the serializer. Size hints aren't
+    // exact lengths, so every length is unknown.
+    ser::MockSerializer serializer;
+    {
+        InSequence sequence;
+        EXPECT_CALL(serializer, map_begin(ser::Serializer::UNKNOWN_LENGTH));
+        EXPECT_CALL(serializer, map_serialize_key(_))
+            .WillOnce([&](const ser::Serialize & key) {
+                EXPECT_TRUE(key.traits().is_string);
+                key.serialize(serializer);
+            });
+        EXPECT_CALL(serializer, serialize_string(serde::string_view("key")));
+        EXPECT_CALL(serializer, map_serialize_value(_))
+            .WillOnce([&](const ser::Serialize & value) { value.serialize(serializer); });
+        EXPECT_CALL(serializer, seq_begin(ser::Serializer::UNKNOWN_LENGTH));
+        EXPECT_CALL(serializer, seq_serialize_element(_))
+            .WillOnce([&](const ser::Serialize & element) { element.serialize(serializer); });
+        EXPECT_CALL(serializer, serialize_i32(7));
+        EXPECT_CALL(serializer, seq_serialize_element(_))
+            .WillOnce([&](const ser::Serialize & element) { element.serialize(serializer); });
+        EXPECT_CALL(serializer, serialize_string(serde::string_view("x")));
+        EXPECT_CALL(serializer, seq_end());
+        EXPECT_CALL(serializer, map_end());
+    }
+
+    serde::transcode(deserializer, serializer);
+}
+
+}  // namespace
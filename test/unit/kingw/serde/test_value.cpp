@@ -0,0 +1,163 @@
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include <gmock/gmock.h>
+
+#include "kingw/mock/de/mock_deserializer.hpp"
+#include "kingw/mock/ser/mock_serializer.hpp"
+#include "kingw/serde/value.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+namespace {
+
+/// Values of basic types are stored in the value itself.
+///
+TEST(KingwSerde, ValueBasicTypes) {
+    EXPECT_EQ(sizeof(serde::Value), 16);
+    EXPECT_TRUE(serde::Value().is_null());
+    EXPECT_TRUE(serde::Value::from_bool(true).as_bool());
+    EXPECT_EQ(serde::Value::from_i64(-5).as_i64(), -5);
+    EXPECT_EQ(serde::Value::from_u64(5).as_i64(), 5);
+    EXPECT_EQ(serde::Value::from_u64(UINT64_MAX).as_u64(), UINT64_MAX);
+    EXPECT_EQ(serde::Value::from_f64(1.5).as_f64(), 1.5);
+    EXPECT_EQ(serde::Value::from_f64(1.5).type(), serde::Value::Type::F64);
+    EXPECT_EQ(serde::Value::from_i64(-5), serde::Value::from_i64(-5));
+    EXPECT_NE(serde::Value::from_i64(5), serde::Value::from_u64(5));
+}
+
+/// as_i64() and as_u64() convert between number types, and throw
+/// instead of wrapping around when the number doesn't fit.
+TEST(KingwSerde, ValueIntegerConversions) {
+    EXPECT_EQ(serde::Value::from_i64(INT64_MIN).as_i64(), INT64_MIN);
+    EXPECT_EQ(serde::Value::from_u64(INT64_MAX).as_i64(), INT64_MAX);
+    EXPECT_EQ(serde::Value::from_i64(5).as_u64(), 5u);
+    EXPECT_EQ(serde::Value::from_f64(-2.75).as_i64(), -2);
+    EXPECT_EQ(serde::Value::from_f64(-0.5).as_u64(), 0u);
+    EXPECT_EQ(serde::Value::from_f64(9223372036854774784.0).as_i64(), INT64_C(9223372036854774784));
+    EXPECT_EQ(serde::Value::from_f64(18446744073709549568.0).as_u64(), UINT64_C(18446744073709549568));
+    EXPECT_EQ(serde::Value::from_bool(true).as_i64(), 0);
+
+    EXPECT_THROW(serde::Value::from_u64(UINT64_C(1) << 63).as_i64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_i64(-1).as_u64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_f64(9223372036854775808.0).as_i64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_f64(-9223372036854777856.0).as_i64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_f64(18446744073709551616.0).as_u64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_f64(-1.0).as_u64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_f64(std::numeric_limits<double>::quiet_NaN()).as_i64(), std::out_of_range);
+    EXPECT_THROW(serde::Value::from_f64(std::numeric_limits<double>::infinity()).as_u64(), std::out_of_range);
+}
+
+/// Short strings are stored in the value, and longer ones in the arena.
+///
+TEST(KingwSerde, DocumentStrings) {
+    serde::Document document;
+    serde::Value small = document.string("fourteen chars");
+    EXPECT_EQ(document.memory_used(), 0);
+    serde::Value large = document.string("more than fourteen chars");
+    EXPECT_GT(document.memory_used(), 0);
+
+    EXPECT_EQ(small.type(), serde::Value::Type::String);
+    EXPECT_EQ(small.as_string(), "fourteen chars");
+    EXPECT_EQ(large.as_string(), "more than fourteen chars");
+    EXPECT_EQ(large.size(), 24);
+}
+
+/// Document::clear() reuses the arena for the next document.
+///
+TEST(KingwSerde, DocumentClear) {
+    serde::Document document;
+    const char* first = document.string("more than fourteen chars").as_string().data();
+    document.clear();
+    EXPECT_EQ(document.memory_used(), 0);
+    const char* second = document.string("something else entirely").as_string().data();
+    EXPECT_EQ(first, second);
+}
+
+/// de::deserialize<serde::Document>() builds a tree from deserialize_any(),
+/// keeping the elements of an array contiguous.
+TEST(KingwSerde, DocumentDeserialize) {
+    // Define a deserializer that has an object with 2 members:
+    //  "id": -7
+    //  "tags": ["a", null, "a string that is long"]
+    de::MockDeserializer deserializer;
+    de::MockMapAccess map_access;
+    de::MockSeqAccess seq_access;
+    int map_remaining = 2;
+    int seq_remaining = 3;
+    EXPECT_CALL(map_access, has_next())
+        .WillRepeatedly([&]() { return map_remaining > 0; });
+    EXPECT_CALL(map_access, next_entry(_, _))
+        .Times(2)
+        .WillRepeatedly([&](de::Deserialize & key, de::Deserialize & value) {
+            --map_remaining;
+            key.deserialize(deserializer);
+            value.deserialize(deserializer);
+        });
+    EXPECT_CALL(seq_access, has_next())
+        .WillRepeatedly([&]() { return seq_remaining > 0; });
+    EXPECT_CALL(seq_access, next_element(_))
+        .Times(3)
+        .WillRepeatedly([&](de::Deserialize & element) {
+            --seq_remaining;
+            element.deserialize(deserializer);
+        });
+    EXPECT_CALL(deserializer, deserialize_any(_))
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_map(map_access); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("id"); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_i32(-7); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("tags"); })
+        .WillOnce([&](de::Visitor & visitor) { visitor.visit_seq(seq_access); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_borrowed_string("a"); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_unit(); })
+        .WillOnce([](de::Visitor & visitor) { visitor.visit_string("a string that is long"); });
+
+    serde::Document document;
+    de::deserialize(deserializer, document);
+
+    const serde::Value & root = document.root();
+    ASSERT_EQ(root.type(), serde::Value::Type::Object);
+    ASSERT_EQ(root.size(), 2);
+    ASSERT_NE(root.find("id"), nullptr);
+    EXPECT_EQ(*root.find("id"), serde::Value::from_i64(-7));
+    EXPECT_EQ(root.find("missing"), nullptr);
+
+    const serde::Value* tags = root.find("tags");
+    ASSERT_NE(tags, nullptr);
+    ASSERT_EQ(tags->size(), 3);
+    EXPECT_EQ((*tags)[0].as_string(), "a");
+    EXPECT_TRUE((*tags)[1].is_null());
+    EXPECT_EQ((*tags)[2].as_string(), "a string that is long");
+    EXPECT_EQ(&(*tags)[2], tags->begin() + 2);
+}
+
+/// ser::serialize<serde::Value>() writes an object as a map with string keys,
+/// and null as a unit.
+TEST(KingwSerde, ValueSerialize) {
+    serde::Document document;
+    serde::Member members[] = {
+        { document.string("key"), serde::Value() },
+    };
+    document.set_root(document.object(members, 1));
+
+    ser::MockSerializer serializer;
+    EXPECT_CALL(serializer, map_begin(1)).Times(1);
+    EXPECT_CALL(serializer, map_serialize_entry(_, _))
+        .WillOnce([&](const ser::Serialize & key, const ser::Serialize & value) {
+            EXPECT_TRUE(key.traits().is_string);
+            EXPECT_CALL(serializer, serialize_string(serde::string_view("key"))).Times(1);
+            key.serialize(serializer);
+            // The default serialize_unit() writes an empty string.
+            EXPECT_CALL(serializer, serialize_string(serde::string_view(""))).Times(1);
+            value.serialize(serializer);
+        });
+    EXPECT_CALL(serializer, map_end()).Times(1);
+
+    ser::serialize(serializer, document);
+}
+
+}  // namespace
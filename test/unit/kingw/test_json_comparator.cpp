@@ -0,0 +1,96 @@
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/fixtures.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/json_comparator.hpp"
+#include "kingw/serde_json.hpp"
+
+using namespace kingw;
+using namespace kingw::fixtures;
+using namespace testing;
+
+
+namespace {
+
+const Reading READING{ "probe", { 1, -2, 3 }, { { "max", 2 }, { "min", -1 } }, { 7 }, true };
+
+/// A value equals the json it was serialized into, parsed or not.
+TEST(KingwSerde, JsonComparatorEqual) {
+    const std::string expected = serde_json::to_string(READING);
+    EXPECT_TRUE(serde_json::equals(READING, expected));
+    EXPECT_TRUE(serde_json::equals(READING, nlohmann::json::parse(expected)));
+    EXPECT_TRUE(serde_json::equals(-7, std::string("-7")));
+    EXPECT_FALSE(serde_json::equals(READING, std::string("{ not json")));
+}
+
+/// Any change to the value is a difference.
+TEST(KingwSerde, JsonComparatorDifferent) {
+    const nlohmann::json expected = nlohmann::json::parse(serde_json::to_string(READING));
+
+    Reading changed = READING;
+    changed.samples[2] = 4;
+    EXPECT_FALSE(serde_json::equals(changed, expected));
+    changed = READING;
+    changed.counts["max"] = 3;
+    EXPECT_FALSE(serde_json::equals(changed, expected));
+    changed = READING;
+    changed.counts["mid"] = 0;
+    EXPECT_FALSE(serde_json::equals(changed, expected));
+    changed = READING;
+    changed.samples.pop_back();
+    EXPECT_FALSE(serde_json::equals(changed, expected));
+    changed = READING;
+    changed.name = "probes";
+    EXPECT_FALSE(serde_json::equals(changed, expected));
+}
+
+/// Nothing is serialized after the first difference.
+TEST(KingwSerde, JsonComparatorStopsEarly) {
+    const std::vector<Counted> expected{ { 1 }, { 2 }, { 3 } };
+    const nlohmann::json json = nlohmann::json::parse(serde_json::to_string(expected));
+
+    counted_serializations = 0;
+    EXPECT_TRUE(serde_json::equals(expected, json));
+    EXPECT_EQ(counted_serializations, 3);
+
+    counted_serializations = 0;
+    EXPECT_FALSE(serde_json::equals(std::vector<Counted>{ { 0 }, { 2 }, { 3 } }, json));
+    EXPECT_EQ(counted_serializations, 1);
+}
+
+/// Truncated json does not parse, so it never equals anything.
+TEST(KingwSerde, JsonComparatorTruncated) {
+    const std::string expected = serde_json::to_string(READING);
+    for (std::size_t len = 0; len < expected.size(); ++len) {
+        EXPECT_FALSE(serde_json::equals(READING, expected.substr(0, len))) << "length " << len;
+    }
+}
+
+/// Object keys match in any order, since JsonSerializer sorts them.
+TEST(KingwSerde, JsonComparatorKeyOrder) {
+    EXPECT_TRUE(serde_json::equals(READING, std::string(
+        R"({ "valid": true, "raw": [7], "counts": { "min": -1, "max": 2 },)"
+        R"(  "samples": [1.0, -2.0, 3.0], "name": "probe" })")));
+    EXPECT_FALSE(serde_json::equals(READING, std::string(
+        R"({ "valid": true, "raw": [7], "counts": { "min": -1, "max": 2 },)"
+        R"(  "samples": [1.0, 3.0, -2.0], "name": "probe" })")));
+}
+
+/// Like JsonSerializer, empty containers and non-finite floats are null.
+TEST(KingwSerde, JsonComparatorNull) {
+    const Reading empty{ "", {}, {}, {}, false };
+    EXPECT_EQ(serde_json::to_string(empty), R"({"counts":null,"name":"","raw":null,"samples":null,"valid":false})");
+    EXPECT_TRUE(serde_json::equals(empty, serde_json::to_string(empty)));
+    EXPECT_FALSE(serde_json::equals(empty, std::string(
+        R"({"counts":{},"name":"","raw":[],"samples":[],"valid":false})")));
+    EXPECT_FALSE(serde_json::equals(READING, serde_json::to_string(empty)));
+
+    EXPECT_TRUE(serde_json::equals(std::vector<std::int32_t>{}, std::string("null")));
+    EXPECT_TRUE(serde_json::equals(std::numeric_limits<double>::infinity(), std::string("null")));
+}
+
+}  // namespace
@@ -0,0 +1,92 @@
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/fixtures.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/serde_sprintf.hpp"
+#include "kingw/sprintf_comparator.hpp"
+
+using namespace kingw;
+using namespace kingw::fixtures;
+using namespace testing;
+
+
+namespace {
+
+template <class T>
+std::string to_string(const T & input) {
+    char buffer[512] = {};
+    const char* end = serde_sprintf::to_buffer(input, buffer);
+    return std::string(static_cast<const char*>(buffer), end);
+}
+
+template <class T>
+bool equals(const T & input, const std::string & expected) {
+    return serde_sprintf::equals(input, expected.data(), expected.data() + expected.size());
+}
+
+const Reading READING{ "probe", { 1, -2, 3 }, { { "max", 2 }, { "min", -1 } }, { 7 }, true };
+
+/// A value equals the buffer it was serialized into.
+TEST(KingwSerde, SPrintfComparatorEqual) {
+    EXPECT_TRUE(equals(READING, to_string(READING)));
+    EXPECT_TRUE(equals(std::vector<std::int32_t>{}, to_string(std::vector<std::int32_t>{})));
+    EXPECT_TRUE(equals(-7, to_string(-7)));
+}
+
+/// Any change to the value is a difference.
+TEST(KingwSerde, SPrintfComparatorDifferent) {
+    const std::string expected = to_string(READING);
+
+    Reading changed = READING;
+    changed.samples[2] = 4;
+    EXPECT_FALSE(equals(changed, expected));
+    changed = READING;
+    changed.counts["max"] = 3;
+    EXPECT_FALSE(equals(changed, expected));
+    changed = READING;
+    changed.samples.push_back(0);
+    EXPECT_FALSE(equals(changed, expected));
+    changed = READING;
+    changed.valid = false;
+    EXPECT_FALSE(equals(changed, expected));
+}
+
+/// Nothing is serialized after the first difference.
+TEST(KingwSerde, SPrintfComparatorStopsEarly) {
+    const std::vector<Counted> expected{ { 1 }, { 2 }, { 3 } };
+    const std::string buffer = to_string(expected);
+
+    counted_serializations = 0;
+    EXPECT_TRUE(equals(expected, buffer));
+    EXPECT_EQ(counted_serializations, 3);
+
+    counted_serializations = 0;
+    EXPECT_FALSE(equals(std::vector<Counted>{ { 0 }, { 2 }, { 3 } }, buffer));
+    EXPECT_EQ(counted_serializations, 1);
+}
+
+/// A buffer that ends early, or goes on after the value, is a difference.
+TEST(KingwSerde, SPrintfComparatorTruncated) {
+    const std::string expected = to_string(READING);
+
+    for (std::size_t len = 0; len < expected.size(); ++len) {
+        EXPECT_FALSE(equals(READING, expected.substr(0, len))) << "length " << len;
+    }
+    EXPECT_FALSE(equals(READING, expected + std::string("\0" "1", 2)));
+}
+
+/// Back-patched unknown lengths are checked against the actual count.
+TEST(KingwSerde, SPrintfComparatorUnknownLength) {
+    const std::string expected = to_string(Generated{ 3 });
+    EXPECT_THAT(expected, StartsWith("00000000000000000003"));
+
+    EXPECT_TRUE(equals(Generated{ 3 }, expected));
+    EXPECT_FALSE(equals(Generated{ 2 }, expected));
+    EXPECT_FALSE(equals(Generated{ 4 }, expected));
+    EXPECT_TRUE(equals(Generated{ 0 }, to_string(Generated{ 0 })));
+}
+
+}  // namespace
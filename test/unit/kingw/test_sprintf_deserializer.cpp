@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "kingw/de/templates/stdvector.hpp"
+#include "kingw/de/chunked_input.hpp"
+#include "kingw/de/deserialize_projected.hpp"
+#include "kingw/ser/templates/stdvector.hpp"
+#include "kingw/serde/bytes.hpp"
+#include "kingw/serde/derive.hpp"
+#include "kingw/serde/transcode.hpp"
+#include "kingw/serde/value.hpp"
+#include "kingw/serde_json.hpp"
+#include "kingw/serde_sprintf.hpp"
+
+using namespace kingw;
+using namespace testing;
+
+
+// Named, so that DERIVE_SERDE() functions that go unused here don't warn.
+namespace sprintf_test {
+
+/// Written by a newer producer, with fields that Consumer does not know.
+struct Producer {
+    std::vector<std::string> extra;
+    std::string note;
+    int x;
+};
+
+struct Consumer {
+    int x;
+};
+
+struct Event {
+    int id;
+    std::string name;
+};
+
+}  // namespace sprintf_test
+
+using namespace sprintf_test;
+
+DERIVE_SERDE(Producer,
+    ("extra", &Self::extra)
+    ("note", &Self::note)
+    ("x", &Self::x));
+
+DERIVE_SERDE(Consumer,
+    ("x", &Self::x));
+
+DERIVE_SERDE(Event,
+    ("id", &Self::id)
+    ("name", &Self::name));
+
+
+namespace {
+
+template <class T>
+std::string to_string(const T & input) {
+    char buffer[256] = {};
+    const char* end = serde_sprintf::to_buffer(input, buffer);
+    return std::string(static_cast<const char*>(buffer), end);
+}
+
+/// A string literal with embedded '\0' delimiters, without the final '\0'.
+template <std::size_t N>
+std::string elements(const char (&input)[N]) {
+    return std::string(input, N - 1);
+}
+
+/// Bytes that exactly fill the rest of the buffer are still serialized,
+/// like a string would be.
+TEST(KingwSerde, SPrintfBytesFillBuffer) {
+    const serde::ByteBuf input{ { 1, 0, 2, 3 } };
+    char buffer[6] = {};
+    const char* end = serde_sprintf::to_buffer(input, buffer);
+    ASSERT_EQ(end, buffer + sizeof(buffer));
+
+    serde::ByteBuf output;
+    serde_sprintf::from_string(output, serde::string_view(buffer, sizeof(buffer)));
+    EXPECT_EQ(output, input);
+}
+
+/// An unknown struct field whose value is a single element is skipped.
+TEST(KingwSerde, SPrintfSkipUnknownBasicField) {
+    const std::string input = elements("2\0note\0hello\0x\0" "5");
+
+    Consumer output{ 0 };
+    EXPECT_FALSE(serde_sprintf::try_from_string(output, input));
+    EXPECT_EQ(output.x, 5);
+}
+
+/// Except an unsigned integer: it looks just like the count of a sequence,
+/// map or struct, so it can't be skipped. This is a limitation of the
+/// format, which has no type tags. Adding an unsigned field to a producer
+/// breaks older consumers.
+TEST(KingwSerde, SPrintfSkipUnknownUnsignedField) {
+    const std::string input = elements("2\0count\0" "3\0x\0" "5");
+
+    Consumer output{ 0 };
+    const de::Error error = serde_sprintf::try_from_string(output, input);
+    EXPECT_EQ(error.code, de::ErrorCode::InvalidType);
+}
+
+/// An unknown struct field that holds a sequence can't be skipped, since
+/// its count looks like an integer. It is an error rather than wrong data.
+TEST(KingwSerde, SPrintfSkipUnknownSeqField) {
+    const std::string input = to_string(Producer{ { "x", "7" }, "n", 5 });
+
+    Consumer output{ 0 };
+    const de::Error error = serde_sprintf::try_from_string(output, input);
+    EXPECT_EQ(error.code, de::ErrorCode::InvalidType);
+    EXPECT_NE(output.x, 7);
+}
+
+/// An unknown struct field that holds a struct can't be skipped either.
+TEST(KingwSerde, SPrintfSkipUnknownStructField) {
+    const std::string input = elements("2\0inner\0" "1\0x\0" "7\0x\0" "5");
+
+    Consumer output{ 0 };
+    const de::Error error = serde_sprintf::try_from_string(output, input);
+    EXPECT_EQ(error.code, de::ErrorCode::InvalidType);
+}
+
+/// The input is not self-describing, so a struct with a vector can't be
+/// read into a Document or transcoded from it: its count looks like an
+/// unsigned integer. It is an error rather than wrong data.
+TEST(KingwSerde, SPrintfAnyRejectsContainers) {
+    const std::string input = to_string(Producer{ { "x", "7" }, "n", 5 });
+
+    serde::Document document;
+    EXPECT_EQ(serde_sprintf::try_from_string(document, input).code, de::ErrorCode::InvalidType);
+
+    serde_sprintf::SPrintfDeserializer deserializer(input);
+    deserializer.set_throw_on_error(false);
+    serde_json::JsonSerializer serializer;
+    serde::transcode(deserializer, serializer);
+    EXPECT_EQ(deserializer.error().code, de::ErrorCode::InvalidType);
+
+    // Values that can't be a count are still read.
+    serde::Document number;
+    EXPECT_FALSE(serde_sprintf::try_from_string(number, "-5"));
+    EXPECT_EQ(number.root().as_i64(), -5);
+    serde::Document text;
+    EXPECT_FALSE(serde_sprintf::try_from_string(text, "x7"));
+    EXPECT_EQ(text.root().as_string(), "x7");
+}
+
+/// Going the other way, a struct with a vector round-trips into SPrintf
+/// through a Document or transcode(), and reads back as the struct.
+TEST(KingwSerde, SPrintfAnyRoundTripsFromJson) {
+    const std::string json = R"({"extra":["x","7"],"note":"n","x":5})";
+
+    serde::Document document;
+    serde_json::from_string(document, json);
+    Producer from_document{};
+    serde_sprintf::from_string(from_document, to_string(document));
+    EXPECT_THAT(from_document.extra, ElementsAre("x", "7"));
+    EXPECT_EQ(from_document.note, "n");
+    EXPECT_EQ(from_document.x, 5);
+
+    char buffer[256] = {};
+    serde_json::JsonDeserializer deserializer(json);
+    serde_sprintf::SPrintfSerializer serializer(std::begin(buffer), std::end(buffer));
+    serde::transcode(deserializer, serializer);
+    Producer transcoded{};
+    serde_sprintf::from_string(transcoded,
+        serde::string_view(buffer, serializer.last_end() - buffer));
+    EXPECT_THAT(transcoded.extra, ElementsAre("x", "7"));
+    EXPECT_EQ(transcoded.note, "n");
+    EXPECT_EQ(transcoded.x, 5);
+}
+
+/// A basic value that fails to parse, without throwing, leaves
+/// the output as it was.
+TEST(KingwSerde, SPrintfFailureKeepsOutput) {
+    std::int32_t number = 42;
+    EXPECT_EQ(serde_sprintf::try_from_string(number, "abc").code, de::ErrorCode::InvalidType);
+    EXPECT_EQ(number, 42);
+    EXPECT_EQ(serde_sprintf::try_from_string(number, "70000000000").code, de::ErrorCode::InvalidValue);
+    EXPECT_EQ(number, 42);
+
+    bool flag = true;
+    EXPECT_EQ(serde_sprintf::try_from_string(flag, "2").code, de::ErrorCode::InvalidType);
+    EXPECT_TRUE(flag);
+
+    double value = 1.5;
+    EXPECT_EQ(serde_sprintf::try_from_string(value, "").code, de::ErrorCode::EndOfInput);
+    EXPECT_EQ(value, 1.5);
+}
+
+/// Trusted input is parsed in place, but never past the end of the input,
+/// even where the last element has no '\0' after it.
+TEST(KingwSerde, SPrintfTrustedStaysInInput) {
+    const std::string storage = elements("2\0" "10\0" "20" "999");
+    const serde::string_view input(storage.data(), 7);
+
+    std::vector<std::int32_t> output;
+    serde_sprintf::SPrintfDeserializer deserializer(input);
+    deserializer.set_trusted(true);
+    de::deserialize(deserializer, output);
+    EXPECT_THAT(output, ElementsAre(10, 20));
+    EXPECT_EQ(deserializer.last_end(), input.end());
+
+    const serde::string_view number(storage.data() + 6, 1);
+    double value = 0;
+    serde_sprintf::SPrintfDeserializer single(number);
+    single.set_trusted(true);
+    de::deserialize(single, value);
+    EXPECT_EQ(value, 0);
+    EXPECT_EQ(single.last_end(), number.end());
+}
+
+/// Struct fields that are not selected are parsed past, even where
+/// a number or a string of digits looks like a container's count.
+TEST(KingwSerde, SPrintfProjectedSkipsBasicFields) {
+    const std::string input = to_string(Event{ 7, "123" });
+
+    Event output{ 0, "" };
+    serde_sprintf::SPrintfDeserializer deserializer(input);
+    de::deserialize_projected(deserializer, output, de::FieldMask("Event").select(2));
+    EXPECT_EQ(output.id, 0);
+    EXPECT_EQ(output.name, "123");
+
+    output = Event{ 0, "" };
+    serde_sprintf::SPrintfDeserializer other(input);
+    de::deserialize_projected(other, output, de::FieldMask("Event").select(1));
+    EXPECT_EQ(output.id, 7);
+    EXPECT_EQ(output.name, "");
+}
+
+/// Decodes `input` from chunks of `size` bytes.
+template <class T>
+void from_chunks(T & output, const std::string & input, std::size_t size) {
+    de::ChunkedInput chunks([&output](de::ChunkedInput & chunks) {
+        serde_sprintf::SPrintfDeserializer deserializer(chunks);
+        de::deserialize(deserializer, output);
+    });
+    for (std::size_t i = 0; i < input.size(); i += size) {
+        chunks.feed(serde::string_view(input.data() + i, std::min(size, input.size() - i)));
+    }
+    chunks.finish();
+}
+
+/// Strings from chunked input are not borrowed, since the chunk
+/// they are in is gone once the next one arrives.
+TEST(KingwSerde, SPrintfChunkedStringsNotBorrowed) {
+    const std::vector<std::string> input{ "alpha", "beta", "gamma", "delta" };
+    const std::string serialized = to_string(input);
+
+    std::vector<std::string> strings;
+    from_chunks(strings, serialized, 3);
+    EXPECT_EQ(strings, input);
+
+    std::vector<serde::string_view> views;
+    try {
+        from_chunks(views, serialized, 3);
+        ADD_FAILURE() << "string_view was borrowed from a chunk";
+    } catch (const de::DeserializationException & e) {
+        EXPECT_EQ(e.code(), de::ErrorCode::InvalidType);
+    }
+}
+
+}  // namespace